@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <v8.h>
+#include "BGJSHandleTracker.h"
 
 // v8::Persistent<v8::Object>* __debugPersistentAllocObject(v8::Isolate* isolate, v8::Local<v8::Object> *data, const char* file, int line, const char* func);
 // v8::Persistent<v8::Function>* __debugPersistentAllocFunction(v8::Isolate* isolate, v8::Local<v8::Function> *data, const char* file, int line, const char* func);
@@ -23,30 +24,36 @@
 
     #define BGJS_RESET_PERSISTENT(isolate, pers, data) LOGD("BGJS_PERS_RESET %p file %s line %i func %s", &pers, __FILE__, __LINE__, __func__); \
     pers.Reset(isolate, data); \
+    BGJS_TRACK_PERSISTENT(pers); \
     LOGD("BGJS_PERS_NEW %p file %s line %i func %s", &pers, __FILE__, __LINE__, __func__); 
 
-    #define BGJS_NEW_PERSISTENT_PTR(persistent) LOGD("BGJS_PERS_NEW_PTR %p file %s line %i func %s", persistent, __FILE__, __LINE__, __func__);
-    #define BGJS_NEW_PERSISTENT(persistent) LOGD("BGJS_PERS_NEW %p file %s line %i func %s", &persistent, __FILE__, __LINE__, __func__);
+    #define BGJS_NEW_PERSISTENT_PTR(persistent) LOGD("BGJS_PERS_NEW_PTR %p file %s line %i func %s", persistent, __FILE__, __LINE__, __func__); \
+    BGJS_TRACK_PERSISTENT(*persistent);
+    #define BGJS_NEW_PERSISTENT(persistent) LOGD("BGJS_PERS_NEW %p file %s line %i func %s", &persistent, __FILE__, __LINE__, __func__); \
+    BGJS_TRACK_PERSISTENT(persistent);
 
     #define BGJS_CLEAR_PERSISTENT(pers) if (!pers.IsEmpty()) { \
         LOGD("BGJS_PERS_RESET %p file %s line %i func %s", &pers, __FILE__, __LINE__, __func__); \
+        BGJS_UNTRACK_PERSISTENT(pers); \
         pers.Reset(); \
     }
 
     #define BGJS_CLEAR_PERSISTENT_PTR(pers) if (!pers->IsEmpty()) { \
         LOGD("BGJS_PERS_RESET %p file %s line %i func %s", pers, __FILE__, __LINE__, __func__); \
+        BGJS_UNTRACK_PERSISTENT(*pers); \
         pers->Reset(); \
     }
 
 #else
-    #define BGJS_RESET_PERSISTENT(isolate, pers, data) pers.Reset(isolate, data);
+    // persistents are registered with BGJSHandleTracker; this is a no-op unless tracking was enabled at runtime
+    #define BGJS_RESET_PERSISTENT(isolate, pers, data) do { pers.Reset(isolate, data); BGJS_TRACK_PERSISTENT(pers); } while(0)
 
-    #define BGJS_NEW_PERSISTENT_PTR(persistent) 
-    #define BGJS_NEW_PERSISTENT(persistent) 
+    #define BGJS_NEW_PERSISTENT_PTR(persistent) BGJS_TRACK_PERSISTENT(*persistent)
+    #define BGJS_NEW_PERSISTENT(persistent) BGJS_TRACK_PERSISTENT(persistent)
 
-    #define BGJS_CLEAR_PERSISTENT(pers) pers.Reset();
+    #define BGJS_CLEAR_PERSISTENT(pers) do { BGJS_UNTRACK_PERSISTENT(pers); pers.Reset(); } while(0)
 
-    #define BGJS_CLEAR_PERSISTENT_PTR(pers) if (pers && !pers->IsEmpty()) { pers->Reset(); }
+    #define BGJS_CLEAR_PERSISTENT_PTR(pers) do { if (pers && !pers->IsEmpty()) { BGJS_UNTRACK_PERSISTENT(*pers); pers->Reset(); } } while(0)
 #endif
 
 
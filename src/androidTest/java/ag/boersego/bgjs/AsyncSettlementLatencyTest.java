@@ -0,0 +1,168 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.Arrays;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Measures V8Engine.post and Resolver.resolveAsync from several threads while js keeps the event loop busy
+ *
+ * Both must return without waiting for the running js; the work is done once the loop gets to it.
+ * The time spent in the call and the time until the work ran on the loop are logged as percentiles and a histogram.
+ */
+@RunWith(AndroidJUnit4.class)
+public class AsyncSettlementLatencyTest extends V8EngineTestCase {
+    private static final String TAG = "AsyncSettlementLatency";
+    private static final int THREADS = 4;
+    private static final int POSTS_PER_THREAD = 250;
+    private static final int BUSY_MS = 500;
+    // generous upper bound for a call that does not wait for the locker; far below BUSY_MS
+    private static final long MAX_CALL_NS = TimeUnit.MILLISECONDS.toNanos(50);
+
+    @Test
+    public void postFromManyThreads() throws Exception {
+        final int count = THREADS * POSTS_PER_THREAD;
+        final long[] callNs = new long[count];
+        final long[] deliveryNs = new long[count];
+        final int[] lastSequence = new int[THREADS];
+        final AtomicInteger outOfOrder = new AtomicInteger();
+        final CountDownLatch done = new CountDownLatch(count);
+
+        keepLoopBusy();
+
+        runOnThreads((thread, i) -> {
+            final int slot = thread * POSTS_PER_THREAD + i;
+            final long start = System.nanoTime();
+            engine.post(() -> {
+                deliveryNs[slot] = System.nanoTime() - start;
+                // runnables of the same thread have to run in the order they were posted
+                if (lastSequence[thread] != i) {
+                    outOfOrder.incrementAndGet();
+                }
+                lastSequence[thread] = i + 1;
+                done.countDown();
+            });
+            callNs[slot] = System.nanoTime() - start;
+        });
+
+        assertTrue("not all runnables ran", done.await(30, TimeUnit.SECONDS));
+        assertEquals(0, outOfOrder.get());
+        report("post call", callNs);
+        report("post delivery", deliveryNs);
+        assertTrue("post waited for running js", max(callNs) < MAX_CALL_NS);
+    }
+
+    @Test
+    public void resolveAsyncFromManyThreads() throws Exception {
+        final int count = THREADS * POSTS_PER_THREAD;
+        final long[] callNs = new long[count];
+        final long[] startNs = new long[count];
+        final long[] deliveryNs = new long[count];
+        final CountDownLatch done = new CountDownLatch(count);
+
+        // resolvers are created up front; creating them needs the locker
+        final JNIV8Promise.Resolver[] resolvers = new JNIV8Promise.Resolver[count];
+        for (int slot = 0; slot < count; slot++) {
+            final int index = slot;
+            resolvers[slot] = JNIV8Promise.CreateResolver(engine);
+            resolvers[slot].getPromise().then((Object receiver, Object[] arguments) -> {
+                deliveryNs[index] = System.nanoTime() - startNs[index];
+                done.countDown();
+                return JNIV8Undefined.GetInstance();
+            });
+        }
+
+        keepLoopBusy();
+
+        runOnThreads((thread, i) -> {
+            final int slot = thread * POSTS_PER_THREAD + i;
+            startNs[slot] = System.nanoTime();
+            resolvers[slot].resolveAsync(slot);
+            callNs[slot] = System.nanoTime() - startNs[slot];
+        });
+
+        assertTrue("not all promises were settled", done.await(30, TimeUnit.SECONDS));
+        report("resolveAsync call", callNs);
+        report("resolveAsync delivery", deliveryNs);
+        assertTrue("resolveAsync waited for running js", max(callNs) < MAX_CALL_NS);
+    }
+
+    private interface Poster {
+        void post(int thread, int index);
+    }
+
+    /**
+     * blocks the event loop with js for BUSY_MS, starting right away
+     */
+    private static void keepLoopBusy() throws InterruptedException {
+        engine.runScript("setTimeout(function() { var end = Date.now() + " + BUSY_MS + "; while (Date.now() < end) {} }, 0);", "busy");
+        // give the loop time to pick up the timer
+        Thread.sleep(50);
+    }
+
+    private static void runOnThreads(final Poster poster) throws Exception {
+        final ExecutorService pool = Executors.newFixedThreadPool(THREADS);
+        final CountDownLatch start = new CountDownLatch(1);
+        for (int t = 0; t < THREADS; t++) {
+            final int thread = t;
+            pool.submit(() -> {
+                start.await();
+                for (int i = 0; i < POSTS_PER_THREAD; i++) {
+                    poster.post(thread, i);
+                }
+                return null;
+            });
+        }
+        start.countDown();
+        pool.shutdown();
+        assertTrue(pool.awaitTermination(30, TimeUnit.SECONDS));
+    }
+
+    private static long max(long[] values) {
+        long result = 0;
+        for (long value : values) {
+            result = Math.max(result, value);
+        }
+        return result;
+    }
+
+    /**
+     * logs percentiles and a histogram with power of two buckets in microseconds
+     */
+    private static void report(String name, long[] valuesNs) {
+        final long[] sorted = valuesNs.clone();
+        Arrays.sort(sorted);
+        Log.i(TAG, String.format("%s: p50 %d us, p90 %d us, p99 %d us, max %d us", name,
+                percentileUs(sorted, 0.5), percentileUs(sorted, 0.9), percentileUs(sorted, 0.99), sorted[sorted.length - 1] / 1000));
+
+        final int[] buckets = new int[32];
+        for (long value : sorted) {
+            final long us = Math.max(1, value / 1000);
+            buckets[63 - Long.numberOfLeadingZeros(us)]++;
+        }
+        final StringBuilder histogram = new StringBuilder(name).append(" histogram:");
+        for (int i = 0; i < buckets.length; i++) {
+            if (buckets[i] > 0) {
+                histogram.append(String.format(" [%d us, %d us): %d", 1L << i, 1L << (i + 1), buckets[i]));
+            }
+        }
+        Log.i(TAG, histogram.toString());
+    }
+
+    private static long percentileUs(long[] sorted, double percentile) {
+        return sorted[Math.min(sorted.length - 1, (int) (sorted.length * percentile))] / 1000;
+    }
+}
@@ -0,0 +1,81 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Posts simulated frame work while js keeps the loop saturated with background parsing
+ *
+ * Every FRAME_MS a frame task is posted from java; it misses its deadline if it does not run within FRAME_MS.
+ * The frames are posted once as user-blocking tasks and once with background priority, where they queue up behind
+ * the parsing like they would without priorities. The number of missed frames of both runs is logged.
+ */
+@RunWith(AndroidJUnit4.class)
+public class FrameDeadlineTest extends V8EngineTestCase {
+    private static final String TAG = "FrameDeadlineTest";
+    private static final int FRAMES = 60;
+    private static final long FRAME_MS = 16;
+    // number of parsing tasks that are queued at any time; each one posts its successor when it is done
+    private static final int PARSE_TASKS = 50;
+
+    @Test
+    public void userBlockingFramesMeetDeadlines() throws Exception {
+        final int blockingMisses = runFrames(V8Engine.TASK_PRIORITY_USER_BLOCKING);
+        final int backgroundMisses = runFrames(V8Engine.TASK_PRIORITY_BACKGROUND);
+        Log.i(TAG, String.format("missed frames while parsing: user-blocking %d/%d, background %d/%d",
+                blockingMisses, FRAMES, backgroundMisses, FRAMES));
+        assertTrue("prioritized frames missed as many deadlines as unprioritized ones", blockingMisses < backgroundMisses);
+    }
+
+    private static int runFrames(int priority) throws InterruptedException {
+        startParsing();
+
+        final AtomicInteger misses = new AtomicInteger();
+        final CountDownLatch done = new CountDownLatch(FRAMES);
+        final long deadlineNs = TimeUnit.MILLISECONDS.toNanos(FRAME_MS);
+        for (int frame = 0; frame < FRAMES; frame++) {
+            final long posted = System.nanoTime();
+            engine.enqueueTask(() -> {
+                if (System.nanoTime() - posted > deadlineNs) {
+                    misses.incrementAndGet();
+                }
+                done.countDown();
+            }, priority);
+            Thread.sleep(FRAME_MS);
+        }
+
+        final boolean finished = done.await(30, TimeUnit.SECONDS);
+        stopParsing();
+        assertTrue("not all frames ran", finished);
+        return misses.get();
+    }
+
+    /**
+     * keeps PARSE_TASKS background tasks queued that parse a json document of about a hundred kilobytes each
+     */
+    private static void startParsing() throws InterruptedException {
+        engine.runScript("(function() {" +
+                "var rows = []; for (var i = 0; i < 2000; i++) rows.push({id: i, name: 'row ' + i, values: [i, i * 2, i * 3]});" +
+                "var json = JSON.stringify(rows);" +
+                "frameTestParsing = true;" +
+                "function parse() { JSON.parse(json); if (frameTestParsing) postTask(parse, 'background'); }" +
+                "for (var i = 0; i < " + PARSE_TASKS + "; i++) postTask(parse, 'background');" +
+                "})();", "frameDeadline");
+        // let the loop pick up the parsing before the first frame
+        Thread.sleep(50);
+    }
+
+    private static void stopParsing() {
+        engine.runScript("frameTestParsing = false;", "frameDeadline");
+    }
+}
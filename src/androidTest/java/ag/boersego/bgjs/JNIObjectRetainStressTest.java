@@ -0,0 +1,73 @@
+package ag.boersego.bgjs;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.lang.ref.WeakReference;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.atomic.AtomicBoolean;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Stresses the retain/release state machine of JNIObject
+ *
+ * Every time a js reference to a persistent object is created the java peer is retained;
+ * it is released again when js garbage collects the reference. Several threads do this concurrently
+ * while another thread keeps collecting garbage in js and java, so that releases from weak callbacks
+ * and disposals on the finalizer thread interleave with new retains.
+ * If a retain or release got lost, peers would either stay alive forever or crash when used after being freed.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIObjectRetainStressTest extends V8EngineTestCase {
+    private static final int THREADS = 8;
+    private static final int ITERATIONS = 500;
+
+    @Test
+    public void retainAndReleaseFromManyThreads() throws Exception {
+        final JNIV8GenericObject holder = JNIV8GenericObject.Create(engine);
+        final List<WeakReference<V8TestObject>> references = Collections.synchronizedList(new ArrayList<>());
+        final AtomicBoolean running = new AtomicBoolean(true);
+
+        ExecutorService pool = Executors.newFixedThreadPool(THREADS + 1);
+        Future<?> collector = pool.submit(() -> {
+            while (running.get()) {
+                collectGarbage();
+            }
+        });
+
+        List<Future<?>> workers = new ArrayList<>();
+        for (int t = 0; t < THREADS; t++) {
+            final String key = "object" + t;
+            workers.add(pool.submit(() -> {
+                for (int i = 0; i < ITERATIONS; i++) {
+                    V8TestObject object = new V8TestObject(engine);
+                    references.add(new WeakReference<>(object));
+                    // referencing the object from js retains it; replacing it makes the previous one collectable
+                    holder.setV8Field(key, object);
+                    // the object must still be usable while it is retained by js
+                    assertEquals(object, holder.getV8Field(key));
+                }
+            }));
+        }
+        for (Future<?> worker : workers) {
+            worker.get();
+        }
+        running.set(false);
+        collector.get();
+        pool.shutdown();
+
+        for (int t = 0; t < THREADS; t++) {
+            holder.setV8Field("object" + t, null);
+        }
+
+        assertEquals("peers were not released", 0, collectUntilCleared(references, 20000));
+    }
+}
@@ -0,0 +1,75 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.nio.ByteBuffer;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Compares passing 16 MB between java and js by sharing memory with copying it
+ *
+ * java -> js: CreateWithByteBuffer uses the direct buffer as backing store; the copy variant allocates an ArrayBuffer
+ * and puts a byte[] into it. js -> java: getV8ByteBuffer shares the memory; the copy variant reads it into a byte[].
+ * Results are logged in MB/s.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8ArrayBufferBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8ArrayBufferBenchmark";
+    private static final int SIZE = 16 * 1024 * 1024;
+    private static final int RUNS = 10;
+
+    @Test
+    public void javaToJs() {
+        final ByteBuffer direct = ByteBuffer.allocateDirect(SIZE);
+        final byte[] heap = new byte[SIZE];
+        for (int i = 0; i < SIZE; i++) {
+            heap[i] = (byte) i;
+        }
+        direct.put(heap);
+
+        long start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            assertEquals(SIZE, JNIV8ArrayBuffer.CreateWithByteBuffer(engine, direct).getV8ByteLength());
+        }
+        report("java -> js shared", System.nanoTime() - start);
+
+        start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            final JNIV8ArrayBuffer buffer = JNIV8ArrayBuffer.CreateWithLength(engine, SIZE);
+            buffer.getV8ByteBuffer().put(heap);
+            assertEquals(SIZE, buffer.getV8ByteLength());
+        }
+        report("java -> js copied", System.nanoTime() - start);
+    }
+
+    @Test
+    public void jsToJava() {
+        final JNIV8ArrayBuffer buffer = (JNIV8ArrayBuffer) engine.runScript(
+                "(function() { var a = new Uint8Array(" + SIZE + "); for (var i = 0; i < a.length; i++) a[i] = i; return a.buffer; })()", "buffer");
+        final byte[] heap = new byte[SIZE];
+
+        long start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            assertEquals(SIZE, buffer.getV8ByteBuffer().capacity());
+        }
+        report("js -> java shared", System.nanoTime() - start);
+
+        start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            buffer.getV8ByteBuffer().get(heap);
+        }
+        report("js -> java copied", System.nanoTime() - start);
+        assertEquals((byte) 255, heap[255]);
+    }
+
+    private static void report(String name, long elapsedNs) {
+        final double seconds = elapsedNs / 1e9;
+        Log.i(TAG, String.format("%s: %.0f MB/s (%.2f ms per 16 MB)", name, RUNS * (SIZE / (1024.0 * 1024.0)) / seconds, elapsedNs / 1e6 / RUNS));
+    }
+}
@@ -0,0 +1,48 @@
+package ag.boersego.bgjs;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.lang.ref.WeakReference;
+import java.nio.ByteBuffer;
+import java.util.Collections;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotNull;
+
+/**
+ * Checks that a ByteBuffer returned by getV8ByteBuffer keeps the js memory alive after its wrapper became unreachable,
+ * and that the wrapper is released again once the ByteBuffer has been collected
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8ArrayBufferLifetimeTest extends V8EngineTestCase {
+    private static final int SIZE = 1024 * 1024;
+
+    @Test
+    public void byteBufferKeepsArrayBufferAlive() throws InterruptedException {
+        final WeakReference<?>[] wrapper = new WeakReference<?>[1];
+        ByteBuffer bytes = createSharedBuffer(wrapper);
+
+        // the wrapper is only referenced through the ByteBuffer now
+        for (int i = 0; i < 5; i++) {
+            collectGarbage();
+            engine.runScript("new ArrayBuffer(" + SIZE + ")", "churn");
+        }
+        assertNotNull(wrapper[0].get());
+        for (int i = 0; i < SIZE; i += 4096) {
+            assertEquals((byte) (i / 4096), bytes.get(i));
+        }
+
+        bytes = null;
+        assertEquals(0, collectUntilCleared(Collections.singletonList(wrapper[0]), 20000));
+    }
+
+    private static ByteBuffer createSharedBuffer(WeakReference<?>[] wrapper) {
+        final JNIV8ArrayBuffer buffer = (JNIV8ArrayBuffer) engine.runScript(
+                "(function() { var a = new Uint8Array(" + SIZE + "); for (var i = 0; i < a.length; i += 4096) a[i] = i / 4096; return a.buffer; })()", "buffer");
+        wrapper[0] = new WeakReference<>(buffer);
+        return buffer.getV8ByteBuffer();
+    }
+}
@@ -0,0 +1,61 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.BeforeClass;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Measures bound accessors and methods with primitive signatures, which skip the local reference frame and store
+ * their result in the return value directly, against the same bindings with object signatures
+ *
+ * Each binding is called in a js loop; results are logged as ns per call.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8BindingBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8BindingBenchmark";
+    private static final int CALLS = 100000;
+
+    @BeforeClass
+    public static void createObject() {
+        final V8AccessorTestObject object = new V8AccessorTestObject(engine);
+        object.setValue(2);
+        object.setName("name");
+        engine.getGlobalObject().setV8Field("bindingTestObject", object);
+    }
+
+    @Test
+    public void bindingsWork() {
+        assertEquals(2.0, ((Number) engine.runScript("bindingTestObject.value", "binding")).doubleValue(), 0);
+        assertEquals(6.0, ((Number) engine.runScript("bindingTestObject.scale(3)", "binding")).doubleValue(), 0);
+        assertEquals("a name", engine.runScript("bindingTestObject.prefix('a ')", "binding"));
+    }
+
+    @Test
+    public void accessors() {
+        measure("get double", "bindingTestObject.value");
+        measure("get String", "bindingTestObject.name");
+        measure("set double", "bindingTestObject.value = 2");
+        measure("set String", "bindingTestObject.name = 'name'");
+    }
+
+    @Test
+    public void methods() {
+        measure("scale(double): double", "bindingTestObject.scale(1)");
+        measure("prefix(String): String", "bindingTestObject.prefix('')");
+    }
+
+    private static void measure(String name, String expression) {
+        final String loop = "(function() { var result; for (var i = 0; i < " + CALLS + "; i++) result = " + expression + "; return result; })();";
+        engine.runScript(loop, "binding");
+        final long start = System.nanoTime();
+        engine.runScript(loop, "binding");
+        final long elapsed = System.nanoTime() - start;
+        Log.i(TAG, String.format("%s: %.0f ns/call", name, (double) elapsed / CALLS));
+    }
+}
@@ -0,0 +1,75 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.HashMap;
+import java.util.Map;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Compares the Map based field accessors with the parallel array variants on an object with 1k properties
+ *
+ * Each variant writes all properties and reads them back; the values read are checked, and the results are
+ * logged as ns per property for set and get separately.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8BulkFieldsBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8BulkFieldsBenchmark";
+    private static final int PROPERTIES = 1000;
+    private static final int WARMUP = 20;
+    private static final int RUNS = 200;
+
+    @Test
+    public void setAndGetFields() {
+        final String[] keys = new String[PROPERTIES];
+        final Object[] values = new Object[PROPERTIES];
+        final double[] numbers = new double[PROPERTIES];
+        final Map<String, Object> map = new HashMap<>();
+        for (int i = 0; i < PROPERTIES; i++) {
+            keys[i] = "field" + i;
+            numbers[i] = i * 1.5;
+            values[i] = numbers[i];
+            map.put(keys[i], values[i]);
+        }
+        final JNIV8GenericObject object = JNIV8GenericObject.Create(engine);
+        final double[] target = new double[PROPERTIES];
+
+        measure("Map", () -> object.setV8Fields(map), () -> {
+            Map<String, Object> result = object.getV8Fields();
+            assertEquals(numbers[PROPERTIES - 1], (Double) result.get(keys[PROPERTIES - 1]), 0);
+        });
+        measure("String[] + Object[]", () -> object.setV8Fields(keys, values), () -> {
+            Object[] result = object.getV8Fields(keys);
+            assertEquals(numbers[PROPERTIES - 1], (Double) result[PROPERTIES - 1], 0);
+        });
+        measure("String[] + double[]", () -> object.setV8Fields(keys, numbers), () -> {
+            object.getV8Fields(keys, target);
+            assertEquals(numbers[PROPERTIES - 1], target[PROPERTIES - 1], 0);
+        });
+    }
+
+    private static void measure(String name, Runnable set, Runnable get) {
+        for (int i = 0; i < WARMUP; i++) {
+            set.run();
+            get.run();
+        }
+        long setNs = 0, getNs = 0;
+        for (int i = 0; i < RUNS; i++) {
+            long start = System.nanoTime();
+            set.run();
+            long middle = System.nanoTime();
+            get.run();
+            getNs += System.nanoTime() - middle;
+            setNs += middle - start;
+        }
+        final double properties = (double) RUNS * PROPERTIES;
+        Log.i(TAG, String.format("%s, %d properties: set %.1f ns/property, get %.1f ns/property",
+                name, PROPERTIES, setNs / properties, getNs / properties));
+    }
+}
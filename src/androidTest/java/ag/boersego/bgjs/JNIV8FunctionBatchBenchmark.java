@@ -0,0 +1,63 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Compares calling many js listeners one by one with calling them in a batch
+ *
+ * Every listener adds its argument to a counter and returns it; the results are checked so that no call can be skipped.
+ * Results are logged as ns per call.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8FunctionBatchBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8FunctionBatchBenchmark";
+    private static final int LISTENERS = 1000;
+    private static final int WARMUP = 5;
+    private static final int RUNS = 50;
+
+    @Test
+    public void callListeners() {
+        final JNIV8Array array = (JNIV8Array) engine.runScript("(function() { var listeners = []; batchTestCount = 0;" +
+                "for (var i = 0; i < " + LISTENERS + "; i++) listeners.push(function(value) { batchTestCount += value; return value; });" +
+                "return listeners; })()", "batch");
+        final JNIV8Function[] functions = new JNIV8Function[LISTENERS];
+        final Object[][] arguments = new Object[LISTENERS][];
+        for (int i = 0; i < LISTENERS; i++) {
+            functions[i] = (JNIV8Function) array.getV8Element(i);
+            arguments[i] = new Object[]{i};
+        }
+
+        measure("single calls", () -> {
+            for (int i = 0; i < LISTENERS; i++) {
+                assertEquals(i, ((Number) functions[i].callAsV8Function(arguments[i])).intValue());
+            }
+        });
+        measure("callAsV8Functions", () -> {
+            final Object[] results = JNIV8Function.callAsV8Functions(functions, null, arguments, null);
+            assertEquals(LISTENERS - 1, ((Number) results[LISTENERS - 1]).intValue());
+        });
+        measure("callAsV8FunctionBatch", () -> {
+            final Object[] results = functions[0].callAsV8FunctionBatch(arguments);
+            assertEquals(LISTENERS - 1, ((Number) results[LISTENERS - 1]).intValue());
+        });
+    }
+
+    private static void measure(String name, Runnable calls) {
+        for (int i = 0; i < WARMUP; i++) {
+            calls.run();
+        }
+        final long start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            calls.run();
+        }
+        final long elapsed = System.nanoTime() - start;
+        Log.i(TAG, String.format("%s: %.0f ns/call", name, (double) elapsed / ((long) RUNS * LISTENERS)));
+    }
+}
@@ -0,0 +1,66 @@
+package ag.boersego.bgjs;
+
+import android.os.Debug;
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Checks the typed function handlers and compares the allocations of the handler kinds over a million calls from js
+ *
+ * The calls run on the test thread, because runScript executes js on the calling thread, so the thread allocation counter
+ * covers the boxed arguments and results of the handlers.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8FunctionHandlerBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8FunctionHandlerBenchmark";
+    private static final int CALLS = 1000000;
+
+    @Test
+    public void typedHandlersReturnPrimitives() {
+        final JNIV8GenericObject global = engine.getGlobalObject();
+        global.setV8Field("handlerTestSquare", JNIV8Function.CreateDoubleToDouble(engine, value -> value * value));
+        global.setV8Field("handlerTestAdd", JNIV8Function.CreateDouble2ToDouble(engine, (a, b) -> a + b));
+        global.setV8Field("handlerTestIsPositive", JNIV8Function.CreateDoubleToBoolean(engine, value -> value > 0));
+
+        assertEquals(2.25, ((Number) engine.runScript("handlerTestSquare(1.5)", "handler")).doubleValue(), 0);
+        assertEquals(5.0, ((Number) engine.runScript("handlerTestAdd(2, 3)", "handler")).doubleValue(), 0);
+        assertEquals(true, engine.runScript("handlerTestIsPositive(1)", "handler"));
+        assertEquals(false, engine.runScript("handlerTestIsPositive(-1)", "handler"));
+        assertEquals("number", engine.runScript("typeof handlerTestSquare(2)", "handler"));
+        assertEquals("boolean", engine.runScript("typeof handlerTestIsPositive(2)", "handler"));
+    }
+
+    @Test
+    public void compareAllocations() {
+        measure("Handler", JNIV8Function.Create(engine, (receiver, arguments) -> ((Number) arguments[0]).doubleValue() + 1));
+        measure("DoubleHandler", JNIV8Function.CreateDouble(engine, value -> value + 1));
+        measure("DoubleToDoubleHandler", JNIV8Function.CreateDoubleToDouble(engine, value -> value + 1));
+    }
+
+    private static void measure(String name, JNIV8Function function) {
+        engine.getGlobalObject().setV8Field("handlerTestFunction", function);
+        final String loop = "(function() { var sum = 0; for (var i = 0; i < " + CALLS + "; i++) sum += handlerTestFunction(i); return sum; })()";
+        // warm up, so that lazily initialized state is not counted
+        engine.runScript(loop, "handler");
+
+        Debug.startAllocCounting();
+        Debug.resetThreadAllocCount();
+        Debug.resetThreadAllocSize();
+        final long start = System.nanoTime();
+        final Object sum = engine.runScript(loop, "handler");
+        final long elapsed = System.nanoTime() - start;
+        final int allocations = Debug.getThreadAllocCount();
+        final int bytes = Debug.getThreadAllocSize();
+        Debug.stopAllocCounting();
+
+        assertEquals((double) CALLS * (CALLS + 1) / 2, ((Number) sum).doubleValue(), 0);
+        Log.i(TAG, String.format("%s: %d allocations, %d bytes, %.0f ns/call for %d calls",
+                name, allocations, bytes, (double) elapsed / CALLS, CALLS));
+    }
+}
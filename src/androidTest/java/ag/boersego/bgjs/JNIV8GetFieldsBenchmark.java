@@ -0,0 +1,51 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.Map;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Measures getV8Fields on an object with 10k properties
+ *
+ * Every entry creates local references for the key, the value and the result of HashMap.put; if they were not released
+ * per batch a single call would overflow the local reference table, so completing the runs is part of the check.
+ * Results are logged as us per call and ns per property.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8GetFieldsBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8GetFieldsBenchmark";
+    private static final int PROPERTIES = 10000;
+    private static final int WARMUP = 5;
+    private static final int RUNS = 50;
+
+    @Test
+    public void getFieldsOfLargeObject() {
+        final JNIV8Object object = (JNIV8Object) engine.runScript("(function() {" +
+                "var o = {};" +
+                "for (var i = 0; i < " + PROPERTIES + "; i++) o['field' + i] = i % 3 ? i * 1.5 : 'value ' + i;" +
+                "return o;" +
+                "})()", "getFields");
+
+        for (int i = 0; i < WARMUP; i++) {
+            object.getV8Fields();
+        }
+        long start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            Map<String, Object> fields = object.getV8Fields();
+            assertEquals(PROPERTIES, fields.size());
+        }
+        long elapsed = System.nanoTime() - start;
+        Log.i(TAG, String.format("getV8Fields, %d properties: %.1f us/call, %.1f ns/property",
+                PROPERTIES, elapsed / 1000.0 / RUNS, (double) elapsed / ((long) RUNS * PROPERTIES)));
+
+        assertEquals(1.5, (Double) object.getV8Fields().get("field1"), 0);
+        assertEquals("value 3", object.getV8Fields().get("field3"));
+    }
+}
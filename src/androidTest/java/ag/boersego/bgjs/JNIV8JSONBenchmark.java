@@ -0,0 +1,67 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Compares the ways of getting an order payload from js as UTF-8 JSON
+ *
+ * toJSON() runs JSON.stringify and returns a String that still has to be encoded; toJSONBytes() serializes natively
+ * into a byte[], toJSONBytes(ByteBuffer) into a reused direct buffer. The output of all three is checked to be identical.
+ * Results are logged as us per payload.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8JSONBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8JSONBenchmark";
+    private static final int ORDERS = 200;
+    private static final int WARMUP = 50;
+    private static final int RUNS = 500;
+
+    @Test
+    public void serializeOrders() {
+        final JNIV8Object payload = (JNIV8Object) engine.runScript("(function() {" +
+                "var orders = [];" +
+                "for (var i = 0; i < " + ORDERS + "; i++) {" +
+                "  orders.push({id: 'order-' + i, instrument: 'DE000BASF111', side: i % 2 ? 'buy' : 'sell'," +
+                "    quantity: i * 10, limit: 48.125 + i / 8, validUntil: new Date(1600000000000 + i * 1000)," +
+                "    note: 'Müller & Söhne', tags: ['portfolio', 'limit'], active: true, stop: null});" +
+                "}" +
+                "return {account: 'DE89370400440532013000', orders: orders};" +
+                "})()", "json");
+
+        final byte[] expected = payload.toJSON().getBytes(StandardCharsets.UTF_8);
+        assertArrayEquals(expected, payload.toJSONBytes());
+        final ByteBuffer buffer = ByteBuffer.allocateDirect(expected.length);
+        assertEquals(expected.length, payload.toJSONBytes(buffer));
+
+        measure("toJSON + getBytes", () -> payload.toJSON().getBytes(StandardCharsets.UTF_8).length, expected.length);
+        measure("toJSONBytes()", () -> payload.toJSONBytes().length, expected.length);
+        measure("toJSONBytes(ByteBuffer)", () -> payload.toJSONBytes(buffer), expected.length);
+    }
+
+    private interface Serializer {
+        int serialize();
+    }
+
+    private static void measure(String name, Serializer serializer, int expectedLength) {
+        for (int i = 0; i < WARMUP; i++) {
+            serializer.serialize();
+        }
+        long start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            assertEquals(expectedLength, serializer.serialize());
+        }
+        long elapsed = System.nanoTime() - start;
+        Log.i(TAG, String.format("%s: %.1f us/payload (%d bytes)", name, elapsed / 1000.0 / RUNS, expectedLength));
+    }
+}
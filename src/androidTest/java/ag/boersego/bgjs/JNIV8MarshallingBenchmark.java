@@ -0,0 +1,70 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.math.BigDecimal;
+import java.math.BigInteger;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicLong;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Measures the conversion of java objects to js values
+ *
+ * The first run only contains the types that are matched early by jobject2v8value (String, Double, Integer, Boolean, JNIV8Object),
+ * the second one mixes in other boxed types, characters and primitive arrays, which are matched late or need a class lookup.
+ * Results are logged as ns per element; the element count of the created arrays is checked so that nothing is optimized away.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8MarshallingBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8MarshallingBenchmark";
+    private static final int ELEMENTS = 1000;
+    private static final int WARMUP = 20;
+    private static final int RUNS = 200;
+
+    @Test
+    public void convertCommonTypes() {
+        final V8TestObject object = new V8TestObject(engine);
+        final Object[] candidates = {"string", 1.5, 42, true, object};
+        measure("common types", fill(candidates));
+    }
+
+    @Test
+    public void convertMixedTypes() {
+        final V8TestObject object = new V8TestObject(engine);
+        final Object[] candidates = {
+                "string", 1.5, 42, true, object,
+                7L, 2.5f, (short) 3, (byte) 4, 'c',
+                new AtomicInteger(5), new AtomicLong(6), BigInteger.TEN, BigDecimal.ONE,
+                new int[]{1, 2}, new double[]{1.0, 2.0}, new byte[]{1, 2}
+        };
+        measure("mixed types", fill(candidates));
+    }
+
+    private static Object[] fill(Object[] candidates) {
+        final Object[] elements = new Object[ELEMENTS];
+        for (int i = 0; i < ELEMENTS; i++) {
+            elements[i] = candidates[i % candidates.length];
+        }
+        return elements;
+    }
+
+    private static void measure(String name, Object[] elements) {
+        for (int i = 0; i < WARMUP; i++) {
+            JNIV8Array.CreateWithArray(engine, elements);
+        }
+        long start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            JNIV8Array array = JNIV8Array.CreateWithArray(engine, elements);
+            assertEquals(ELEMENTS, array.getV8Length());
+        }
+        long elapsed = System.nanoTime() - start;
+        Log.i(TAG, String.format("%s: %.1f ns/element", name, (double) elapsed / ((long) RUNS * ELEMENTS)));
+    }
+}
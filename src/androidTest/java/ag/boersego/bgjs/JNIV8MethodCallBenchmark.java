@@ -0,0 +1,60 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.BeforeClass;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Checks how calls of overloaded java methods are resolved and measures calls per second from js
+ *
+ * Overloads with the same number of arguments are chosen by the types of the js values, including the class of wrapped objects.
+ * The benchmark calls a method with primitive arguments and an overloaded method with object arguments in a js loop.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8MethodCallBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8MethodCallBenchmark";
+    private static final int CALLS = 100000;
+
+    @BeforeClass
+    public static void createObjects() {
+        final JNIV8GenericObject global = engine.getGlobalObject();
+        global.setV8Field("callTestObject", new V8OverloadTestObject(engine));
+        global.setV8Field("callTestArgument", new V8TestObject(engine));
+    }
+
+    @Test
+    public void overloadsAreChosenByClass() {
+        assertEquals("string", engine.runScript("callTestObject.describe('x')", "call"));
+        assertEquals("array", engine.runScript("callTestObject.describe([1, 2])", "call"));
+        assertEquals("test object", engine.runScript("callTestObject.describe(callTestArgument)", "call"));
+        // neither an array nor a V8TestObject; only the Object overload fits
+        assertEquals("object", engine.runScript("callTestObject.describe({})", "call"));
+        assertEquals("object", engine.runScript("callTestObject.describe(42)", "call"));
+    }
+
+    @Test
+    public void primitiveCalls() {
+        measure("add(number, number)", "callTestObject.add(i, 1)");
+    }
+
+    @Test
+    public void overloadedObjectCalls() {
+        measure("describe(V8TestObject)", "callTestObject.describe(callTestArgument)");
+    }
+
+    private static void measure(String name, String call) {
+        final String loop = "(function() { for (var i = 0; i < " + CALLS + "; i++) " + call + "; })();";
+        // warm up the js function and the wrapper caches
+        engine.runScript(loop, "call");
+        final long start = System.nanoTime();
+        engine.runScript(loop, "call");
+        final long elapsed = System.nanoTime() - start;
+        Log.i(TAG, String.format("%s: %.0f calls/s, %.0f ns/call", name, CALLS * 1e9 / elapsed, (double) elapsed / CALLS));
+    }
+}
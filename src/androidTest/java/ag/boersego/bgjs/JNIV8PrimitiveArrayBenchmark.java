@@ -0,0 +1,74 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Round trips a price series of 100k elements from java to js and back
+ *
+ * The boxed variant goes through CreateWithArray and getV8Elements, the primitive ones through
+ * CreateWithDoubleArray/getV8ElementsAsDoubleArray and CreateWithIntArray/getV8ElementsAsIntArray.
+ * The data that comes back is compared with the input; results are logged as ms per round trip.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8PrimitiveArrayBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8PrimitiveArrayBenchmark";
+    private static final int ELEMENTS = 100000;
+    private static final int WARMUP = 5;
+    private static final int RUNS = 20;
+
+    @Test
+    public void roundTripDoubles() {
+        final double[] prices = new double[ELEMENTS];
+        final Object[] boxed = new Object[ELEMENTS];
+        for (int i = 0; i < ELEMENTS; i++) {
+            prices[i] = 100 + Math.sin(i / 100.0) * 10;
+            boxed[i] = prices[i];
+        }
+
+        measure("Object[]", () -> {
+            Object[] result = JNIV8Array.CreateWithArray(engine, boxed).getV8Elements();
+            assertEquals(boxed[ELEMENTS - 1], result[ELEMENTS - 1]);
+        });
+        measure("double[]", () -> {
+            double[] result = JNIV8Array.CreateWithDoubleArray(engine, prices).getV8ElementsAsDoubleArray();
+            assertEquals(prices[ELEMENTS - 1], result[ELEMENTS - 1], 0);
+        });
+
+        assertArrayEquals(prices, JNIV8Array.CreateWithDoubleArray(engine, prices).getV8ElementsAsDoubleArray(), 0);
+    }
+
+    @Test
+    public void roundTripInts() {
+        final int[] volumes = new int[ELEMENTS];
+        for (int i = 0; i < ELEMENTS; i++) {
+            volumes[i] = i * 7;
+        }
+
+        measure("int[]", () -> {
+            int[] result = JNIV8Array.CreateWithIntArray(engine, volumes).getV8ElementsAsIntArray();
+            assertEquals(volumes[ELEMENTS - 1], result[ELEMENTS - 1]);
+        });
+
+        assertArrayEquals(volumes, JNIV8Array.CreateWithIntArray(engine, volumes).getV8ElementsAsIntArray());
+    }
+
+    private static void measure(String name, Runnable roundTrip) {
+        for (int i = 0; i < WARMUP; i++) {
+            roundTrip.run();
+        }
+        long start = System.nanoTime();
+        for (int i = 0; i < RUNS; i++) {
+            roundTrip.run();
+        }
+        long elapsed = System.nanoTime() - start;
+        Log.i(TAG, String.format("%s, %d elements: %.2f ms/round trip", name, ELEMENTS, elapsed / 1e6 / RUNS));
+    }
+}
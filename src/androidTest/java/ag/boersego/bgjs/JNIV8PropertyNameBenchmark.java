@@ -0,0 +1,62 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertEquals;
+
+/**
+ * Reads the same twenty fields over and over, like chart code reading its data points
+ *
+ * Short names are served from the property name cache of the engine. The same fields are also read with names
+ * padded beyond JNIV8PropertyNameCache::kMaxNameLength (64 characters), which bypass the cache and create a new
+ * v8 string on every access, like all names did before the cache existed. Results are logged as ns per read.
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8PropertyNameBenchmark extends V8EngineTestCase {
+    private static final String TAG = "JNIV8PropertyNameBenchmark";
+    private static final String[] NAMES = {
+            "open", "high", "low", "close", "volume", "time", "bid", "ask", "last", "change",
+            "changePercent", "currency", "exchange", "isin", "wkn", "name", "turnover", "trades", "vwap", "previousClose"
+    };
+    private static final String PADDING = "_padded_beyond_the_maximum_length_of_the_names_held_in_the_property_name_cache";
+    private static final int WARMUP = 20000;
+    private static final int READS = 1000000;
+
+    @Test
+    public void readRepeatedFields() {
+        final String[] longNames = new String[NAMES.length];
+        final StringBuilder script = new StringBuilder("(function() { var o = {};");
+        for (int i = 0; i < NAMES.length; i++) {
+            longNames[i] = NAMES[i] + PADDING;
+            script.append(String.format("o['%s'] = %d; o['%s'] = %d;", NAMES[i], i, longNames[i], i));
+        }
+        script.append("return o; })()");
+        final JNIV8Object object = (JNIV8Object) engine.runScript(script.toString(), "propertyNames");
+
+        final double cached = measure(object, NAMES);
+        final double uncached = measure(object, longNames);
+        Log.i(TAG, String.format("%d names, %d reads: cached %.1f ns/read, uncached %.1f ns/read",
+                NAMES.length, READS, cached, uncached));
+    }
+
+    private static double measure(JNIV8Object object, String[] names) {
+        for (int i = 0; i < WARMUP; i++) {
+            object.getV8Field(names[i % names.length]);
+        }
+        double sum = 0;
+        long start = System.nanoTime();
+        for (int i = 0; i < READS; i++) {
+            sum += ((Number) object.getV8Field(names[i % names.length])).doubleValue();
+        }
+        long elapsed = System.nanoTime() - start;
+
+        // every name is read READS / names.length times and the values are the indices 0..names.length - 1
+        assertEquals((double) READS / names.length * (names.length - 1) * names.length / 2, sum, 0);
+        return (double) elapsed / READS;
+    }
+}
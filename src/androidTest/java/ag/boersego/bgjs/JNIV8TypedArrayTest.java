@@ -0,0 +1,102 @@
+package ag.boersego.bgjs;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.nio.ByteBuffer;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assert.fail;
+
+/**
+ * Checks that typed arrays share memory with their ArrayBuffer and ByteBuffers, that primitive arrays are converted
+ * to typed arrays and back without losing precision, and that invalid sizes are rejected with java exceptions
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8TypedArrayTest extends V8EngineTestCase {
+
+    @Test
+    public void viewsShareMemory() {
+        final JNIV8ArrayBuffer buffer = JNIV8ArrayBuffer.CreateWithLength(engine, 16);
+        final JNIV8TypedArray array = JNIV8TypedArray.CreateWithBuffer(engine, JNIV8TypedArray.Type.Int32, buffer, 4, 2);
+        assertEquals(2, array.getV8Length());
+        assertEquals(4, array.getV8ByteOffset());
+        assertEquals(8, array.getV8ByteLength());
+
+        // java -> js: writes through the ByteBuffer of the view are visible in the ArrayBuffer and in js
+        final ByteBuffer view = array.getV8ByteBuffer();
+        assertEquals(8, view.capacity());
+        view.putInt(0, 42);
+        view.putInt(4, -7);
+        assertEquals(42, buffer.getV8ByteBuffer().getInt(4));
+
+        final JNIV8GenericObject global = engine.getGlobalObject();
+        global.setV8Field("typedArrayTestView", array);
+        assertEquals(35, ((Number) engine.runScript("typedArrayTestView[0] + typedArrayTestView[1]", "typedArray")).intValue());
+
+        // js -> java
+        engine.runScript("new Int32Array(typedArrayTestView.buffer)[2] = 1234;", "typedArray");
+        assertEquals(1234, view.getInt(4));
+        assertArrayEquals(new int[]{42, 1234}, array.toIntArray());
+
+        engine.runScript("delete typedArrayTestView;", "typedArray");
+    }
+
+    @Test
+    public void floatArraysRoundTrip() {
+        final float[] floats = {0f, -1.5f, 3.1415927f, Float.MIN_VALUE, Float.MAX_VALUE, Float.NaN, Float.NEGATIVE_INFINITY};
+        final double[] doubles = {0.0, -1.5, Math.PI, Double.MIN_VALUE, Double.MAX_VALUE, Double.NaN, Double.POSITIVE_INFINITY};
+
+        final JNIV8GenericObject global = engine.getGlobalObject();
+        global.setV8Field("typedArrayTestFloats", floats);
+        global.setV8Field("typedArrayTestDoubles", doubles);
+        assertEquals(Boolean.TRUE, engine.runScript("typedArrayTestFloats instanceof Float32Array && typedArrayTestFloats.length === 7", "typedArray"));
+        assertEquals(Boolean.TRUE, engine.runScript("typedArrayTestDoubles instanceof Float64Array && typedArrayTestDoubles[2] === Math.PI", "typedArray"));
+
+        final JNIV8TypedArray floatArray = (JNIV8TypedArray) global.getV8Field("typedArrayTestFloats");
+        final JNIV8TypedArray doubleArray = (JNIV8TypedArray) global.getV8Field("typedArrayTestDoubles");
+        assertEquals(JNIV8TypedArray.Type.Float32, floatArray.getType());
+        assertEquals(JNIV8TypedArray.Type.Float64, doubleArray.getType());
+        // exact comparison; NaN and infinities included
+        assertArrayEquals(floats, floatArray.toFloatArray(), 0f);
+        assertArrayEquals(doubles, doubleArray.toDoubleArray(), 0.0);
+
+        engine.runScript("delete typedArrayTestFloats; delete typedArrayTestDoubles;", "typedArray");
+    }
+
+    @Test
+    public void invalidSizesAreRejected() {
+        final JNIV8ArrayBuffer buffer = JNIV8ArrayBuffer.CreateWithLength(engine, 16);
+
+        expect(IndexOutOfBoundsException.class, () -> JNIV8TypedArray.CreateWithBuffer(engine, JNIV8TypedArray.Type.Int32, buffer, 2, 1));
+        expect(IndexOutOfBoundsException.class, () -> JNIV8TypedArray.CreateWithBuffer(engine, JNIV8TypedArray.Type.Int32, buffer, 4, 4));
+        expect(IndexOutOfBoundsException.class, () -> JNIV8TypedArray.CreateWithBuffer(engine, JNIV8TypedArray.Type.Int32, buffer, -4, 1));
+        expect(IndexOutOfBoundsException.class, () -> JNIV8DataView.CreateWithBuffer(engine, buffer, 8, 9));
+        expect(IllegalArgumentException.class, () -> JNIV8TypedArray.Create(engine, JNIV8TypedArray.Type.Uint8, -1));
+
+        // larger than v8 can allocate: depending on the pointer size the element count or the byte length is out of range
+        try {
+            JNIV8TypedArray.Create(engine, JNIV8TypedArray.Type.Float64, Integer.MAX_VALUE);
+            fail("expected an exception");
+        } catch (IllegalArgumentException | OutOfMemoryError e) {
+            // expected
+        }
+
+        // the engine is still usable afterwards
+        assertEquals(16, JNIV8TypedArray.Create(engine, JNIV8TypedArray.Type.Uint8, 16).getV8ByteLength());
+    }
+
+    private static void expect(Class<? extends Throwable> expected, Runnable runnable) {
+        try {
+            runnable.run();
+        } catch (Throwable e) {
+            assertTrue("expected " + expected.getSimpleName() + " but got " + e, expected.isInstance(e));
+            return;
+        }
+        fail("expected " + expected.getSimpleName());
+    }
+}
@@ -0,0 +1,64 @@
+package ag.boersego.bgjs;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.lang.ref.WeakReference;
+import java.util.ArrayList;
+import java.util.List;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotNull;
+import static org.junit.Assert.assertSame;
+
+/**
+ * Checks that wrapping the same js object repeatedly returns the same java object,
+ * and that the java wrappers can still be collected while the js objects are alive
+ */
+@RunWith(AndroidJUnit4.class)
+public class JNIV8WrapperIdentityTest extends V8EngineTestCase {
+    private static final int OBJECTS = 100;
+
+    @Test
+    public void repeatedWrapReturnsSameObject() {
+        final JNIV8GenericObject global = engine.getGlobalObject();
+        engine.runScript("this.identityTestObject = {value: 1};", "identity");
+
+        final Object first = global.getV8Field("identityTestObject");
+        final Object second = global.getV8Field("identityTestObject");
+        final Object fromScript = engine.runScript("identityTestObject", "identity");
+        assertNotNull(first);
+        assertSame(first, second);
+        assertSame(first, fromScript);
+
+        engine.runScript("delete identityTestObject;", "identity");
+    }
+
+    @Test
+    public void wrappersAreReleasedAfterGC() throws InterruptedException {
+        final JNIV8GenericObject global = engine.getGlobalObject();
+        engine.runScript("this.identityTestObjects = []; for(var i = 0; i < " + OBJECTS + "; i++) identityTestObjects.push({value: i});", "identity");
+
+        final List<WeakReference<Object>> references = new ArrayList<>();
+        JNIV8Array array = (JNIV8Array) global.getV8Field("identityTestObjects");
+        for (int i = 0; i < OBJECTS; i++) {
+            references.add(new WeakReference<>(array.getV8Element(i)));
+        }
+        array = null;
+
+        // the js objects are still referenced from the global object; only the java wrappers may go away
+        assertEquals(0, collectUntilCleared(references, 20000));
+
+        // wrapping again after the old wrapper was collected has to produce a working object
+        array = (JNIV8Array) global.getV8Field("identityTestObjects");
+        for (int i = 0; i < OBJECTS; i++) {
+            final JNIV8GenericObject object = (JNIV8GenericObject) array.getV8Element(i);
+            assertEquals(i, ((Number) object.getV8Field("value")).intValue());
+            assertSame(object, array.getV8Element(i));
+        }
+
+        engine.runScript("delete identityTestObjects;", "identity");
+    }
+}
@@ -0,0 +1,49 @@
+package ag.boersego.bgjs;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicReference;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Checks that setImmediate passes all arguments after the callback on to it, like node does
+ */
+@RunWith(AndroidJUnit4.class)
+public class SetImmediateTest extends V8EngineTestCase {
+
+    @Test
+    public void passesExtraArguments() throws InterruptedException {
+        assertArrayEquals(new Object[]{1.0, "two", true}, runImmediate("1, 'two', true"));
+    }
+
+    @Test
+    public void passesNoArguments() throws InterruptedException {
+        assertArrayEquals(new Object[0], runImmediate(""));
+    }
+
+    /**
+     * queues an immediate with the specified extra arguments and returns the arguments the callback received
+     */
+    private static Object[] runImmediate(String arguments) throws InterruptedException {
+        final AtomicReference<Object[]> received = new AtomicReference<>();
+        final CountDownLatch done = new CountDownLatch(1);
+        engine.getGlobalObject().setV8Field("immediateTestCallback", JNIV8Function.Create(engine, (receiver, args) -> {
+            received.set(args);
+            done.countDown();
+            return JNIV8Undefined.GetInstance();
+        }));
+
+        engine.runScript("setImmediate(immediateTestCallback" + (arguments.isEmpty() ? "" : ", " + arguments) + ");", "immediate");
+        assertTrue("immediate did not run", done.await(5, TimeUnit.SECONDS));
+
+        engine.runScript("delete immediateTestCallback;", "immediate");
+        return received.get();
+    }
+}
@@ -0,0 +1,78 @@
+package ag.boersego.bgjs;
+
+import android.os.Process;
+import android.util.Log;
+
+import androidx.test.ext.junit.runners.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Measures event loop wakeups and cpu time for 50 interval timers of about one second each
+ *
+ * The timers are started a few milliseconds apart, like independent widgets polling their data, so that without slack
+ * each one wakes the loop on its own. Wakeups are counted in js as the number of distinct milliseconds in which
+ * at least one timer ran; timers that share a wakeup run in the same loop iteration.
+ * The run is repeated with a timer slack; wakeups per second, process cpu time and the mean lateness are logged.
+ */
+@RunWith(AndroidJUnit4.class)
+public class TimerSlackBenchmark extends V8EngineTestCase {
+    private static final String TAG = "TimerSlackBenchmark";
+    private static final int TIMERS = 50;
+    private static final int INTERVAL_MS = 1000;
+    private static final int SLACK_MS = 100;
+    private static final int DURATION_MS = 10000;
+
+    @Test
+    public void coalesceTimers() throws InterruptedException {
+        final double[] withoutSlack = run(0);
+        final double[] withSlack = run(SLACK_MS);
+        engine.setTimerSlack(0);
+
+        Log.i(TAG, String.format("%d timers every %d ms, without slack: %.1f wakeups/s, %.0f ms cpu, %.1f ms late",
+                TIMERS, INTERVAL_MS, withoutSlack[0], withoutSlack[1], withoutSlack[2]));
+        Log.i(TAG, String.format("%d timers every %d ms, %d ms slack: %.1f wakeups/s, %.0f ms cpu, %.1f ms late",
+                TIMERS, INTERVAL_MS, SLACK_MS, withSlack[0], withSlack[1], withSlack[2]));
+        assertTrue("slack did not reduce wakeups", withSlack[0] < withoutSlack[0]);
+    }
+
+    /**
+     * returns wakeups per second, cpu time in ms and the mean lateness of a timer run in ms
+     */
+    private static double[] run(int slackMs) throws InterruptedException {
+        engine.setTimerSlack(slackMs);
+        engine.runScript("(function() {" +
+                "slackTest = {wakeups: {}, late: 0, runs: 0, timers: []};" +
+                "for (var i = 0; i < " + TIMERS + "; i++) {" +
+                "  setTimeout(function() {" +
+                "    var next = Date.now() + " + INTERVAL_MS + ";" +
+                "    slackTest.timers.push(setInterval(function() {" +
+                "      var now = Date.now();" +
+                "      slackTest.wakeups[now] = true;" +
+                "      slackTest.late += now - next; slackTest.runs++; next += " + INTERVAL_MS + ";" +
+                "    }, " + INTERVAL_MS + "));" +
+                "  }, i * 7);" +
+                "}" +
+                "})();", "timerSlack");
+
+        final long cpuStart = Process.getElapsedCpuTime();
+        Thread.sleep(DURATION_MS);
+        final long cpuMs = Process.getElapsedCpuTime() - cpuStart;
+
+        final Object result = engine.runScript("(function() {" +
+                "slackTest.timers.forEach(clearInterval);" +
+                "var result = Object.keys(slackTest.wakeups).length + ',' + (slackTest.runs ? slackTest.late / slackTest.runs : 0);" +
+                "delete slackTest;" +
+                "return result;" +
+                "})();", "timerSlack");
+        final String[] values = ((String) result).split(",");
+        return new double[]{
+                Double.parseDouble(values[0]) * 1000.0 / DURATION_MS,
+                cpuMs,
+                Double.parseDouble(values[1])
+        };
+    }
+}
@@ -0,0 +1,54 @@
+package ag.boersego.bgjs;
+
+import ag.boersego.v8annotations.V8Class;
+import ag.boersego.v8annotations.V8ClassCreationPolicy;
+import ag.boersego.v8annotations.V8Function;
+import ag.boersego.v8annotations.V8Getter;
+import ag.boersego.v8annotations.V8Setter;
+
+/**
+ * JNIV8Object with primitive and object accessors and methods used by JNIV8BindingBenchmark
+ */
+@V8Class(creationPolicy = V8ClassCreationPolicy.JAVA_ONLY)
+public class V8AccessorTestObject extends JNIV8Object {
+    static {
+        JNIV8Object.RegisterV8Class(V8AccessorTestObject.class);
+    }
+
+    private double value;
+    private String name = "";
+
+    public V8AccessorTestObject(V8Engine engine) {
+        super(engine);
+    }
+
+    @V8Getter
+    public double getValue() {
+        return value;
+    }
+
+    @V8Setter
+    public void setValue(double value) {
+        this.value = value;
+    }
+
+    @V8Getter
+    public String getName() {
+        return name;
+    }
+
+    @V8Setter
+    public void setName(String name) {
+        this.name = name;
+    }
+
+    @V8Function
+    public double scale(double factor) {
+        return value * factor;
+    }
+
+    @V8Function
+    public String prefix(String prefix) {
+        return prefix + name;
+    }
+}
@@ -0,0 +1,65 @@
+package ag.boersego.bgjs;
+
+import androidx.test.platform.app.InstrumentationRegistry;
+
+import org.junit.BeforeClass;
+
+import java.lang.ref.WeakReference;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Base class for instrumented tests that need a running engine
+ * All tests share one engine; it is started on first use and never shut down.
+ */
+public abstract class V8EngineTestCase {
+    protected static V8Engine engine;
+
+    @BeforeClass
+    public static void startEngine() throws InterruptedException {
+        synchronized (V8EngineTestCase.class) {
+            if (engine != null) {
+                return;
+            }
+            V8Engine newEngine = new V8Engine();
+            final CountDownLatch ready = new CountDownLatch(1);
+            newEngine.addStatusHandler(ready::countDown);
+            newEngine.start(InstrumentationRegistry.getInstrumentation().getTargetContext());
+            assertTrue("engine did not start", ready.await(30, TimeUnit.SECONDS));
+            engine = newEngine;
+        }
+    }
+
+    /**
+     * runs a full garbage collection in js first, so that js objects release their java peers, then in java
+     */
+    protected static void collectGarbage() {
+        engine.runScript("gc()", "gc");
+        Runtime.getRuntime().gc();
+        System.runFinalization();
+    }
+
+    /**
+     * collects garbage until all referents are cleared; returns the number of referents that are still alive after the timeout
+     */
+    protected static int collectUntilCleared(List<? extends WeakReference<?>> references, long timeoutMs) throws InterruptedException {
+        long deadline = System.currentTimeMillis() + timeoutMs;
+        int alive;
+        do {
+            collectGarbage();
+            alive = 0;
+            for (WeakReference<?> reference : references) {
+                if (reference.get() != null) {
+                    alive++;
+                }
+            }
+            if (alive > 0) {
+                Thread.sleep(50);
+            }
+        } while (alive > 0 && System.currentTimeMillis() < deadline);
+        return alive;
+    }
+}
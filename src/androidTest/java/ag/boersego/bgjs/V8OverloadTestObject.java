@@ -0,0 +1,44 @@
+package ag.boersego.bgjs;
+
+import ag.boersego.v8annotations.V8Class;
+import ag.boersego.v8annotations.V8ClassCreationPolicy;
+import ag.boersego.v8annotations.V8Function;
+
+/**
+ * JNIV8Object with overloaded methods used by JNIV8MethodCallBenchmark
+ */
+@V8Class(creationPolicy = V8ClassCreationPolicy.JAVA_ONLY)
+public class V8OverloadTestObject extends JNIV8Object {
+    static {
+        JNIV8Object.RegisterV8Class(V8OverloadTestObject.class);
+    }
+
+    public V8OverloadTestObject(V8Engine engine) {
+        super(engine);
+    }
+
+    @V8Function
+    public double add(double a, double b) {
+        return a + b;
+    }
+
+    @V8Function
+    public String describe(String value) {
+        return "string";
+    }
+
+    @V8Function
+    public String describe(JNIV8Array value) {
+        return "array";
+    }
+
+    @V8Function
+    public String describe(V8TestObject value) {
+        return "test object";
+    }
+
+    @V8Function
+    public String describe(Object value) {
+        return "object";
+    }
+}
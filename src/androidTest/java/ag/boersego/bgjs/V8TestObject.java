@@ -0,0 +1,18 @@
+package ag.boersego.bgjs;
+
+import ag.boersego.v8annotations.V8Class;
+import ag.boersego.v8annotations.V8ClassCreationPolicy;
+
+/**
+ * Minimal persistent JNIV8Object used by the instrumented tests
+ */
+@V8Class(creationPolicy = V8ClassCreationPolicy.JAVA_ONLY)
+public class V8TestObject extends JNIV8Object {
+    static {
+        JNIV8Object.RegisterV8Class(V8TestObject.class);
+    }
+
+    public V8TestObject(V8Engine engine) {
+        super(engine);
+    }
+}
@@ -0,0 +1,181 @@
+#include "BGJSLogSink.h"
+#include "os-android.h"
+
+#define LOG_TAG    "BGJSV8Engine-jni"
+
+BGJSLogSink* BGJSLogSink::getInstance() {
+    // intentionally leaked; the writer thread runs until the process exits
+    static BGJSLogSink *instance = new BGJSLogSink();
+    return instance;
+}
+
+BGJSLogSink::BGJSLogSink() : _enqueuePos(0), _dequeuePos(0), _dropped(0), _reportedDropped(0), _written(0), _started(false), _sleeping(false),
+                             _writer(&BGJSLogSink::LogcatWriter), _writerData(nullptr) {
+    for (size_t i = 0; i < kCapacity; i++) {
+        _entries[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    uv_mutex_init(&_mutex);
+    uv_cond_init(&_condWork);
+    uv_cond_init(&_condFlushed);
+}
+
+void BGJSLogSink::start() {
+    bool expected = false;
+    if (_started.compare_exchange_strong(expected, true)) {
+        uv_thread_create(&_thread, &BGJSLogSink::ThreadMain, this);
+    }
+}
+
+bool BGJSLogSink::log(int level, std::string &&message) {
+    std::vector<Frame> stack;
+    return log(level, std::move(message), std::move(stack));
+}
+
+bool BGJSLogSink::log(int level, std::string &&message, std::vector<Frame> &&stack) {
+    if (!_started.load(std::memory_order_acquire)) {
+        start();
+    }
+
+    // bounded multi producer queue: claim a slot by advancing the enqueue position
+    // a slot is free if its sequence matches the position that is about to be claimed
+    size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Entry *entry;
+    for (;;) {
+        entry = &_entries[pos % kCapacity];
+        size_t seq = entry->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // buffer is full; the writer thread will report the number of dropped messages
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            wake();
+            return false;
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    entry->level = level;
+    entry->timestamp = (int64_t)uv_hrtime();
+    entry->message.swap(message);
+    entry->stack.swap(stack);
+    entry->sequence.store(pos + 1, std::memory_order_release);
+
+    wake();
+
+    return true;
+}
+
+void BGJSLogSink::flush() {
+    if (!_started.load(std::memory_order_acquire)) return;
+
+    size_t target = _enqueuePos.load(std::memory_order_acquire);
+    uv_mutex_lock(&_mutex);
+    while (_written.load(std::memory_order_acquire) < target) {
+        uv_cond_signal(&_condWork);
+        uv_cond_wait(&_condFlushed, &_mutex);
+    }
+    uv_mutex_unlock(&_mutex);
+}
+
+void BGJSLogSink::setWriter(Writer writer, void *data) {
+    uv_mutex_lock(&_mutex);
+    _writer = writer ? writer : &BGJSLogSink::LogcatWriter;
+    _writerData = writer ? data : nullptr;
+    uv_mutex_unlock(&_mutex);
+}
+
+/**
+ * wakes the writer thread if it is waiting for work
+ * only the first producer after the writer went to sleep takes the mutex; all others return immediately
+ */
+void BGJSLogSink::wake() {
+    // pairs with the fence in ThreadMain: either the writer sees the new entry, or we see that it is sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed) && _sleeping.exchange(false)) {
+        // the writer only holds the mutex between announcing that it sleeps and waiting,
+        // so this never waits for a write and the signal can not get lost
+        uv_mutex_lock(&_mutex);
+        uv_cond_signal(&_condWork);
+        uv_mutex_unlock(&_mutex);
+    }
+}
+
+bool BGJSLogSink::hasPending() const {
+    return _entries[_dequeuePos % kCapacity].sequence.load(std::memory_order_acquire) == _dequeuePos + 1 ||
+           _dropped.load(std::memory_order_relaxed) != _reportedDropped;
+}
+
+uint64_t BGJSLogSink::getDroppedCount() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+void BGJSLogSink::drain(Writer writer, void *writerData) {
+    // single consumer; only ever called on the writer thread, without holding _mutex
+    for (;;) {
+        Entry *entry = &_entries[_dequeuePos % kCapacity];
+        size_t seq = entry->sequence.load(std::memory_order_acquire);
+        if (seq != _dequeuePos + 1) break;
+
+        if (entry->stack.empty()) {
+            writer(entry->level, entry->timestamp, entry->message.c_str(), writerData);
+        } else {
+            _formatted = entry->message;
+            for (auto &frame : entry->stack) {
+                _formatted += "\n    ";
+                _formatted += frame.script;
+                _formatted += " (";
+                _formatted += frame.function;
+                _formatted += ':';
+                _formatted += std::to_string(frame.line);
+                _formatted += ')';
+            }
+            writer(entry->level, entry->timestamp, _formatted.c_str(), writerData);
+            entry->stack.clear();
+        }
+        // keep the allocated capacity around for the next message that is stored in this slot
+        entry->message.clear();
+        entry->sequence.store(_dequeuePos + kCapacity, std::memory_order_release);
+        _dequeuePos++;
+        _written.store(_dequeuePos, std::memory_order_release);
+    }
+
+    uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped != _reportedDropped) {
+        std::string message = "console buffer overflow: " + std::to_string(dropped - _reportedDropped) + " message(s) dropped";
+        writer(LOG_ERROR, (int64_t)uv_hrtime(), message.c_str(), writerData);
+        _reportedDropped = dropped;
+    }
+}
+
+void BGJSLogSink::ThreadMain(void *arg) {
+    auto sink = reinterpret_cast<BGJSLogSink*>(arg);
+
+    uv_mutex_lock(&sink->_mutex);
+    for (;;) {
+        Writer writer = sink->_writer;
+        void *writerData = sink->_writerData;
+
+        // writing can be slow (logcat); producers that want to wake us must not wait for it
+        uv_mutex_unlock(&sink->_mutex);
+        sink->drain(writer, writerData);
+        uv_mutex_lock(&sink->_mutex);
+
+        uv_cond_broadcast(&sink->_condFlushed);
+
+        sink->_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // entries published before the producer saw the flag have to be picked up without waiting
+        if (!sink->hasPending()) {
+            uv_cond_wait(&sink->_condWork, &sink->_mutex);
+        }
+        sink->_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void BGJSLogSink::LogcatWriter(int level, int64_t timestamp, const char *message, void *data) {
+    LOG(level, "%s", message);
+}
@@ -0,0 +1,97 @@
+#ifndef __BGJSLOGSINK_H
+#define __BGJSLOGSINK_H 1
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <uv.h>
+
+/**
+ * BGJSLogSink
+ * Buffers console output and writes it to logcat (or a custom writer) on a background thread
+ *
+ * Producers never block: messages are stored in a fixed size lock-free ring buffer;
+ * if the buffer is full the message is dropped and counted instead.
+ * The writer thread sleeps until a message arrives and only has to be woken up once per burst of messages.
+ */
+class BGJSLogSink {
+public:
+    typedef void (*Writer)(int level, int64_t timestamp, const char *message, void *data);
+
+    /**
+     * a javascript stack frame; frames are formatted on the writer thread
+     */
+    struct Frame {
+        std::string script, function;
+        int line;
+    };
+
+    static BGJSLogSink* getInstance();
+
+    /**
+     * enqueue a message; safe to call from any thread
+     * if stack is not empty, the frames are appended to the message by the writer thread
+     * returns false if the message was dropped because the buffer is full
+     */
+    bool log(int level, std::string &&message);
+    bool log(int level, std::string &&message, std::vector<Frame> &&stack);
+
+    /**
+     * blocks until all messages that were enqueued before this call have been written
+     */
+    void flush();
+
+    /**
+     * replace the writer used to output messages; pass nullptr to restore the default logcat writer
+     */
+    void setWriter(Writer writer, void *data);
+
+    /**
+     * total number of messages dropped because the buffer was full
+     */
+    uint64_t getDroppedCount() const;
+
+private:
+    static const size_t kCapacity = 1024;
+
+    struct Entry {
+        std::atomic<size_t> sequence;
+        int level;
+        int64_t timestamp;
+        std::string message;
+        std::vector<Frame> stack;
+    };
+
+    BGJSLogSink();
+
+    void start();
+    void drain(Writer writer, void *writerData);
+    void wake();
+    bool hasPending() const;
+
+    static void ThreadMain(void *arg);
+    static void LogcatWriter(int level, int64_t timestamp, const char *message, void *data);
+
+    Entry _entries[kCapacity];
+    std::atomic<size_t> _enqueuePos;
+    size_t _dequeuePos;
+
+    std::atomic<uint64_t> _dropped;
+    uint64_t _reportedDropped;
+    std::atomic<uint64_t> _written;
+    std::atomic<bool> _started;
+    // true while the writer thread is about to wait or waiting for work
+    std::atomic<bool> _sleeping;
+
+    // guarded by _mutex; the writer thread picks up changes before the next drain
+    Writer _writer;
+    void *_writerData;
+    // only used by the writer thread
+    std::string _formatted;
+
+    uv_thread_t _thread;
+    uv_mutex_t _mutex;
+    uv_cond_t _condWork, _condFlushed;
+};
+
+#endif
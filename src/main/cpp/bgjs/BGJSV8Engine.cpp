@@ -12,6 +12,9 @@
 #include "../v8/JNIV8Wrapper.h"
 #include "../v8/JNIV8GenericObject.h"
 #include "../v8/JNIV8Function.h"
+#include "../v8/JNIV8ArrayBuffer.h"
+#include "../v8/JNIV8Array.h"
+#include "../v8/JNIV8Promise.h"
 
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
@@ -21,11 +24,21 @@
 #include <sstream>
 
 #include "BGJSGLView.h"
+#include "BGJSLogSink.h"
 #include "modules/BGJSGLModule.h"
 #include "v8-profiler.h"
 
 #define LOG_TAG    "BGJSV8Engine-jni"
 
+// upper bound for the time budget of idle callbacks (in ms); same as in browsers
+#define MAX_IDLE_DEADLINE 50
+
+// time budget (in ms) for user-visible and background tasks per loop iteration; user-blocking tasks are not limited
+#define TASK_TIME_SLICE 8
+
+// tasks that waited longer than this (in ms) are promoted to the next higher priority class
+#define TASK_STARVATION_LIMIT 100
+
 #define THROW_IF_NOT_STARTED()\
 if(engine->_state != EState::kStarted) {\
 jthrowable throwable = (jthrowable) env->NewObject(_jniV8Exception.clazz, _jniV8Exception.initId, JNIWrapper::string2jstring("Engine is not started"), nullptr);\
@@ -41,11 +54,31 @@ BGJS_JNI_LINK(BGJSV8Engine, "ag/boersego/bgjs/V8Engine")
 
 jint JNI_OnLoad(JavaVM* vm, void* reserved)  {
     if(!JNIWrapper::isInitialized()) {
+        uint64_t start = uv_hrtime();
+
         JNIWrapper::init(vm);
+
+        // the java classes of this library bind their natives via JNIObject.InitializeClass, so they are only declared here
+        // classes registered by other libraries are still initialized right away unless they opt in the same way
+        JNIWrapper::setDeferClassInitialization(true);
         JNIV8Wrapper::init();
 
         JNIWrapper::registerObject<BGJSV8Engine>();
         JNIV8Wrapper::registerObject<BGJSGLView>();
+        JNIWrapper::setDeferClassInitialization(false);
+
+        // every engine needs these right after it was started; initialize them off the startup path
+        JNIWrapper::preloadClasses({
+            JNIBase::getCanonicalName<BGJSV8Engine>(),
+            JNIBase::getCanonicalName<JNIV8Object>(),
+            JNIBase::getCanonicalName<JNIV8GenericObject>(),
+            JNIBase::getCanonicalName<JNIV8Function>(),
+            JNIBase::getCanonicalName<JNIV8Array>(),
+            JNIBase::getCanonicalName<JNIV8Promise>()
+        });
+
+        // classes are only declared here and initialized on first use or in the background, so this should stay well below a millisecond
+        LOGI("JNI_OnLoad took %.2fms", (uv_hrtime() - start) / 1e6);
     }
 
     return JNI_VERSION_1_6;
@@ -220,10 +253,15 @@ decltype(BGJSV8Engine::_jniV8Exception) BGJSV8Engine::_jniV8Exception = {nullptr
 decltype(BGJSV8Engine::_jniV8JSException) BGJSV8Engine::_jniV8JSException = {nullptr};
 decltype(BGJSV8Engine::_jniStackTraceElement) BGJSV8Engine::_jniStackTraceElement = {nullptr};
 decltype(BGJSV8Engine::_jniV8Engine) BGJSV8Engine::_jniV8Engine = {nullptr};
+decltype(BGJSV8Engine::_jniRunnable) BGJSV8Engine::_jniRunnable = {nullptr};
+decltype(BGJSV8Engine::_jniRuntimeException) BGJSV8Engine::_jniRuntimeException = {nullptr};
+decltype(BGJSV8Engine::_jniNumber) BGJSV8Engine::_jniNumber = {nullptr};
+decltype(BGJSV8Engine::_jniBoolean) BGJSV8Engine::_jniBoolean = {nullptr};
+decltype(BGJSV8Engine::_jniString) BGJSV8Engine::_jniString = {nullptr};
 
 void BGJSV8Engine::RejectedPromiseHolderWeakPersistentCallback(const v8::WeakCallbackInfo<void> &data) {
     auto *holder = reinterpret_cast<RejectedPromiseHolder *>(data.GetParameter());
-    holder->promise.Reset();
+    BGJS_CLEAR_PERSISTENT(holder->promise);
     holder->collected = true;
 }
 
@@ -241,9 +279,9 @@ void BGJSV8EngineJavaErrorHolderWeakPersistentCallback(const v8::WeakCallbackInf
     JNIEnv *env = JNIWrapper::getEnvironment();
 
     auto *holder = reinterpret_cast<BGJSV8EngineJavaErrorHolder *>(data.GetParameter());
-    env->DeleteGlobalRef(holder->throwable);
+    BGJS_DELETE_GLOBAL_REF(env, holder->throwable);
 
-    holder->persistent.Reset();
+    BGJS_CLEAR_PERSISTENT(holder->persistent);
     delete holder;
 }
 
@@ -281,6 +319,9 @@ bool BGJSV8Engine::forwardJNIExceptionToV8() const {
     if(env->IsInstanceOf(e, _jniV8JSException.clazz)) {
         jobject v8Exception = env->CallObjectMethod(e, _jniV8JSException.getV8ExceptionId);
         _isolate->ThrowException(JNIV8Marshalling::jobject2v8value(v8Exception));
+        // callers do not necessarily run inside a local frame (e.g. methods returning primitives)
+        env->DeleteLocalRef(v8Exception);
+        env->DeleteLocalRef(e);
         return true;
     }
 
@@ -293,8 +334,9 @@ bool BGJSV8Engine::forwardJNIExceptionToV8() const {
     auto privateKey = v8::Private::ForApi(_isolate, v8::String::NewFromUtf8(_isolate, "JavaErrorExternal"));
     result->SetPrivate(context, privateKey, External::New(_isolate, holder));
 
-    holder->throwable = (jthrowable) env->NewGlobalRef(e);
-    holder->persistent.Reset(_isolate, result);
+    holder->throwable = (jthrowable) BGJS_NEW_GLOBAL_REF(env, e);
+    env->DeleteLocalRef(e);
+    BGJS_RESET_PERSISTENT(_isolate, holder->persistent, result);
     holder->persistent.SetWeak((void *) holder, BGJSV8EngineJavaErrorHolderWeakPersistentCallback,
                                v8::WeakCallbackType::kParameter);
 
@@ -346,7 +388,7 @@ bool BGJSV8Engine::forwardV8ExceptionToJNI(std::string messagePrefix, v8::Local<
                 causeException = env->NewLocalRef(holder->throwable);
             } else {
                 if(throwOnMainThread) {
-                    env->CallVoidMethod(getJObject(), _jniV8Engine.onThrowId, holder->throwable);
+                    env->CallVoidMethod(getBorrowedJObject(), _jniV8Engine.onThrowId, holder->throwable);
                 } else {
                     // otherwise we can reuse the embedded V8Exception!
                     env->Throw((jthrowable) env->NewLocalRef(holder->throwable));
@@ -496,7 +538,7 @@ bool BGJSV8Engine::forwardV8ExceptionToJNI(std::string messagePrefix, v8::Local<
                                                        JNIWrapper::string2jstring("An exception was thrown in JavaScript"),
                                                        v8JSException);
     if(throwOnMainThread) {
-        env->CallVoidMethod(getJObject(), _jniV8Engine.onThrowId, throwable);
+        env->CallVoidMethod(getBorrowedJObject(), _jniV8Engine.onThrowId, throwable);
     } else {
         env->Throw(throwable);
     }
@@ -526,8 +568,8 @@ void BGJSV8Engine::JavaModuleRequireCallback(BGJSV8Engine *engine, v8::Handle<v8
 
     jobject module = engine->_javaModules.at(moduleId);
 
-    env->CallVoidMethod(module, _jniV8Module.requireId, engine->getJObject(),
-                        JNIV8Wrapper::wrapObject<JNIV8GenericObject>(target)->getJObject());
+    env->CallVoidMethod(module, _jniV8Module.requireId, engine->getBorrowedJObject(),
+                        JNIV8Wrapper::wrapObject<JNIV8GenericObject>(target)->getBorrowedJObject());
 }
 
 bool BGJSV8Engine::registerJavaModule(jobject module) {
@@ -541,7 +583,7 @@ bool BGJSV8Engine::registerJavaModule(jobject module) {
 
     std::string strModuleName = JNIWrapper::jstring2string(
             (jstring) env->CallObjectMethod(module, _jniV8Module.getNameId));
-    _javaModules[strModuleName] = env->NewGlobalRef(module);
+    _javaModules[strModuleName] = BGJS_NEW_GLOBAL_REF(env, module);
     _modules[strModuleName] = (requireHook) &BGJSV8Engine::JavaModuleRequireCallback;
 
     return true;
@@ -698,7 +740,7 @@ MaybeLocal<Value> BGJSV8Engine::require(std::string baseNameStr) {
 
             module(this, moduleObj);
             result = moduleObj->Get(String::NewFromUtf8(_isolate, "exports"));
-            _moduleCache[baseNameStr].Reset(_isolate, result);
+            BGJS_RESET_PERSISTENT(_isolate, _moduleCache[baseNameStr], result);
             return handle_scope.Escape(result);
         } else {
             baseNameStr = _commonJSPath + baseNameStr;
@@ -837,7 +879,7 @@ MaybeLocal<Value> BGJSV8Engine::require(std::string baseNameStr) {
 
         if (!maybeLocal.IsEmpty()) {
             result = moduleObj->Get(String::NewFromUtf8(_isolate, "exports"));
-            _moduleCache[fileName].Reset(_isolate, result);
+            BGJS_RESET_PERSISTENT(_isolate, _moduleCache[fileName], result);
 
             return handle_scope.Escape(result);
         }
@@ -862,11 +904,27 @@ v8::Local<v8::Context> BGJSV8Engine::getContext() const {
     return scope.Escape(Local<Context>::New(_isolate, _context));
 }
 
+v8::Local<v8::Private> BGJSV8Engine::getWrapperPeerKey() const {
+    return Local<Private>::New(_isolate, _wrapperPeerKey);
+}
+
+JNIV8PropertyNameCache& BGJSV8Engine::getPropertyNameCache() {
+    return _propertyNameCache;
+}
+
+std::set<JNIV8ArrayBufferHolder*>& BGJSV8Engine::getExternalArrayBuffers() {
+    return _externalArrayBuffers;
+}
+
+JNIV8ClassInfoTable& BGJSV8Engine::getClassInfoTable() {
+    return _classInfoTable;
+}
+
 void BGJSV8Engine::js_process_nextTick(const v8::FunctionCallbackInfo<v8::Value> &args) {
     BGJSV8Engine *ctx = BGJSV8Engine::GetInstance(args.GetIsolate());
     if (args.Length() >= 1 && args[0]->IsFunction()) {
         TaskHolder *holder = new TaskHolder();
-        holder->callback.Reset(args.GetIsolate(), args[0].As<v8::Function>());
+        BGJS_RESET_PERSISTENT(args.GetIsolate(), holder->callback, args[0].As<v8::Function>());
         args.GetIsolate()->EnqueueMicrotask(&BGJSV8Engine::OnTaskMicrotask, (void*)holder);
     } else {
         ctx->getIsolate()->ThrowException(
@@ -915,7 +973,7 @@ void BGJSV8Engine::js_global_setInterval(const v8::FunctionCallbackInfo<v8::Valu
 
 uint64_t BGJSV8Engine::createTimer(v8::Local<v8::Function> callback, uint64_t delay, uint64_t repeat) {
     auto *holder = new TimerHolder();
-    holder->callback.Reset(_isolate, callback);
+    BGJS_RESET_PERSISTENT(_isolate, holder->callback, callback);
     holder->engine = this;
     holder->id = _nextTimerId++;
     holder->repeats = repeat > 0;
@@ -948,7 +1006,7 @@ void BGJSV8Engine::OnTimerEventCallback(uv_async_t * handle) {
         if(!holder->scheduled) {
             uv_timer_init(&engine->_uvLoop, &holder->handle);
             holder->handle.data = holder;
-            uv_timer_start(&holder->handle, &BGJSV8Engine::OnTimerTriggeredCallback, holder->delay, holder->repeat);
+            engine->startTimer(holder, holder->delay);
             holder->scheduled = true;
         } else if(holder->cleared && !holder->stopped) {
             holder->stopped = true;
@@ -958,6 +1016,37 @@ void BGJSV8Engine::OnTimerEventCallback(uv_async_t * handle) {
     }
 }
 
+/**
+ * returns the configured timer slack
+ * timers do not need a larger slack while the engine is paused: the loop is blocked and no timer fires
+ */
+uint64_t BGJSV8Engine::getTimerSlack() {
+    uv_mutex_lock(&_uvMutex);
+    uint64_t slack = _timerSlack;
+    uv_mutex_unlock(&_uvMutex);
+    return slack;
+}
+
+/**
+ * (re)starts the uv timer of a holder
+ * repeating timers are re-armed manually after each run, so that every run can be aligned to the timer slack
+ * with a slack of n ms all timers are due at a multiple of n; libuv then runs all of them in the same loop iteration
+ */
+void BGJSV8Engine::startTimer(TimerHolder *holder, uint64_t delay) {
+    uint64_t slack = getTimerSlack();
+    if(slack > 1) {
+        uint64_t due = uv_now(&_uvLoop) + delay;
+        delay += (slack - due % slack) % slack;
+    }
+    uv_timer_start(&holder->handle, &BGJSV8Engine::OnTimerTriggeredCallback, delay, 0);
+}
+
+void BGJSV8Engine::setTimerSlack(uint64_t slack) {
+    uv_mutex_lock(&_uvMutex);
+    _timerSlack = slack;
+    uv_mutex_unlock(&_uvMutex);
+}
+
 /**
  * called by libuv when a timer was triggered
  */
@@ -977,6 +1066,11 @@ void BGJSV8Engine::OnTimerTriggeredCallback(uv_timer_t * handle) {
     // timer might have been stopped while waiting for the locker
     if(holder->cleared) return;
 
+    // re-arm before invoking the callback (same as libuv does for repeating timers); clearing it from the callback still works
+    if(holder->repeats) {
+        holder->engine->startTimer(holder, holder->repeat);
+    }
+
     v8::Local<v8::Function> funcRef = v8::Local<v8::Function>::New(isolate, holder->callback);
     v8::MaybeLocal<v8::Value> maybeValueRef = funcRef->Call(context, context->Global(), 0, nullptr);
 
@@ -999,7 +1093,7 @@ void BGJSV8Engine::OnTimerClosedCallback(uv_handle_t * handle) {
 
     v8::Locker l(engine->getIsolate());
 
-    holder->callback.Reset();
+    BGJS_CLEAR_PERSISTENT(holder->callback);
     holder->engine.reset();
     delete holder;
 
@@ -1034,6 +1128,582 @@ void BGJSV8Engine::js_global_clearTimeoutOrInterval(const v8::FunctionCallbackIn
     }
 }
 
+void BGJSV8Engine::js_global_setImmediate(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    BGJSV8Engine *ctx = BGJSV8Engine::GetInstance(args.GetIsolate());
+
+    if (args.Length() >= 1 && args[0]->IsFunction()) {
+        v8::Isolate *isolate = args.GetIsolate();
+        HandleScope scope(isolate);
+
+        // like in node, all arguments after the callback are passed on to it
+        v8::Local<v8::Array> arguments;
+        if (args.Length() > 1) {
+            arguments = v8::Array::New(isolate, args.Length() - 1);
+            Local<Context> context = isolate->GetCurrentContext();
+            for (int i = 1; i < args.Length(); i++) {
+                arguments->Set(context, (uint32_t)(i - 1), args[i]).FromJust();
+            }
+        }
+
+        uint64_t id = ctx->enqueueTask(ctx->_immediates, args[0].As<v8::Function>(), 0, arguments);
+        args.GetReturnValue().Set(v8::Number::New(isolate, (double)id));
+    } else {
+        ctx->getIsolate()->ThrowException(
+                v8::Exception::ReferenceError(
+                        v8::String::NewFromUtf8(ctx->getIsolate(), "callback must be a function")));
+    }
+}
+
+void BGJSV8Engine::js_global_clearImmediate(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    BGJSV8Engine *ctx = BGJSV8Engine::GetInstance(args.GetIsolate());
+    ctx->cancelTask(ctx->_immediates, args);
+}
+
+void BGJSV8Engine::js_global_requestIdleCallback(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    BGJSV8Engine *ctx = BGJSV8Engine::GetInstance(args.GetIsolate());
+    v8::Isolate *isolate = args.GetIsolate();
+    HandleScope scope(isolate);
+
+    if (args.Length() >= 1 && args[0]->IsFunction()) {
+        uint64_t timeout = 0;
+
+        // optional options object: {timeout: ms}
+        if (args.Length() >= 2 && args[1]->IsObject()) {
+            Local<Context> context = isolate->GetCurrentContext();
+            Local<Value> timeoutRef;
+            if (!args[1].As<Object>()->Get(context, String::NewFromUtf8(isolate, "timeout")).ToLocal(&timeoutRef)) {
+                return;
+            }
+            double numberValue = timeoutRef->NumberValue(context).FromMaybe(0.0);
+            if (numberValue > 0) {
+                timeout = uv_hrtime() + (uint64_t)(numberValue * 1e6);
+            }
+        }
+
+        uint64_t id = ctx->enqueueTask(ctx->_idleTasks, args[0].As<v8::Function>(), timeout);
+        args.GetReturnValue().Set(v8::Number::New(isolate, (double)id));
+    } else {
+        ctx->getIsolate()->ThrowException(
+                v8::Exception::ReferenceError(
+                        v8::String::NewFromUtf8(ctx->getIsolate(), "callback must be a function")));
+    }
+}
+
+void BGJSV8Engine::js_global_cancelIdleCallback(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    BGJSV8Engine *ctx = BGJSV8Engine::GetInstance(args.GetIsolate());
+    ctx->cancelTask(ctx->_idleTasks, args);
+}
+
+void BGJSV8Engine::js_global_postTask(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    BGJSV8Engine *ctx = BGJSV8Engine::GetInstance(args.GetIsolate());
+    v8::Isolate *isolate = args.GetIsolate();
+    HandleScope scope(isolate);
+
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
+        ctx->getIsolate()->ThrowException(
+                v8::Exception::ReferenceError(
+                        v8::String::NewFromUtf8(ctx->getIsolate(), "callback must be a function")));
+        return;
+    }
+
+    // priority names follow the scheduler.postTask proposal
+    ETaskPriority priority = ETaskPriority::kUserVisible;
+    if (args.Length() >= 2 && !args[1]->IsUndefined()) {
+        v8::String::Utf8Value priorityStr(isolate, args[1]);
+        if (*priorityStr && !strcmp(*priorityStr, "user-blocking")) {
+            priority = ETaskPriority::kUserBlocking;
+        } else if (*priorityStr && !strcmp(*priorityStr, "background")) {
+            priority = ETaskPriority::kBackground;
+        } else if (!*priorityStr || strcmp(*priorityStr, "user-visible") != 0) {
+            isolate->ThrowException(
+                    v8::Exception::TypeError(
+                            v8::String::NewFromUtf8(isolate, "priority must be one of 'user-blocking', 'user-visible' or 'background'")));
+            return;
+        }
+    }
+
+    uint64_t id = ctx->postTask(args[0].As<v8::Function>(), priority);
+    args.GetReturnValue().Set(v8::Number::New(isolate, (double)id));
+}
+
+void BGJSV8Engine::js_global_cancelTask(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    BGJSV8Engine *ctx = BGJSV8Engine::GetInstance(args.GetIsolate());
+    // checked here so that the error is thrown once and not once per queue
+    if (args.Length() < 1) {
+        ctx->getIsolate()->ThrowException(
+                v8::Exception::ReferenceError(
+                        v8::String::NewFromUtf8(ctx->getIsolate(), "Wrong number of parameters")));
+        return;
+    }
+    // promotion can move a task to a different queue, so all of them have to be checked
+    for (auto &queue : ctx->_tasks) {
+        ctx->cancelTask(queue, args);
+    }
+}
+
+/**
+ * IdleDeadline.timeRemaining(): remaining time budget of the current idle period in ms
+ */
+void BGJSV8Engine::js_idleDeadline_timeRemaining(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    Local<Object> thisRef = args.This();
+    if (thisRef->InternalFieldCount() < 1) {
+        args.GetReturnValue().Set(0);
+        return;
+    }
+    double deadline = thisRef->GetInternalField(0)->NumberValue(args.GetIsolate()->GetCurrentContext()).FromMaybe(0.0);
+    double remaining = deadline - (double)uv_hrtime() / 1e6;
+    args.GetReturnValue().Set(remaining > 0 ? remaining : 0.0);
+}
+
+/**
+ * queue a callback for setImmediate, postTask or requestIdleCallback; arguments are passed to the callback when it runs
+ * can be called from any thread holding the locker; the event loop is woken up if the queue was empty
+ */
+uint64_t BGJSV8Engine::enqueueTask(std::vector<QueuedTaskHolder*> &queue, v8::Local<v8::Function> callback, uint64_t timeout,
+                                   v8::Local<v8::Array> arguments) {
+    auto *holder = new QueuedTaskHolder();
+    BGJS_RESET_PERSISTENT(_isolate, holder->callback, callback);
+    if (!arguments.IsEmpty()) {
+        BGJS_RESET_PERSISTENT(_isolate, holder->arguments, arguments);
+    }
+    holder->id = _nextTaskId++;
+    holder->cleared = false;
+    holder->timeout = timeout;
+    holder->queued = uv_hrtime();
+
+    queue.push_back(holder);
+    if (queue.size() == 1) {
+        uv_async_send(&_uvEventScheduleTasks);
+    }
+
+    return holder->id;
+}
+
+void BGJSV8Engine::cancelTask(std::vector<QueuedTaskHolder*> &queue, const v8::FunctionCallbackInfo<v8::Value> &args) {
+    if (args.Length() < 1) {
+        _isolate->ThrowException(
+                v8::Exception::ReferenceError(
+                        v8::String::NewFromUtf8(_isolate, "Wrong number of parameters")));
+        return;
+    }
+    double numberValue = args[0]->NumberValue(args.GetIsolate()->GetCurrentContext()).FromMaybe(FP_NAN);
+    if (std::isnan(numberValue)) {
+        return;
+    }
+    // holders are only marked here; they are removed from the queue by the event loop
+    auto id = (uint64_t)numberValue;
+    for (auto holder : queue) {
+        if (holder->id == id) {
+            holder->cleared = true;
+            break;
+        }
+    }
+}
+
+uint64_t BGJSV8Engine::postTask(v8::Local<v8::Function> callback, ETaskPriority priority) {
+    return enqueueTask(_tasks[(int)priority], callback, 0);
+}
+
+/**
+ * runs a queued callback; the caller must hold the isolate locker
+ */
+void BGJSV8Engine::runTask(QueuedTaskHolder *holder) {
+    v8::Isolate::Scope isolateScope(_isolate);
+    v8::HandleScope scope(_isolate);
+    v8::Local<v8::Context> context = getContext();
+    v8::Context::Scope ctxScope(context);
+    v8::MicrotasksScope taskScope(_isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::TryCatch try_catch(_isolate);
+
+    std::vector<v8::Local<v8::Value>> args;
+    if (!holder->arguments.IsEmpty()) {
+        v8::Local<v8::Array> argumentsRef = v8::Local<v8::Array>::New(_isolate, holder->arguments);
+        args.resize(argumentsRef->Length());
+        for (uint32_t i = 0; i < args.size(); i++) {
+            args[i] = argumentsRef->Get(context, i).ToLocalChecked();
+        }
+    }
+
+    v8::Local<v8::Function> funcRef = v8::Local<v8::Function>::New(_isolate, holder->callback);
+    if (funcRef->Call(context, context->Global(), (int)args.size(), args.data()).IsEmpty()) {
+        forwardV8ExceptionToJNI(&try_catch, true);
+    }
+}
+
+/**
+ * moves tasks that waited for longer than TASK_STARVATION_LIMIT to the next higher priority class
+ * queues are ordered by the time the tasks were added, so only the front has to be checked
+ */
+void BGJSV8Engine::promoteStarvingTasks(uint64_t now) {
+    uint64_t limit = (uint64_t)TASK_STARVATION_LIMIT * 1000000;
+    for (int priority = 1; priority < kTaskPriorityCount; priority++) {
+        auto &queue = _tasks[priority];
+        auto it = queue.begin();
+        while (it != queue.end() && now - (*it)->queued > limit) {
+            (*it)->queued = now;
+            _tasks[priority - 1].push_back(*it);
+            ++it;
+        }
+        queue.erase(queue.begin(), it);
+    }
+}
+
+/**
+ * returns true if there are immediates or tasks that have to run in the next loop iteration
+ */
+bool BGJSV8Engine::hasPendingTasks() const {
+    if (!_immediates.empty()) return true;
+    for (auto &queue : _tasks) {
+        if (!queue.empty()) return true;
+    }
+    return false;
+}
+
+/**
+ * an active idle handle prevents the event loop from blocking; only keep it running while there is work left
+ */
+void BGJSV8Engine::updateIdleHandle() {
+    if (hasPendingTasks() || !_idleTasks.empty()) {
+        uv_idle_start(&_uvIdle, &BGJSV8Engine::OnIdleCallback);
+    } else {
+        uv_idle_stop(&_uvIdle);
+    }
+}
+
+/**
+ * triggered when the first immediate, task or idle callback was queued
+ * starts the check/prepare handles that process the queues; they are stopped again once the queues are empty
+ */
+void BGJSV8Engine::OnTaskEventCallback(uv_async_t * handle) {
+    auto *engine = (BGJSV8Engine*)handle->data;
+
+    v8::Locker l(engine->getIsolate());
+
+    if (!engine->_immediates.empty()) {
+        uv_check_start(&engine->_uvCheckImmediates, &BGJSV8Engine::OnCheckImmediatesCallback);
+    }
+    for (auto &queue : engine->_tasks) {
+        if (!queue.empty()) {
+            uv_check_start(&engine->_uvCheckTasks, &BGJSV8Engine::OnCheckTasksCallback);
+            break;
+        }
+    }
+    if (!engine->_idleTasks.empty()) {
+        uv_prepare_start(&engine->_uvPrepareIdleTasks, &BGJSV8Engine::OnPrepareIdleTasksCallback);
+    }
+    // make sure the loop does not block before the queued callbacks had a chance to run
+    engine->updateIdleHandle();
+}
+
+/**
+ * queue work for the event loop; does not take the locker so that foreign threads never wait for running js
+ * the event loop is woken up if the queue was empty, later work is picked up by the same wakeup
+ */
+bool BGJSV8Engine::enqueueLoopWork(ELoopWorkType type, jobject target, jobject value) {
+    JNIEnv *env = JNIWrapper::getEnvironment();
+
+    LoopWorkHolder holder;
+    holder.type = type;
+    holder.valueType = ELoopValueType::kObject;
+    holder.object = nullptr;
+
+    // read primitive values here, so that the loop only has to create the v8 value and no global reference is needed
+    if (type != ELoopWorkType::kRunnable && value) {
+        if (env->IsInstanceOf(value, _jniNumber.clazz)) {
+            holder.valueType = ELoopValueType::kNumber;
+            holder.number = env->CallDoubleMethod(value, _jniNumber.doubleValueId);
+        } else if (env->IsInstanceOf(value, _jniBoolean.clazz)) {
+            holder.valueType = ELoopValueType::kBoolean;
+            holder.boolean = env->CallBooleanMethod(value, _jniBoolean.booleanValueId);
+        } else if (env->IsInstanceOf(value, _jniString.clazz)) {
+            holder.valueType = ELoopValueType::kString;
+            auto string = (jstring)value;
+            const jchar *chars = env->GetStringChars(string, nullptr);
+            holder.string.assign((const char16_t*)chars, (size_t)env->GetStringLength(string));
+            env->ReleaseStringChars(string, chars);
+        }
+    }
+
+    uv_mutex_lock(&_uvMutexLoopWork);
+    if (_loopWorkClosed) {
+        uv_mutex_unlock(&_uvMutexLoopWork);
+        return false;
+    }
+    holder.target = BGJS_NEW_GLOBAL_REF(env, target);
+    if (holder.valueType == ELoopValueType::kObject && value) {
+        holder.object = BGJS_NEW_GLOBAL_REF(env, value);
+    }
+    _pendingLoopWork.push_back(std::move(holder));
+    bool wakeUp = _pendingLoopWork.size() == 1;
+    uv_mutex_unlock(&_uvMutexLoopWork);
+
+    if (wakeUp) {
+        uv_async_send(&_uvEventLoopWork);
+    }
+    return true;
+}
+
+/**
+ * applies all queued promise settlements and runnables under a single lock
+ * microtasks triggered by them run once after all of them were applied
+ */
+void BGJSV8Engine::OnLoopWorkCallback(uv_async_t * handle) {
+    auto *engine = (BGJSV8Engine*)handle->data;
+    JNIEnv *env = JNIWrapper::getEnvironment();
+
+    std::vector<LoopWorkHolder> work;
+    uv_mutex_lock(&engine->_uvMutexLoopWork);
+    work.swap(engine->_pendingLoopWork);
+    uv_mutex_unlock(&engine->_uvMutexLoopWork);
+
+    if (work.empty()) {
+        return;
+    }
+
+    v8::Isolate *isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = engine->getContext();
+    v8::Context::Scope ctxScope(context);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+
+    for (auto &holder : work) {
+        v8::HandleScope workScope(isolate);
+        v8::TryCatch try_catch(isolate);
+
+        switch (holder.type) {
+            case ELoopWorkType::kRunnable: {
+                // the loop thread never returns to java, so local references created by the runnable have to be released here
+                JNILocalFrame localFrame(env, 16);
+                env->CallVoidMethod(holder.target, _jniRunnable.runId);
+                if (env->ExceptionCheck()) {
+                    jthrowable e = env->ExceptionOccurred();
+                    env->ExceptionClear();
+                    if (!env->IsInstanceOf(e, _jniRuntimeException.clazz)) {
+                        e = (jthrowable)env->NewObject(_jniRuntimeException.clazz, _jniRuntimeException.initId, e);
+                    }
+                    env->CallVoidMethod(engine->getBorrowedJObject(), _jniV8Engine.onThrowId, e);
+                }
+                break;
+            }
+            case ELoopWorkType::kResolve:
+            case ELoopWorkType::kReject: {
+                auto resolver = JNIWrapper::wrapObject<JNIV8Object>(holder.target);
+                // the resolver might have been disposed in the meantime
+                if (!resolver) break;
+
+                v8::Local<v8::Value> valueRef;
+                switch (holder.valueType) {
+                    case ELoopValueType::kNumber:
+                        valueRef = v8::Number::New(isolate, holder.number);
+                        break;
+                    case ELoopValueType::kBoolean:
+                        valueRef = v8::Boolean::New(isolate, holder.boolean);
+                        break;
+                    case ELoopValueType::kString: {
+                        v8::MaybeLocal<v8::String> maybeString = v8::String::NewFromTwoByte(isolate, (const uint16_t*)holder.string.data(),
+                                                                                             v8::NewStringType::kNormal, (int)holder.string.length());
+                        if (!maybeString.ToLocal(&valueRef)) {
+                            valueRef = v8::Undefined(isolate);
+                        }
+                        break;
+                    }
+                    case ELoopValueType::kObject:
+                        valueRef = JNIV8Marshalling::jobject2v8value(holder.object);
+                        break;
+                }
+
+                v8::Local<v8::Promise::Resolver> resolverRef = resolver->getJSObject().As<v8::Promise::Resolver>();
+                auto result = holder.type == ELoopWorkType::kReject ? resolverRef->Reject(context, valueRef) : resolverRef->Resolve(context, valueRef);
+                if (result.IsNothing()) {
+                    engine->forwardV8ExceptionToJNI(&try_catch, true);
+                }
+                break;
+            }
+        }
+
+        BGJS_DELETE_GLOBAL_REF(env, holder.target);
+        BGJS_DELETE_GLOBAL_REF(env, holder.object);
+    }
+}
+
+/**
+ * an active idle handle prevents the event loop from blocking while there is pending work
+ */
+void BGJSV8Engine::OnIdleCallback(uv_idle_t * handle) {
+}
+
+/**
+ * runs all immediates that were queued before the current loop iteration
+ * immediates queued by these callbacks will run in the next iteration
+ */
+void BGJSV8Engine::OnCheckImmediatesCallback(uv_check_t * handle) {
+    auto *engine = (BGJSV8Engine*)handle->data;
+
+    v8::Locker l(engine->getIsolate());
+
+    size_t n = engine->_immediates.size();
+    for (size_t i = 0; i < n; i++) {
+        auto holder = engine->_immediates.at(i);
+        if (holder->cleared) continue;
+        holder->cleared = true;
+        engine->runTask(holder);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        auto holder = engine->_immediates.at(i);
+        BGJS_CLEAR_PERSISTENT(holder->callback);
+        BGJS_CLEAR_PERSISTENT(holder->arguments);
+        delete holder;
+    }
+    engine->_immediates.erase(engine->_immediates.begin(), engine->_immediates.begin() + n);
+
+    if (engine->_immediates.empty()) {
+        uv_check_stop(&engine->_uvCheckImmediates);
+    }
+    engine->updateIdleHandle();
+}
+
+/**
+ * runs prioritized tasks: all user-blocking tasks first, then user-visible and background tasks
+ * until the time slice is used up or a more urgent task was posted
+ * the locker is only held per task, so that other threads can post urgent work in between
+ */
+void BGJSV8Engine::OnCheckTasksCallback(uv_check_t * handle) {
+    auto *engine = (BGJSV8Engine*)handle->data;
+    v8::Isolate *isolate = engine->getIsolate();
+
+    uint64_t now = uv_hrtime();
+    uint64_t deadline = now + (uint64_t)TASK_TIME_SLICE * 1000000;
+    bool didRunTask = false;
+
+    {
+        v8::Locker l(isolate);
+        engine->promoteStarvingTasks(now);
+    }
+
+    for (int priority = 0; priority < kTaskPriorityCount; priority++) {
+        auto &queue = engine->_tasks[priority];
+        size_t i, n;
+
+        // only run tasks that were posted before this point; tasks are only ever removed on this thread
+        {
+            v8::Locker l(isolate);
+            n = queue.size();
+        }
+
+        for (i = 0; i < n; i++) {
+            v8::Locker l(isolate);
+            // at least one task is run per iteration, so the loop always makes progress
+            if (priority != (int)ETaskPriority::kUserBlocking && didRunTask &&
+                (uv_hrtime() >= deadline || !engine->_tasks[(int)ETaskPriority::kUserBlocking].empty())) {
+                break;
+            }
+            auto holder = queue.at(i);
+            if (holder->cleared) continue;
+            holder->cleared = true;
+            engine->runTask(holder);
+            didRunTask = true;
+        }
+
+        {
+            v8::Locker l(isolate);
+            for (size_t j = 0; j < i; j++) {
+                BGJS_CLEAR_PERSISTENT(queue.at(j)->callback);
+                delete queue.at(j);
+            }
+            queue.erase(queue.begin(), queue.begin() + i);
+        }
+
+        // yielded; remaining tasks run in the next iteration
+        if (i < n) break;
+    }
+
+    v8::Locker l(isolate);
+    bool hasTasks = false;
+    for (auto &queue : engine->_tasks) {
+        hasTasks |= !queue.empty();
+    }
+    if (!hasTasks) {
+        uv_check_stop(&engine->_uvCheckTasks);
+    }
+    engine->updateIdleHandle();
+}
+
+/**
+ * runs idle callbacks right before the event loop would block
+ * the time budget is limited by the next timer that is due and MAX_IDLE_DEADLINE
+ * callbacks whose timeout expired run even if there is no time left
+ */
+void BGJSV8Engine::OnPrepareIdleTasksCallback(uv_prepare_t * handle) {
+    auto *engine = (BGJSV8Engine*)handle->data;
+
+    v8::Isolate *isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+
+    // the loop is not idle if there are still immediates or tasks pending
+    if (engine->hasPendingTasks()) return;
+
+    // our own idle handle would cause the backend timeout to be 0
+    uv_idle_stop(&engine->_uvIdle);
+    int timeout = uv_backend_timeout(&engine->_uvLoop);
+    if (timeout < 0 || timeout > MAX_IDLE_DEADLINE) {
+        timeout = MAX_IDLE_DEADLINE;
+    }
+    uint64_t deadline = uv_hrtime() + (uint64_t)timeout * 1000000;
+
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = engine->getContext();
+    v8::Context::Scope ctxScope(context);
+    v8::Local<v8::ObjectTemplate> deadlineTpl = v8::Local<v8::ObjectTemplate>::New(isolate, engine->_idleDeadlineTpl);
+    v8::Local<v8::String> didTimeoutRef = String::NewFromUtf8(isolate, "didTimeout");
+
+    size_t n = engine->_idleTasks.size();
+    for (size_t i = 0; i < n; i++) {
+        auto holder = engine->_idleTasks.at(i);
+        if (holder->cleared) continue;
+
+        uint64_t now = uv_hrtime();
+        bool didTimeout = holder->timeout && holder->timeout <= now;
+        if (now >= deadline && !didTimeout) continue;
+        holder->cleared = true;
+
+        v8::HandleScope callbackScope(isolate);
+        v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+        v8::TryCatch try_catch(isolate);
+
+        v8::Local<v8::Object> deadlineRef = deadlineTpl->NewInstance(context).ToLocalChecked();
+        deadlineRef->SetInternalField(0, v8::Number::New(isolate, didTimeout ? 0.0 : (double)deadline / 1e6));
+        deadlineRef->Set(context, didTimeoutRef, v8::Boolean::New(isolate, didTimeout)).FromJust();
+
+        v8::Local<v8::Value> args[] = {deadlineRef};
+        v8::Local<v8::Function> funcRef = v8::Local<v8::Function>::New(isolate, holder->callback);
+        if (funcRef->Call(context, context->Global(), 1, args).IsEmpty()) {
+            engine->forwardV8ExceptionToJNI(&try_catch, true);
+        }
+    }
+
+    // remove all callbacks that were executed or cancelled; this includes callbacks queued while running the loop above
+    auto it = engine->_idleTasks.begin();
+    while (it != engine->_idleTasks.end()) {
+        if ((*it)->cleared) {
+            BGJS_CLEAR_PERSISTENT((*it)->callback);
+            delete *it;
+            it = engine->_idleTasks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (engine->_idleTasks.empty()) {
+        uv_prepare_stop(&engine->_uvPrepareIdleTasks);
+    }
+    // callbacks that did not fit into this idle period run in the next one
+    engine->updateIdleHandle();
+}
+
 /**
  * cache JNI class references
  */
@@ -1054,6 +1724,18 @@ void BGJSV8Engine::initJNICache() {
     _jniStackTraceElement.clazz = (jclass) env->NewGlobalRef(env->FindClass("java/lang/StackTraceElement"));
     _jniStackTraceElement.initId = env->GetMethodID(_jniStackTraceElement.clazz, "<init>",
                                                     "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;I)V");
+    _jniRunnable.clazz = (jclass) env->NewGlobalRef(env->FindClass("java/lang/Runnable"));
+    _jniRunnable.runId = env->GetMethodID(_jniRunnable.clazz, "run", "()V");
+
+    _jniNumber.clazz = (jclass) env->NewGlobalRef(env->FindClass("java/lang/Number"));
+    _jniNumber.doubleValueId = env->GetMethodID(_jniNumber.clazz, "doubleValue", "()D");
+    _jniBoolean.clazz = (jclass) env->NewGlobalRef(env->FindClass("java/lang/Boolean"));
+    _jniBoolean.booleanValueId = env->GetMethodID(_jniBoolean.clazz, "booleanValue", "()Z");
+    _jniString.clazz = (jclass) env->NewGlobalRef(env->FindClass("java/lang/String"));
+
+    _jniRuntimeException.clazz = (jclass) env->NewGlobalRef(env->FindClass("java/lang/RuntimeException"));
+    _jniRuntimeException.initId = env->GetMethodID(_jniRuntimeException.clazz, "<init>", "(Ljava/lang/Throwable;)V");
+
     _jniV8Engine.clazz = (jclass) env->NewGlobalRef(env->FindClass("ag/boersego/bgjs/V8Engine"));
     _jniV8Engine.onReadyId = env->GetMethodID(_jniV8Engine.clazz, "onReady", "()V");
     _jniV8Engine.onThrowId = env->GetMethodID(_jniV8Engine.clazz, "onThrow", "(Ljava/lang/RuntimeException;)V");
@@ -1063,6 +1745,8 @@ void BGJSV8Engine::initJNICache() {
 
 BGJSV8Engine::BGJSV8Engine(jobject obj, JNIClassInfo *info) : JNIObject(obj, info) {
     _nextTimerId = 1;
+    _timerSlack = 0;
+    _nextTaskId = 1;
     _nextEmbedderDataIndex = EBGJSV8EngineEmbedderData::FIRST_UNUSED;
     _javaAssetManager = nullptr;
     _isolate = nullptr;
@@ -1083,8 +1767,26 @@ BGJSV8Engine::BGJSV8Engine(jobject obj, JNIClassInfo *info) : JNIObject(obj, inf
     uv_async_init(&_uvLoop, &_uvEventSuspend, &BGJSV8Engine::SuspendLoopThread);
     _uvEventSuspend.data = this;
 
+    uv_async_init(&_uvLoop, &_uvEventScheduleTasks, &BGJSV8Engine::OnTaskEventCallback);
+    _uvEventScheduleTasks.data = this;
+
+    uv_async_init(&_uvLoop, &_uvEventLoopWork, &BGJSV8Engine::OnLoopWorkCallback);
+    _uvEventLoopWork.data = this;
+
+    // handles for setImmediate, postTask & requestIdleCallback; only started while there are queued callbacks
+    uv_check_init(&_uvLoop, &_uvCheckImmediates);
+    _uvCheckImmediates.data = this;
+    uv_check_init(&_uvLoop, &_uvCheckTasks);
+    _uvCheckTasks.data = this;
+    uv_prepare_init(&_uvLoop, &_uvPrepareIdleTasks);
+    _uvPrepareIdleTasks.data = this;
+    uv_idle_init(&_uvLoop, &_uvIdle);
+    _uvIdle.data = this;
+
     uv_mutex_init(&_uvMutex);
     uv_cond_init(&_uvCondSuspend);
+    uv_mutex_init(&_uvMutexLoopWork);
+    _loopWorkClosed = false;
 
 }
 
@@ -1096,9 +1798,12 @@ void BGJSV8Engine::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
     info->registerNativeMethod("initialize", "(Landroid/content/res/AssetManager;Ljava/lang/String;I)V", (void*)BGJSV8Engine::jniInitialize);
     info->registerNativeMethod("pause", "()V", (void*)BGJSV8Engine::jniPause);
     info->registerNativeMethod("unpause", "()V", (void*)BGJSV8Engine::jniUnpause);
+    info->registerNativeMethod("setTimerSlack", "(I)V", (void*)BGJSV8Engine::jniSetTimerSlack);
     info->registerNativeMethod("shutdown", "()V", (void*)BGJSV8Engine::jniShutdown);
     info->registerNativeMethod("dumpHeap", "(Ljava/lang/String;)Ljava/lang/String;", (void*)BGJSV8Engine::jniDumpHeap);
     info->registerNativeMethod("enqueueOnNextTick", "(Lag/boersego/bgjs/JNIV8Function;)V", (void*)BGJSV8Engine::jniEnqueueOnNextTick);
+    info->registerNativeMethod("enqueueTask", "(Lag/boersego/bgjs/JNIV8Function;I)V", (void*)BGJSV8Engine::jniEnqueueTask);
+    info->registerNativeMethod("post", "(Ljava/lang/Runnable;)V", (void*)BGJSV8Engine::jniPost);
     info->registerNativeMethod("parseJSON", "(Ljava/lang/String;)Ljava/lang/Object;", (void*)BGJSV8Engine::jniParseJSON);
     info->registerNativeMethod("require", "(Ljava/lang/String;)Ljava/lang/Object;", (void*)BGJSV8Engine::jniRequire);
     info->registerNativeMethod("lock", "()J", (void*)BGJSV8Engine::jniLock);
@@ -1107,6 +1812,8 @@ void BGJSV8Engine::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
     info->registerNativeMethod("runScript", "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/Object;", (void*)BGJSV8Engine::jniRunScript);
     info->registerNativeMethod("registerModuleNative", "(Lag/boersego/bgjs/JNIV8Module;)V", (void*)BGJSV8Engine::jniRegisterModuleNative);
     info->registerNativeMethod("getConstructor", "(Ljava/lang/String;)Lag/boersego/bgjs/JNIV8Function;", (void*)BGJSV8Engine::jniGetConstructor);
+    info->registerNativeMethod("setHandleTracking", "(ZZ)V", (void*)BGJSV8Engine::jniSetHandleTracking);
+    info->registerNativeMethod("dumpHandles", "()Ljava/lang/String;", (void*)BGJSV8Engine::jniDumpHandles);
 }
 
 void BGJSV8Engine::createContext() {
@@ -1186,6 +1893,35 @@ void BGJSV8Engine::createContext() {
     globalObjTpl->Set(String::NewFromUtf8(_isolate, "clearInterval"),
                       v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_global_clearTimeoutOrInterval, Local<Value>(),
                                                 Local<Signature>(), 0, ConstructorBehavior::kThrow));
+    globalObjTpl->Set(String::NewFromUtf8(_isolate, "setImmediate"),
+                      v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_global_setImmediate, Local<Value>(),
+                                                Local<Signature>(), 0, ConstructorBehavior::kThrow));
+    globalObjTpl->Set(String::NewFromUtf8(_isolate, "clearImmediate"),
+                      v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_global_clearImmediate, Local<Value>(),
+                                                Local<Signature>(), 0, ConstructorBehavior::kThrow));
+    globalObjTpl->Set(String::NewFromUtf8(_isolate, "requestIdleCallback"),
+                      v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_global_requestIdleCallback, Local<Value>(),
+                                                Local<Signature>(), 0, ConstructorBehavior::kThrow));
+    globalObjTpl->Set(String::NewFromUtf8(_isolate, "cancelIdleCallback"),
+                      v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_global_cancelIdleCallback, Local<Value>(),
+                                                Local<Signature>(), 0, ConstructorBehavior::kThrow));
+
+    globalObjTpl->Set(String::NewFromUtf8(_isolate, "postTask"),
+                      v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_global_postTask, Local<Value>(),
+                                                Local<Signature>(), 0, ConstructorBehavior::kThrow));
+    globalObjTpl->Set(String::NewFromUtf8(_isolate, "cancelTask"),
+                      v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_global_cancelTask, Local<Value>(),
+                                                Local<Signature>(), 0, ConstructorBehavior::kThrow));
+
+    // template for the IdleDeadline objects passed to idle callbacks; the internal field stores the deadline
+    v8::Local<v8::ObjectTemplate> idleDeadlineTpl = v8::ObjectTemplate::New(_isolate);
+    idleDeadlineTpl->SetInternalFieldCount(1);
+    idleDeadlineTpl->Set(String::NewFromUtf8(_isolate, "timeRemaining"),
+                         v8::FunctionTemplate::New(_isolate, BGJSV8Engine::js_idleDeadline_timeRemaining, Local<Value>(),
+                                                   Local<Signature>(), 0, ConstructorBehavior::kThrow));
+    _idleDeadlineTpl.Reset(_isolate, idleDeadlineTpl);
+
+    _wrapperPeerKey.Reset(_isolate, v8::Private::New(_isolate, String::NewFromUtf8(_isolate, "JNIV8WrapperPeer")));
 
     // Create a new context.
     Local<Context> context = v8::Context::New(_isolate, nullptr, globalObjTpl);
@@ -1367,12 +2103,12 @@ void BGJSV8Engine::StartLoopThread(void *arg) {
     engine->_state = EState::kStarted;
 
     JNIEnv* env = JNIWrapper::getEnvironment();
-    env->CallVoidMethod(engine->getJObject(), engine->_jniV8Engine.onReadyId);
+    env->CallVoidMethod(engine->getBorrowedJObject(), engine->_jniV8Engine.onReadyId);
     if(env->ExceptionCheck()) {
         LOGD("BGJSV8Engine: transitioning to ready state [FAILED]");
         jthrowable e = env->ExceptionOccurred();
         env->ExceptionClear();
-        env->CallVoidMethod(engine->getJObject(), _jniV8Engine.onThrowId, e);
+        env->CallVoidMethod(engine->getBorrowedJObject(), _jniV8Engine.onThrowId, e);
         return;
     }
 
@@ -1380,7 +2116,15 @@ void BGJSV8Engine::StartLoopThread(void *arg) {
 
     uv_run(&engine->_uvLoop, UV_RUN_DEFAULT);
 
+    // nothing would ever pick up work posted from now on
+    uv_mutex_lock(&engine->_uvMutexLoopWork);
+    engine->_loopWorkClosed = true;
+    uv_mutex_unlock(&engine->_uvMutexLoopWork);
+
     engine->_state = EState::kStopped;
+
+    // make sure console output of this engine is not lost
+    BGJSLogSink::getInstance()->flush();
     LOG(LOG_INFO, "BGJSV8Engine: EventLoop ended");
 }
 
@@ -1405,11 +2149,11 @@ void BGJSV8Engine::SuspendLoopThread(uv_async_t *handle) {
 
             // because `pause`/`unpause` could be called from code executed by the OnSuspend handler
             // we have to run this WITHOUT holding the mutex
-            env->CallVoidMethod(engine->getJObject(), _jniV8Engine.onSuspendId);
+            env->CallVoidMethod(engine->getBorrowedJObject(), _jniV8Engine.onSuspendId);
             if(env->ExceptionCheck()) {
                 jthrowable e = env->ExceptionOccurred();
                 env->ExceptionClear();
-                env->CallVoidMethod(engine->getJObject(), _jniV8Engine.onThrowId, e);
+                env->CallVoidMethod(engine->getBorrowedJObject(), _jniV8Engine.onThrowId, e);
                 return;
             }
 
@@ -1424,11 +2168,11 @@ void BGJSV8Engine::SuspendLoopThread(uv_async_t *handle) {
     // if suspend/resume are triggered in quick succession this method might have been called after the engine was already resumed again
     // if the event loop was actually suspended => run OnResume logic
     if(waiting) {
-        env->CallVoidMethod(engine->getJObject(), _jniV8Engine.onResumeId);
+        env->CallVoidMethod(engine->getBorrowedJObject(), _jniV8Engine.onResumeId);
         if(env->ExceptionCheck()) {
             jthrowable e = env->ExceptionOccurred();
             env->ExceptionClear();
-            env->CallVoidMethod(engine->getJObject(), _jniV8Engine.onThrowId, e);
+            env->CallVoidMethod(engine->getBorrowedJObject(), _jniV8Engine.onThrowId, e);
             return;
         }
         LOG(LOG_INFO, "BGJSV8Engine: EventLoop resumed");
@@ -1456,6 +2200,7 @@ void BGJSV8Engine::OnTaskMicrotask(void *data) {
         engine->forwardV8ExceptionToJNI(&try_catch, true);
     }
 
+    BGJS_CLEAR_PERSISTENT(holder->callback);
     delete holder;
 }
 
@@ -1502,8 +2247,8 @@ void BGJSV8Engine::OnPromiseRejectionMicrotask(void *data) {
                 LOG(LOG_ERROR, "Unhandled rejected promise: %s", engine->toDebugString(exception).c_str());
             }
         }
-        holder->value.Reset();
-        holder->promise.Reset();
+        BGJS_CLEAR_PERSISTENT(holder->value);
+        BGJS_CLEAR_PERSISTENT(holder->promise);
         delete holder;
     }
     engine->_unhandledRejectedPromises.clear();
@@ -1520,10 +2265,10 @@ void BGJSV8Engine::PromiseRejectionHandler(v8::PromiseRejectMessage message) {
     if(message.GetEvent() == kPromiseRejectWithNoHandler) {
         // add promise to list
         auto holder = new RejectedPromiseHolder();
-        holder->promise.Reset(isolate, message.GetPromise());
+        BGJS_RESET_PERSISTENT(isolate, holder->promise, message.GetPromise());
         holder->promise.SetWeak((void *) holder, RejectedPromiseHolderWeakPersistentCallback,
                                    v8::WeakCallbackType::kParameter);
-        holder->value.Reset(isolate, message.GetValue());
+        BGJS_RESET_PERSISTENT(isolate, holder->value, message.GetValue());
         holder->handled = false;
         holder->collected = false;
         engine->_unhandledRejectedPromises.push_back(holder);
@@ -1554,17 +2299,31 @@ void BGJSV8Engine::UncaughtExceptionHandler(v8::Local<v8::Message> message, v8::
     engine->forwardV8ExceptionToJNI("Uncaught exception: ", data, message, true);
 }
 
+void BGJSV8Engine::appendDebugString(std::string &target, Handle<Value> source) const {
+    // fast path for primitives; produces the same output as debugDump without calling into javascript
+    if (source->IsString() || !source->BooleanValue(_isolate)) {
+        target += '\'';
+        target += JNIV8Marshalling::v8string2string(source);
+        target += '\'';
+    } else if (source->IsNumber() || source->IsBoolean()) {
+        target += JNIV8Marshalling::v8string2string(source);
+    } else {
+        target += toDebugString(source);
+    }
+}
+
 void BGJSV8Engine::log(int debugLevel, const v8::FunctionCallbackInfo<v8::Value> &args) {
     v8::Locker locker(args.GetIsolate());
     HandleScope scope(args.GetIsolate());
 
-    std::stringstream str;
+    std::string message;
     int l = args.Length();
     for (int i = 0; i < l; i++) {
-        str << " " << toDebugString(args[i]);
+        message += ' ';
+        appendDebugString(message, args[i]);
     }
 
-    LOG(debugLevel, "%s", str.str().c_str());
+    BGJSLogSink::getInstance()->log(debugLevel, std::move(message));
 }
 
 char *BGJSV8Engine::loadFile(const char *path, unsigned int *length) const {
@@ -1601,6 +2360,12 @@ BGJSV8Engine::~BGJSV8Engine() {
     uv_loop_close(&_uvLoop);
     uv_close((uv_handle_t*)&_uvEventScheduleTimers, &BGJSV8Engine::OnHandleClosed);
     uv_close((uv_handle_t*)&_uvEventStop, &BGJSV8Engine::OnHandleClosed);
+    uv_close((uv_handle_t*)&_uvEventScheduleTasks, &BGJSV8Engine::OnHandleClosed);
+    uv_close((uv_handle_t*)&_uvEventLoopWork, &BGJSV8Engine::OnHandleClosed);
+    uv_close((uv_handle_t*)&_uvCheckImmediates, &BGJSV8Engine::OnHandleClosed);
+    uv_close((uv_handle_t*)&_uvCheckTasks, &BGJSV8Engine::OnHandleClosed);
+    uv_close((uv_handle_t*)&_uvPrepareIdleTasks, &BGJSV8Engine::OnHandleClosed);
+    uv_close((uv_handle_t*)&_uvIdle, &BGJSV8Engine::OnHandleClosed);
 
     JNIEnv *env = JNIWrapper::getEnvironment();
     env->DeleteGlobalRef(_javaAssetManager);
@@ -1613,36 +2378,71 @@ BGJSV8Engine::~BGJSV8Engine() {
     _jsonStringifyFn.Reset();
     _makeJavaErrorFn.Reset();
     _getStackTraceFn.Reset();
+    _idleDeadlineTpl.Reset();
+    _wrapperPeerKey.Reset();
+    _propertyNameCache.clear();
+    JNIV8ArrayBuffer::releaseExternalBuffers(this);
+
+    for (auto holder : _immediates) {
+        BGJS_CLEAR_PERSISTENT(holder->callback);
+        BGJS_CLEAR_PERSISTENT(holder->arguments);
+        delete holder;
+    }
+    for (auto holder : _idleTasks) {
+        BGJS_CLEAR_PERSISTENT(holder->callback);
+        delete holder;
+    }
+    for (auto &queue : _tasks) {
+        for (auto holder : queue) {
+            BGJS_CLEAR_PERSISTENT(holder->callback);
+            delete holder;
+        }
+    }
+    // work that was still queued when the loop ended is dropped; later posts were rejected
+    for (auto &holder : _pendingLoopWork) {
+        BGJS_DELETE_GLOBAL_REF(env, holder.target);
+        BGJS_DELETE_GLOBAL_REF(env, holder.object);
+    }
+    _pendingLoopWork.clear();
+    uv_mutex_destroy(&_uvMutexLoopWork);
 
     _isolate->Exit();
 
     for (auto &it : _javaModules) {
-        env->DeleteGlobalRef(it.second);
+        BGJS_DELETE_GLOBAL_REF(env, it.second);
     }
 
     JNIV8Wrapper::cleanupV8Engine(this);
 }
 
+/**
+ * collects the current javascript stack; the frames are only formatted on the log writer thread
+ */
+static std::vector<BGJSLogSink::Frame> CaptureStackFrames(v8::Isolate *isolate) {
+    Local<StackTrace> stackTrace = StackTrace::CurrentStackTrace(isolate, 15);
+    int l = stackTrace->GetFrameCount();
+    std::vector<BGJSLogSink::Frame> frames(l);
+    for (int i = 0; i < l; i++) {
+        const Local<StackFrame> &frame = stackTrace->GetFrame(isolate, i);
+        frames[i].script = JNIV8Marshalling::v8string2string(frame->GetScriptName());
+        frames[i].function = JNIV8Marshalling::v8string2string(frame->GetFunctionName());
+        frames[i].line = frame->GetLineNumber();
+    }
+    return frames;
+}
+
 void BGJSV8Engine::trace(const FunctionCallbackInfo<Value> &args) {
     v8::Locker locker(args.GetIsolate());
     HandleScope scope(args.GetIsolate());
 
-    std::stringstream str;
+    std::string message;
     int l = args.Length();
     for (int i = 0; i < l; i++) {
-        str << " " << toDebugString(args[i]);
-    }
-    str << "\n";
-
-    Local<StackTrace> stackTrace = StackTrace::CurrentStackTrace(args.GetIsolate(), 15);
-    l = stackTrace->GetFrameCount();
-    for (int i = 0; i < l; i++) {
-        const Local<StackFrame> &frame = stackTrace->GetFrame(args.GetIsolate(), i);
-        str << "    " << JNIV8Marshalling::v8string2string(frame->GetScriptName()) << " ("
-            << JNIV8Marshalling::v8string2string(frame->GetFunctionName()) << ":" << frame->GetLineNumber() << ")\n";
+        message += ' ';
+        appendDebugString(message, args[i]);
     }
 
-    LOG(LOG_INFO, "%s", str.str().c_str());
+    BGJSLogSink::getInstance()->log(LOG_INFO, std::move(message), CaptureStackFrames(args.GetIsolate()));
 }
 
 /**
@@ -1665,26 +2465,12 @@ void BGJSV8Engine::doAssert(const FunctionCallbackInfo<Value> &args) {
     Local<Boolean> assertion = args[0]->ToBoolean(isolate);
 
     if (!assertion->Value()) {
+        std::string assertionMessage = "Assertion failed";
         if (args.Length() > 1) {
-            const std::string assertionMessage = toDebugString(args[1]);
-            LOG(LOG_ERROR, "Assertion failed: %s", assertionMessage.c_str());
-        } else {
-            LOG(LOG_ERROR, "Assertion failed");
+            assertionMessage += ": ";
+            appendDebugString(assertionMessage, args[1]);
         }
-
-        std::stringstream str;
-
-        Local<StackTrace> stackTrace = StackTrace::CurrentStackTrace(args.GetIsolate(), 15);
-        int l = stackTrace->GetFrameCount();
-        for (int i = 0; i < l; i++) {
-            const Local<StackFrame> &frame = stackTrace->GetFrame(isolate, i);
-            str << "    " << JNIV8Marshalling::v8string2string(frame->GetScriptName()) << " ("
-                << JNIV8Marshalling::v8string2string(frame->GetFunctionName()) << ":" << frame->GetLineNumber()
-                << ")\n";
-        }
-
-        LOG(LOG_ERROR, "%s", str.str().c_str());
-
+        BGJSLogSink::getInstance()->log(LOG_ERROR, std::move(assertionMessage), CaptureStackFrames(isolate));
     }
 }
 
@@ -1795,6 +2581,11 @@ void BGJSV8Engine::jniUnpause(JNIEnv *env, jobject obj) {
     engine->unpause();
 }
 
+void BGJSV8Engine::jniSetTimerSlack(JNIEnv *env, jobject obj, jint slack) {
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(obj);
+    engine->setTimerSlack(slack > 0 ? (uint64_t)slack : 0);
+}
+
 void BGJSV8Engine::jniShutdown(JNIEnv *env, jobject obj) {
     auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(obj);
     engine->shutdown();
@@ -1816,6 +2607,14 @@ jstring BGJSV8Engine::jniDumpHeap(JNIEnv *env, jobject obj, jstring pathToSaveIn
     }
 }
 
+void BGJSV8Engine::jniSetHandleTracking(JNIEnv *env, jclass clazz, jboolean enabled, jboolean captureJSStack) {
+    BGJSHandleTracker::setEnabled(enabled, captureJSStack);
+}
+
+jstring BGJSV8Engine::jniDumpHandles(JNIEnv *env, jclass clazz) {
+    return JNIWrapper::string2jstring(BGJSHandleTracker::dump());
+}
+
 void BGJSV8Engine::jniEnqueueOnNextTick(JNIEnv *env, jobject obj, jobject function) {
     auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(obj);
     THROW_IF_NOT_STARTED();
@@ -1831,10 +2630,47 @@ void BGJSV8Engine::jniEnqueueOnNextTick(JNIEnv *env, jobject obj, jobject functi
     auto funcRef = JNIV8Wrapper::wrapObject<JNIV8Function>(function)->getJSObject().As<v8::Function>();
 
     TaskHolder *holder = new TaskHolder();
-    holder->callback.Reset(isolate, funcRef);
+    BGJS_RESET_PERSISTENT(isolate, holder->callback, funcRef);
     isolate->EnqueueMicrotask(&BGJSV8Engine::OnTaskMicrotask, (void*)holder);
 }
 
+void BGJSV8Engine::jniEnqueueTask(JNIEnv *env, jobject obj, jobject function, jint priority) {
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(obj);
+    THROW_IF_NOT_STARTED();
+
+    if (priority < 0 || priority >= kTaskPriorityCount) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Invalid task priority");
+        return;
+    }
+
+    if (!function) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "function must not be null");
+        return;
+    }
+
+    v8::Isolate *isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+
+    auto funcRef = JNIV8Wrapper::wrapObject<JNIV8Function>(function)->getJSObject().As<v8::Function>();
+    engine->postTask(funcRef, (ETaskPriority)priority);
+}
+
+void BGJSV8Engine::jniPost(JNIEnv *env, jobject obj, jobject runnable) {
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(obj);
+    // runnables posted before the engine has started are queued and run once the loop is running
+
+    if (!runnable) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "runnable must not be null");
+        return;
+    }
+
+    if (!engine->enqueueLoopWork(ELoopWorkType::kRunnable, runnable)) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalStateException"), "Engine has been stopped");
+    }
+}
+
 jobject BGJSV8Engine::jniParseJSON(JNIEnv *env, jobject obj, jstring json) {
     auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(obj);
     THROW_IF_NOT_STARTED();
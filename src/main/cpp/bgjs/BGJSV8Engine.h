@@ -13,6 +13,8 @@
 #include "os-android.h"
 
 #include "../jni/jni.h"
+#include "../v8/JNIV8PropertyNameCache.h"
+#include "../v8/JNIV8ClassInfoTable.h"
 
 /**
  * BGJSV8Engine
@@ -23,6 +25,7 @@
  */
 
 class BGJSGLView;
+struct JNIV8ArrayBufferHolder;
 
 typedef  void (*requireHook) (class BGJSV8Engine* engine, v8::Handle<v8::Object> target);
 
@@ -42,6 +45,26 @@ public:
 		kStopped
 	};
 
+	/**
+	 * priority classes for tasks posted to the event loop
+	 * must match the TASK_PRIORITY_* constants in V8Engine.java
+	 */
+	enum class ETaskPriority {
+		kUserBlocking = 0, // input handling & rendering
+		kUserVisible = 1,  // default
+		kBackground = 2
+	};
+	static const int kTaskPriorityCount = 3;
+
+	/**
+	 * work that other threads can queue for the event loop with enqueueLoopWork
+	 */
+	enum class ELoopWorkType {
+		kResolve,  // resolve a JNIV8Promise.Resolver with a java value
+		kReject,   // reject a JNIV8Promise.Resolver with a java value
+		kRunnable  // run a java Runnable
+	};
+
 	struct Options {
 		jobject assetManager;
 		const char *commonJSPath;
@@ -64,6 +87,27 @@ public:
 	v8::Isolate* getIsolate() const;
 	v8::Local<v8::Context> getContext() const;
 
+	/**
+	 * returns the cache of internalized property names used when accessing js objects from java
+	 */
+	JNIV8PropertyNameCache& getPropertyNameCache();
+
+	/**
+	 * returns the holders of ArrayBuffers using java memory that have not been garbage collected yet
+	 * they are released when the engine is destroyed, because weak callbacks do not run anymore after that
+	 */
+	std::set<JNIV8ArrayBufferHolder*>& getExternalArrayBuffers();
+
+	/**
+	 * returns the class infos that have been created for this engine, indexed by type id
+	 */
+	JNIV8ClassInfoTable& getClassInfoTable();
+
+	/**
+	 * returns the private key used to link js objects to the java peer of their wrapper
+	 */
+	v8::Local<v8::Private> getWrapperPeerKey() const;
+
 	bool forwardJNIExceptionToV8() const;
 	bool forwardV8ExceptionToJNI(v8::TryCatch* try_catch, bool throwOnMainThread = true) const;
 
@@ -73,6 +117,12 @@ public:
 	static void js_global_setTimeout (const v8::FunctionCallbackInfo<v8::Value>& info);
 	static void js_global_clearTimeoutOrInterval (const v8::FunctionCallbackInfo<v8::Value>& info);
 	static void js_global_setInterval (const v8::FunctionCallbackInfo<v8::Value>& info);
+	static void js_global_setImmediate (const v8::FunctionCallbackInfo<v8::Value>& info);
+	static void js_global_clearImmediate (const v8::FunctionCallbackInfo<v8::Value>& info);
+	static void js_global_requestIdleCallback (const v8::FunctionCallbackInfo<v8::Value>& info);
+	static void js_global_cancelIdleCallback (const v8::FunctionCallbackInfo<v8::Value>& info);
+	static void js_global_postTask (const v8::FunctionCallbackInfo<v8::Value>& info);
+	static void js_global_cancelTask (const v8::FunctionCallbackInfo<v8::Value>& info);
 
 	v8::MaybeLocal<v8::Value> parseJSON(v8::Handle<v8::String> source) const;
 	v8::MaybeLocal<v8::Value> stringifyJSON(v8::Handle<v8::Object> source, bool pretty = false) const;
@@ -91,6 +141,30 @@ public:
 	void pause();
 	void unpause();
 
+	/**
+	 * timers due within the specified window (in ms) are aligned to fire together
+	 * a slack of 0 disables coalescing
+	 */
+	void setTimerSlack(uint64_t slack);
+
+	/**
+	 * schedule a callback to be run on the event loop with the specified priority
+	 * more urgent tasks always run first; lower priority tasks only run while the time slice of the current
+	 * loop iteration is not used up, and are promoted if they had to wait for too long
+	 * the caller must hold the isolate locker
+	 */
+	uint64_t postTask(v8::Local<v8::Function> callback, ETaskPriority priority);
+
+	/**
+	 * queue work for the event loop; can be called from any thread without holding the locker
+	 * the queue is a vector guarded by a mutex that is only held to push or swap it out, so callers never wait for running js
+	 * everything queued until the loop wakes up is applied under a single lock in posting order, followed by one microtask checkpoint
+	 * target is the JNIV8Promise.Resolver for settlements and the Runnable otherwise; numbers, booleans and strings passed as
+	 * value are read on the calling thread, other values are retained and converted on the loop
+	 * returns false without queueing anything once the event loop has ended
+	 */
+	bool enqueueLoopWork(ELoopWorkType type, jobject target, jobject value = nullptr);
+
     // @TODO: make private after moving java methods inside class
     void shutdown();
 
@@ -104,10 +178,37 @@ private:
 		bool handled, collected;
 	};
 
+	// representation of a settlement value that was read on the posting thread
+	enum class ELoopValueType {
+		kObject, // converted on the loop; also used for null
+		kBoolean,
+		kNumber,
+		kString
+	};
+
+	struct LoopWorkHolder {
+		ELoopWorkType type;
+		jobject target;
+		ELoopValueType valueType;
+		jobject object;
+		double number;
+		bool boolean;
+		std::u16string string;
+	};
+
 	struct TaskHolder {
 	    v8::Persistent<v8::Function> callback;
 	};
 
+	struct QueuedTaskHolder {
+		uint64_t id;
+		bool cleared;
+		uint64_t timeout; // absolute time (uv_hrtime) at which an idle callback has to run; 0 if it does not time out
+		uint64_t queued; // time (uv_hrtime) at which the task was added to its current queue
+		v8::Persistent<v8::Function> callback;
+		v8::Persistent<v8::Array> arguments; // extra arguments passed to setImmediate; empty for all other tasks
+	};
+
 	struct TimerHolder {
 		uv_timer_t handle;
 		bool scheduled, cleared, stopped, repeats;
@@ -117,10 +218,14 @@ private:
 	};
 
 	uint64_t createTimer(v8::Local<v8::Function> callback, uint64_t delay, uint64_t repeat);
+	uint64_t getTimerSlack();
+	void startTimer(TimerHolder *holder, uint64_t delay);
 	bool forwardV8ExceptionToJNI(std::string messagePrefix, v8::Local<v8::Value> exception, v8::Local<v8::Message> message, bool throwOnMainThread = false) const;
 
 	// utility method to convert v8 values to readable strings for debugging
 	const std::string toDebugString(v8::Handle<v8::Value> source) const;
+	// appends the debug string of the specified value to target; avoids calling into javascript for primitives
+	void appendDebugString(std::string &target, v8::Handle<v8::Value> source) const;
 
 	// called by JNIWrapper
 	static void initializeJNIBindings(JNIClassInfo *info, bool isReload);
@@ -143,6 +248,21 @@ private:
     static void OnTimerTriggeredCallback(uv_timer_t * handle);
 	static void OnTimerClosedCallback(uv_handle_t * handle);
 	static void OnTimerEventCallback(uv_async_t * handle);
+	static void OnTaskEventCallback(uv_async_t * handle);
+	static void OnLoopWorkCallback(uv_async_t * handle);
+	static void OnCheckImmediatesCallback(uv_check_t * handle);
+	static void OnPrepareIdleTasksCallback(uv_prepare_t * handle);
+	static void OnCheckTasksCallback(uv_check_t * handle);
+	static void OnIdleCallback(uv_idle_t * handle);
+	static void js_idleDeadline_timeRemaining (const v8::FunctionCallbackInfo<v8::Value>& info);
+
+	uint64_t enqueueTask(std::vector<QueuedTaskHolder*> &queue, v8::Local<v8::Function> callback, uint64_t timeout,
+						 v8::Local<v8::Array> arguments = v8::Local<v8::Array>());
+	void cancelTask(std::vector<QueuedTaskHolder*> &queue, const v8::FunctionCallbackInfo<v8::Value>& args);
+	void runTask(QueuedTaskHolder *holder);
+	void promoteStarvingTasks(uint64_t now);
+	bool hasPendingTasks() const;
+	void updateIdleHandle();
 	static void RejectedPromiseHolderWeakPersistentCallback(const v8::WeakCallbackInfo<void> &data);
 
 	void createContext();
@@ -151,9 +271,12 @@ private:
     static void jniInitialize(JNIEnv * env, jobject v8Engine, jobject assetManager, jstring commonJSPath, jint maxHeapSize);
     static void jniPause(JNIEnv *env, jobject obj);
     static void jniUnpause(JNIEnv *env, jobject obj);
+    static void jniSetTimerSlack(JNIEnv *env, jobject obj, jint slack);
     static void jniShutdown(JNIEnv *env, jobject obj);
     static jstring jniDumpHeap(JNIEnv *env, jobject obj, jstring pathToSaveIn);
     static void jniEnqueueOnNextTick(JNIEnv *env, jobject obj, jobject function);
+    static void jniEnqueueTask(JNIEnv *env, jobject obj, jobject function, jint priority);
+    static void jniPost(JNIEnv *env, jobject obj, jobject runnable);
     static jobject jniParseJSON(JNIEnv *env, jobject obj, jstring json);
     static jobject jniRequire(JNIEnv *env, jobject obj, jstring file);
     static jlong jniLock(JNIEnv *env, jobject obj);
@@ -162,6 +285,8 @@ private:
     static jobject jniRunScript(JNIEnv *env, jobject obj, jstring script, jstring name);
     static void jniRegisterModuleNative(JNIEnv *env, jobject obj, jobject module);
     static jobject jniGetConstructor(JNIEnv *env, jobject obj, jstring canonicalName);
+    static void jniSetHandleTracking(JNIEnv *env, jclass clazz, jboolean enabled, jboolean captureJSStack);
+    static jstring jniDumpHandles(JNIEnv *env, jclass clazz);
 
 	// jni class info caches
 	static struct {
@@ -187,6 +312,30 @@ private:
 		jmethodID initId;
 	} _jniStackTraceElement;
 
+	static struct {
+		jclass clazz;
+		jmethodID runId;
+	} _jniRunnable;
+
+	static struct {
+		jclass clazz;
+		jmethodID doubleValueId;
+	} _jniNumber;
+
+	static struct {
+		jclass clazz;
+		jmethodID booleanValueId;
+	} _jniBoolean;
+
+	static struct {
+		jclass clazz;
+	} _jniString;
+
+	static struct {
+		jclass clazz;
+		jmethodID initId;
+	} _jniRuntimeException;
+
 	static struct {
 		jclass clazz;
 		jmethodID onReadyId;
@@ -203,7 +352,10 @@ private:
 	uv_loop_t _uvLoop;
 	uv_mutex_t _uvMutex;
 	uv_cond_t _uvCondSuspend;
-	uv_async_t _uvEventScheduleTimers, _uvEventStop, _uvEventSuspend;
+	uv_async_t _uvEventScheduleTimers, _uvEventScheduleTasks, _uvEventStop, _uvEventSuspend, _uvEventLoopWork;
+	uv_check_t _uvCheckImmediates, _uvCheckTasks;
+	uv_prepare_t _uvPrepareIdleTasks;
+	uv_idle_t _uvIdle;
 
 	int _maxHeapSize;	// in MB
 
@@ -218,11 +370,26 @@ private:
 
 	uint64_t _nextTimerId;
 	std::vector<TimerHolder*> _timers;
+	uint64_t _timerSlack;
+
+	uint64_t _nextTaskId;
+	std::vector<QueuedTaskHolder*> _immediates, _idleTasks;
+	std::vector<QueuedTaskHolder*> _tasks[kTaskPriorityCount];
+	// work posted from other threads; guarded by _uvMutexLoopWork instead of the locker
+	uv_mutex_t _uvMutexLoopWork;
+	std::vector<LoopWorkHolder> _pendingLoopWork;
+	// set once the event loop has ended; no more work is accepted after that
+	bool _loopWorkClosed;
+	v8::Persistent<v8::ObjectTemplate> _idleDeadlineTpl;
+	v8::Persistent<v8::Private> _wrapperPeerKey;
 
 	std::string _commonJSPath;
 	std::map<std::string, jobject> _javaModules;
 	std::map<std::string, requireHook> _modules;
     std::map<std::string, v8::Persistent<v8::Value>> _moduleCache;
+    JNIV8PropertyNameCache _propertyNameCache;
+    std::set<JNIV8ArrayBufferHolder*> _externalArrayBuffers;
+    JNIV8ClassInfoTable _classInfoTable;
     v8::Isolate* _isolate;
 
     v8::Persistent<v8::Function> _requireFn, _makeRequireFn;
@@ -96,7 +96,7 @@ BGJSV8Engine2dGL::~BGJSV8Engine2dGL() {
         context = nullptr;
     }
     if (!_jsValue.IsEmpty()) {
-        _jsValue.Reset();
+        BGJS_CLEAR_PERSISTENT(_jsValue);
     }
 }
 
@@ -86,4 +86,76 @@ METHOD_STATIC(Double, jdouble)
 METHOD_STATIC(Float, jfloat)
 METHOD_STATIC(Int, jint)
 METHOD_STATIC(Short, jshort)
-METHOD_STATIC(Object, jobject)
\ No newline at end of file
+METHOD_STATIC(Object, jobject)
+
+//--------------------------------------------------------------------------------------------------
+// Handle based access
+//--------------------------------------------------------------------------------------------------
+#define GETTER_STATIC_HANDLE(TypeName, JNITypeName) \
+JNITypeName JNIClass::getJavaStatic##TypeName##Field(JNIFieldHandle field) {\
+    JNIEnv* env = JNIWrapper::getEnvironment(); \
+    JNI_ASSERT(field.slot >= 0 && field.slot < (int)_jniClassInfo->fieldSlots.size(), "Attempt to get field with invalid handle");\
+    JNI_ASSERT(_jniClassInfo->fieldSlots[field.slot].isStatic, "Attempt to get non-static field via static get");\
+    return env->GetStatic##TypeName##Field(_jniClassInfo->jniClassRef, _jniClassInfo->fieldSlots[field.slot].id); \
+}
+
+GETTER_STATIC_HANDLE(Long, jlong)
+GETTER_STATIC_HANDLE(Boolean, jboolean)
+GETTER_STATIC_HANDLE(Byte, jbyte)
+GETTER_STATIC_HANDLE(Char, jchar)
+GETTER_STATIC_HANDLE(Double, jdouble)
+GETTER_STATIC_HANDLE(Float, jfloat)
+GETTER_STATIC_HANDLE(Int, jint)
+GETTER_STATIC_HANDLE(Short, jshort)
+GETTER_STATIC_HANDLE(Object, jobject)
+
+#define SETTER_STATIC_HANDLE(TypeName, JNITypeName) \
+void JNIClass::setJavaStatic##TypeName##Field(JNIFieldHandle field, JNITypeName value) {\
+    JNIEnv* env = JNIWrapper::getEnvironment(); \
+    JNI_ASSERT(field.slot >= 0 && field.slot < (int)_jniClassInfo->fieldSlots.size(), "Attempt to set field with invalid handle");\
+    JNI_ASSERT(_jniClassInfo->fieldSlots[field.slot].isStatic, "Attempt to set non-static field via static setter");\
+    return env->SetStatic##TypeName##Field(_jniClassInfo->jniClassRef, _jniClassInfo->fieldSlots[field.slot].id, value); \
+}
+
+SETTER_STATIC_HANDLE(Long, jlong)
+SETTER_STATIC_HANDLE(Boolean, jboolean)
+SETTER_STATIC_HANDLE(Byte, jbyte)
+SETTER_STATIC_HANDLE(Char, jchar)
+SETTER_STATIC_HANDLE(Double, jdouble)
+SETTER_STATIC_HANDLE(Float, jfloat)
+SETTER_STATIC_HANDLE(Int, jint)
+SETTER_STATIC_HANDLE(Short, jshort)
+SETTER_STATIC_HANDLE(Object, jobject)
+
+#define METHOD_STATIC_HANDLE(TypeName, JNITypeName) \
+JNITypeName JNIClass::callJavaStatic##TypeName##Method(JNIMethodHandle method, ...) {\
+    JNIEnv* env = JNIWrapper::getEnvironment();\
+    JNI_ASSERT(method.slot >= 0 && method.slot < (int)_jniClassInfo->methodSlots.size(), "Attempt to call method with invalid handle");\
+    JNI_ASSERT(_jniClassInfo->methodSlots[method.slot].isStatic, "Attempt to call non-static method as static");\
+    va_list args;\
+    JNITypeName res;\
+    va_start(args, method);\
+    res = env->CallStatic##TypeName##MethodV(_jniClassInfo->jniClassRef, _jniClassInfo->methodSlots[method.slot].id, args);\
+    va_end(args);\
+    return res;\
+}
+
+void JNIClass::callJavaStaticVoidMethod(JNIMethodHandle method, ...) {
+    JNIEnv* env = JNIWrapper::getEnvironment();
+    JNI_ASSERT(method.slot >= 0 && method.slot < (int)_jniClassInfo->methodSlots.size(), "Attempt to call method with invalid handle");
+    JNI_ASSERT(_jniClassInfo->methodSlots[method.slot].isStatic, "Attempt to call non-static method as static");
+    va_list args;
+    va_start(args, method);
+    env->CallStaticVoidMethodV(_jniClassInfo->jniClassRef, _jniClassInfo->methodSlots[method.slot].id, args);
+    va_end(args);
+}
+
+METHOD_STATIC_HANDLE(Long, jlong)
+METHOD_STATIC_HANDLE(Boolean, jboolean)
+METHOD_STATIC_HANDLE(Byte, jbyte)
+METHOD_STATIC_HANDLE(Char, jchar)
+METHOD_STATIC_HANDLE(Double, jdouble)
+METHOD_STATIC_HANDLE(Float, jfloat)
+METHOD_STATIC_HANDLE(Int, jint)
+METHOD_STATIC_HANDLE(Short, jshort)
+METHOD_STATIC_HANDLE(Object, jobject)
@@ -6,6 +6,7 @@
 #define __JNICLASS_H
 
 #include "JNIBase.h"
+#include "JNIClassInfo.h"
 
 class JNIClassInfo;
 class JNIWrapper;
@@ -62,6 +63,40 @@ public:
     void setJavaStaticIntField(const std::string& fieldName, jint value);
     void setJavaStaticShortField(const std::string& fieldName, jshort value);
     void setJavaStaticObjectField(const std::string& fieldName, jobject value);
+
+    /**
+     * same as above, but using handles as returned by JNIClassInfo::registerStaticMethod/registerStaticField
+     */
+    void callJavaStaticVoidMethod(JNIMethodHandle method, ...);
+    jlong callJavaStaticLongMethod(JNIMethodHandle method, ...);
+    jboolean callJavaStaticBooleanMethod(JNIMethodHandle method, ...);
+    jbyte callJavaStaticByteMethod(JNIMethodHandle method, ...);
+    jchar callJavaStaticCharMethod(JNIMethodHandle method, ...);
+    jdouble callJavaStaticDoubleMethod(JNIMethodHandle method, ...);
+    jfloat callJavaStaticFloatMethod(JNIMethodHandle method, ...);
+    jint callJavaStaticIntMethod(JNIMethodHandle method, ...);
+    jshort callJavaStaticShortMethod(JNIMethodHandle method, ...);
+    jobject callJavaStaticObjectMethod(JNIMethodHandle method, ...);
+
+    jlong getJavaStaticLongField(JNIFieldHandle field);
+    jboolean getJavaStaticBooleanField(JNIFieldHandle field);
+    jbyte getJavaStaticByteField(JNIFieldHandle field);
+    jchar getJavaStaticCharField(JNIFieldHandle field);
+    jdouble getJavaStaticDoubleField(JNIFieldHandle field);
+    jfloat getJavaStaticFloatField(JNIFieldHandle field);
+    jint getJavaStaticIntField(JNIFieldHandle field);
+    jshort getJavaStaticShortField(JNIFieldHandle field);
+    jobject getJavaStaticObjectField(JNIFieldHandle field);
+
+    void setJavaStaticLongField(JNIFieldHandle field, jlong value);
+    void setJavaStaticBooleanField(JNIFieldHandle field, jboolean value);
+    void setJavaStaticByteField(JNIFieldHandle field, jbyte value);
+    void setJavaStaticCharField(JNIFieldHandle field, jchar value);
+    void setJavaStaticDoubleField(JNIFieldHandle field, jdouble value);
+    void setJavaStaticFloatField(JNIFieldHandle field, jfloat value);
+    void setJavaStaticIntField(JNIFieldHandle field, jint value);
+    void setJavaStaticShortField(JNIFieldHandle field, jshort value);
+    void setJavaStaticObjectField(JNIFieldHandle field, jobject value);
 };
 
 #endif //__JNICLASS_H
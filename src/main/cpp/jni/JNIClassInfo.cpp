@@ -9,20 +9,26 @@
 #include "JNIWrapper.h"
 #include "JNIClassInfo.h"
 
-JNIClassInfo::JNIClassInfo(size_t hashCode, JNIObjectType  type, jclass clazz, const std::string& canonicalName, ObjectInitializer i, ObjectConstructor c, JNIClassInfo *baseClassInfo) :
-        hashCode(hashCode), type(type), canonicalName(canonicalName), initializer(i), constructor(c), baseClassInfo(baseClassInfo) {
-    // cache class
-    // if we wanted to allow dynamic class unloading we could use a weak global ref and check it every time before creating/wrapping an object
-    // but because that might happen from another thread we would have to make sure to use the correct class loader to require it..
-    // => for now we do not need it, as it can safely be assumed that most (if not all) jni classes will likely be used throughout the whole lifetime of the application
-    // so we are using a strong reference; this will ALWAYS keep the class from getting unloaded (e.g. if a future android version changes behaviour)
-    jniClassRef = (jclass)JNIWrapper::getEnvironment()->NewGlobalRef(clazz);
+JNIClassInfo::JNIClassInfo(size_t hashCode, JNIObjectType  type, const std::string& canonicalName, ObjectInitializer i, ObjectConstructor c, JNIClassInfo *baseClassInfo) :
+        hashCode(hashCode), type(type), canonicalName(canonicalName), initializer(i), constructor(c), baseClassInfo(baseClassInfo),
+        jniClassRef(nullptr), inheritedMethodSlots(0), inheritedFieldSlots(0), initialized(false), initializing(false) {
+    if(baseClassInfo) {
+        hierarchy = baseClassInfo->hierarchy;
+    }
+    depth = hierarchy.size();
+    hierarchy.push_back(this);
 }
 
 void JNIClassInfo::inherit() {
     // copy up field & methodMap from baseclass for faster lookup
     // can be overwritten by subclass
     if(baseClassInfo) {
+        // handles registered by the baseclass have to resolve to the same entries here
+        methodSlots = baseClassInfo->methodSlots;
+        fieldSlots = baseClassInfo->fieldSlots;
+        inheritedMethodSlots = methodSlots.size();
+        inheritedFieldSlots = fieldSlots.size();
+
         // In contrast to methods, Java constructors are NOT virtual
         // e.g. assume class B extends A; both have a constructor X taking the same parameters
         // we have to obtain a different methodID for X on B if we want to create instances of B!
@@ -40,7 +46,13 @@ void JNIClassInfo::inherit() {
                 }
                 continue;
             }
-            registerMethod(it.second.name, it.second.signature, it.first);
+            // constructor exists on subclass => replace id in the existing slot
+            JNIMethodInfo method = it.second;
+            method.id = getMethodID(method.name, method.signature, false);
+            methodMap[it.first] = method;
+            if(method.slot >= 0) {
+                methodSlots[method.slot] = method;
+            }
         }
 
         // fields are simply copied from base class
@@ -68,43 +80,85 @@ void JNIClassInfo::registerConstructor(const std::string& signature, const std::
     registerMethod("<init>", signature, alias);
 }
 
-void JNIClassInfo::registerMethod(const std::string& methodName,
-                                  const std::string& signature,
-                                  const std::string& alias) {
+JNIMethodHandle JNIClassInfo::registerMethod(const std::string& methodName,
+                                             const std::string& signature,
+                                             const std::string& alias) {
     const std::string& finalAlias = alias.length() ? alias : methodName;
     auto it = methodMap.find(finalAlias);
     JNI_ASSERTF(it == methodMap.end(), "Method '%s' is already registered", methodName.c_str());
     jmethodID methodId = getMethodID(methodName, signature, false);
     JNI_ASSERTF(methodId, "Method '%s' does not exist on Java class", methodName.c_str());
-    methodMap[finalAlias] = {false, methodName, signature, methodId};
+    return addMethod(finalAlias, {false, methodName, signature, methodId, -1});
 }
 
-void JNIClassInfo::registerField(const std::string& fieldName,
-                                 const std::string& signature,
-                                 const std::string& alias
+JNIFieldHandle JNIClassInfo::registerField(const std::string& fieldName,
+                                           const std::string& signature,
+                                           const std::string& alias
 ) {
     const std::string& finalAlias = alias.length() ? alias : fieldName;
     jfieldID fieldId = getFieldID(fieldName, signature, false);
     JNI_ASSERTF(fieldId, "Field '%s' does not exist on Java class", fieldName.c_str());
-    fieldMap[finalAlias] = {false, fieldName, signature, fieldId};
+    return addField(finalAlias, {false, fieldName, signature, fieldId, -1});
 }
 
-void JNIClassInfo::registerStaticMethod(const std::string& methodName,
-                                        const std::string& signature,
-                                        const std::string& alias) {
+JNIMethodHandle JNIClassInfo::registerStaticMethod(const std::string& methodName,
+                                                   const std::string& signature,
+                                                   const std::string& alias) {
     const std::string& finalAlias = alias.length() ? alias : methodName;
     jmethodID methodId = getMethodID(methodName, signature, true);
     JNI_ASSERTF(methodId, "Method '%s' does not exist on Java class", methodName.c_str());
-    methodMap[finalAlias] = {true, methodName, signature, methodId};
+    return addMethod(finalAlias, {true, methodName, signature, methodId, -1});
 }
 
-void JNIClassInfo::registerStaticField(const std::string& fieldName,
-                                       const std::string& signature,
-                                       const std::string& alias) {
+JNIFieldHandle JNIClassInfo::registerStaticField(const std::string& fieldName,
+                                                 const std::string& signature,
+                                                 const std::string& alias) {
     const std::string& finalAlias = alias.length() ? alias : fieldName;
     jfieldID fieldId = getFieldID(fieldName, signature, true);
     JNI_ASSERTF(fieldId, "Field '%s' does not exist on Java class", fieldName.c_str());
-    fieldMap[finalAlias] = {true, fieldName, signature, fieldId};
+    return addField(finalAlias, {true, fieldName, signature, fieldId, -1});
+}
+
+JNIMethodHandle JNIClassInfo::getMethodHandle(const std::string& alias) const {
+    auto it = methodMap.find(alias);
+    JNI_ASSERTF(it != methodMap.end() && it->second.slot >= 0, "Method '%s' is not registered", alias.c_str());
+    return {it->second.slot};
+}
+
+JNIFieldHandle JNIClassInfo::getFieldHandle(const std::string& alias) const {
+    auto it = fieldMap.find(alias);
+    JNI_ASSERTF(it != fieldMap.end() && it->second.slot >= 0, "Field '%s' is not registered", alias.c_str());
+    return {it->second.slot};
+}
+
+JNIMethodHandle JNIClassInfo::addMethod(const std::string& alias, const JNIMethodInfo& method) {
+    // every (class, alias) pair gets its own slot: if a subclass registers an alias of the baseclass again
+    // (e.g. a static method with the same name), handles of the baseclass still refer to the baseclass entry
+    auto it = methodMap.find(alias);
+    int slot = it != methodMap.end() && it->second.slot >= (int)inheritedMethodSlots ? it->second.slot : (int)methodSlots.size();
+    JNIMethodInfo &entry = methodMap[alias];
+    entry = method;
+    entry.slot = slot;
+    if(slot == (int)methodSlots.size()) {
+        methodSlots.push_back(entry);
+    } else {
+        methodSlots[slot] = entry;
+    }
+    return {slot};
+}
+
+JNIFieldHandle JNIClassInfo::addField(const std::string& alias, const JNIFieldInfo& field) {
+    auto it = fieldMap.find(alias);
+    int slot = it != fieldMap.end() && it->second.slot >= (int)inheritedFieldSlots ? it->second.slot : (int)fieldSlots.size();
+    JNIFieldInfo &entry = fieldMap[alias];
+    entry = field;
+    entry.slot = slot;
+    if(slot == (int)fieldSlots.size()) {
+        fieldSlots.push_back(entry);
+    } else {
+        fieldSlots[slot] = entry;
+    }
+    return {slot};
 }
 
 jmethodID JNIClassInfo::getMethodID(const std::string& methodName,
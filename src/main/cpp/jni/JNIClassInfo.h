@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <atomic>
+#include <mutex>
 
 class JNIClassInfo;
 class JNIObject;
@@ -38,16 +40,32 @@ enum class JNIObjectType {
 typedef JNIObject*(*ObjectConstructor)(jobject obj, JNIClassInfo *info);
 typedef void(*ObjectInitializer)(JNIClassInfo *info, bool isReload);
 
+/**
+ * handles are returned when registering methods or fields, and can be used instead of the name
+ * to call the method or access the field without having to look it up by name first
+ * a handle is an index into a flat table of resolved ids; it stays valid for all subclasses of the registering class
+ * and always refers to the entry of the registering class, even if a subclass registers the same name again
+ */
+struct JNIMethodHandle {
+    int slot;
+};
+
+struct JNIFieldHandle {
+    int slot;
+};
+
 struct JNIMethodInfo {
     bool isStatic;
     std::string name, signature;
     jmethodID id;
+    int slot;
 };
 
 struct JNIFieldInfo {
     bool isStatic;
     std::string name, signature;
     jfieldID id;
+    int slot;
 };
 
 struct JNIClassInfo {
@@ -84,8 +102,8 @@ public:
      * subclasses implementing a static method with the same name as a baseclass should always use aliases (e.g. "Type:method")
      * following subclasses will also have to use this new alias to access the "latest" version of the field!
      */
-    void registerMethod(const std::string& methodName, const std::string& signature, const std::string& alias = "");
-    void registerStaticMethod(const std::string& methodName, const std::string& signature, const std::string& alias = "");
+    JNIMethodHandle registerMethod(const std::string& methodName, const std::string& signature, const std::string& alias = "");
+    JNIMethodHandle registerStaticMethod(const std::string& methodName, const std::string& signature, const std::string& alias = "");
     /**
      * register a field to be accessed via JNIObject or JNIClass later
      * fields and methods have seperate registries, so aliases and names can be "used twice"
@@ -98,11 +116,24 @@ public:
      * Note: like static methods, names for fields always refer to the field of the class that registered the name, even if the field is shadowed by a subclass.
      * to access the subclasses shadowing field, use the alias provided by the subclass
      */
-    void registerField(const std::string& fieldName, const std::string& signature, const std::string& alias = "");
-    void registerStaticField(const std::string& fieldName, const std::string& signature, const std::string& alias = "");
+    JNIFieldHandle registerField(const std::string& fieldName, const std::string& signature, const std::string& alias = "");
+    JNIFieldHandle registerStaticField(const std::string& fieldName, const std::string& signature, const std::string& alias = "");
+
+    /**
+     * returns the handle for a previously registered method or field (by alias)
+     */
+    JNIMethodHandle getMethodHandle(const std::string& alias) const;
+    JNIFieldHandle getFieldHandle(const std::string& alias) const;
+
+    /**
+     * checks if this class is the specified class or one of its subclasses in O(1)
+     */
+    inline bool isSubclassOf(const JNIClassInfo *other) const {
+        return other->depth < hierarchy.size() && hierarchy[other->depth] == other;
+    }
 
 private:
-    JNIClassInfo(size_t hashCode, JNIObjectType type, jclass clazz, const std::string& canonicalName, ObjectInitializer i, ObjectConstructor c, JNIClassInfo *baseClassInfo);
+    JNIClassInfo(size_t hashCode, JNIObjectType type, const std::string& canonicalName, ObjectInitializer i, ObjectConstructor c, JNIClassInfo *baseClassInfo);
     void inherit();
 
     jmethodID getMethodID(const std::string& methodName,
@@ -113,7 +144,13 @@ private:
                         const std::string& signature,
                         bool isStatic);
 
+    JNIMethodHandle addMethod(const std::string& alias, const JNIMethodInfo& method);
+    JNIFieldHandle addField(const std::string& alias, const JNIFieldInfo& field);
+
     JNIClassInfo *baseClassInfo;
+    // all classes from the root class down to (and including) this class; indexed by depth
+    std::vector<const JNIClassInfo*> hierarchy;
+    size_t depth;
     JNIObjectType type;
     ObjectInitializer initializer;
     ObjectConstructor constructor;
@@ -123,6 +160,15 @@ private:
     size_t hashCode;
     std::map<std::string, JNIMethodInfo> methodMap;
     std::map<std::string, JNIFieldInfo> fieldMap;
+    // indexed by handle slot; subclasses start with a copy of the baseclass tables so that slots are preserved
+    std::vector<JNIMethodInfo> methodSlots;
+    std::vector<JNIFieldInfo> fieldSlots;
+    // number of slots copied from the baseclass; slots from this index on were registered by this class
+    size_t inheritedMethodSlots, inheritedFieldSlots;
+    // classes are only declared when the library is loaded; java class, ids and natives are resolved on first use
+    std::atomic<bool> initialized;
+    bool initializing;
+    std::recursive_mutex initMutex;
 };
 
 
@@ -6,6 +6,7 @@
 
 #include "JNIObject.h"
 #include "JNIWrapper.h"
+#include "mallocdebug.h"
 
 BGJS_JNI_LINK(JNIObject, "ag/boersego/bgjs/JNIObject");
 
@@ -14,16 +15,16 @@ JNIObject::JNIObject(jobject obj, JNIClassInfo *info) : JNIBase(info) {
     if(info->type == JNIObjectType::kPersistent) {
         // persistent objects are owned by the java side: they are destroyed once the java side is garbage collected
         // => as long as there are no references to the c object, the java reference is weak.
-        _jniObjectWeak = env->NewWeakGlobalRef(obj);
+        _jniObjectWeak = BGJS_NEW_WEAK_GLOBAL_REF(env, obj);
         _jniObject = nullptr;
     } else {
         // non-persistent objects are owned by the c side. they do not exist in this form on the java side
         // => as long as the object exists, the java reference should always be strong
         // theoretically we could use the same logic here, and make it non-weak on demand, but it simply is not necessary
-        _jniObject = env->NewGlobalRef(obj);
+        _jniObject = BGJS_NEW_GLOBAL_REF(env, obj);
         _jniObjectWeak = nullptr;
     }
-    _atomicJniObjectRefCount = 0;
+    _atomicJniObjectRefCount.store(0, std::memory_order_relaxed);
 
     // store pointer to native instance in "nativeHandle" field
     // actually type will never be kAbstract here, because JNIClassInfo will be provided for the subclass!
@@ -32,7 +33,7 @@ JNIObject::JNIObject(jobject obj, JNIClassInfo *info) : JNIBase(info) {
         JNIClassInfo *info = _jniClassInfo;
         while(info && info->baseClassInfo) info = info->baseClassInfo;
         auto it = info->fieldMap.at("nativeHandle");
-        env->SetLongField(getJObject(), it.id, reinterpret_cast<jlong>(this));
+        env->SetLongField(obj, it.id, reinterpret_cast<jlong>(this));
     }
 }
 
@@ -42,15 +43,17 @@ JNIObject::~JNIObject() {
         // this should/can never happen for persistent objects
         // if there is a strong ref to the JObject, then the native object must not be deleted!
         // it can however happen for non-persistent objects!
-        JNIWrapper::getEnvironment()->DeleteGlobalRef(_jniObject);
+        BGJS_DELETE_GLOBAL_REF(JNIWrapper::getEnvironment(), _jniObject);
     } else if(_jniObjectWeak) {
-        JNIWrapper::getEnvironment()->DeleteWeakGlobalRef(_jniObjectWeak);
+        BGJS_DELETE_WEAK_GLOBAL_REF(JNIWrapper::getEnvironment(), _jniObjectWeak);
     }
     _jniObjectWeak = _jniObject = nullptr;
 }
 
 void JNIObject::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
     info->registerNativeMethod("RegisterClass", "(Ljava/lang/String;Ljava/lang/String;)V", (void*)JNIObject::jniRegisterClass);
+    info->registerNativeMethod("InitializeClass", "(Ljava/lang/String;)V", (void*)JNIObject::jniInitializeClass);
+    info->registerNativeMethod("PreloadClasses", "([Ljava/lang/String;)V", (void*)JNIObject::jniPreloadClasses);
 }
 
 bool JNIObject::isRetained() const {
@@ -69,66 +72,94 @@ const jobject JNIObject::getJObject() const {
     return env->NewLocalRef(_jniObject);
 }
 
+const jobject JNIObject::getBorrowedJObject() const {
+    // for the same reasons as above the weak reference of persistents is used;
+    // it can be passed to jni calls directly, and it does not change while the object exists
+    return isPersistent() ? _jniObjectWeak : _jniObject;
+}
+
+bool JNIObject::dispose() {
+    if(isRetained()) return false;
+    delete this;
+    return true;
+}
+
 void JNIObject::retainJObject() {
-    // optimized for the case where an object is likely to be retained for longer times
-    // => just update the atomic counter, no locking
-    // if retain counter never rises above one it could be faster to always use a mutex and non-atomic counters
+    // the counter is only ever changed between 0 and 1 while holding the mutex, together with the global reference
+    // => a count > 0 implies that the strong reference exists, so all other changes can be done with a plain CAS
+    // the mutex is only taken for the actual weak <-> strong transition
 
     JNI_ASSERT(isPersistent(), "Attempt to retain non-persistent native object");
-    if(++_atomicJniObjectRefCount == 1) {
-        std::lock_guard<std::mutex> guard(_mutex);
-
-        // while this thread A was waiting for the mutex, the counter might have changed
-        // or another thread B could possible even already have created the object
-        // e.g. (0->1(A)->0->1(B), executed as 1->0->1 (B)(A)
-        // => check state here, guarded by mutex, and possibly do nothing
-        if(_atomicJniObjectRefCount==0 || _jniObject) {
+    uint32_t count = _atomicJniObjectRefCount.load(std::memory_order_relaxed);
+    while(count > 0) {
+        if(_atomicJniObjectRefCount.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
             return;
         }
+    }
 
-        JNIEnv *env = JNIWrapper::getEnvironment();
-        _jniObject = env->NewGlobalRef(_jniObjectWeak);
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    // another thread B might have created the reference while this thread A was waiting for the mutex
+    // in that case the count can only be changed by CAS from here on
+    count = _atomicJniObjectRefCount.load(std::memory_order_relaxed);
+    while(count > 0) {
+        if(_atomicJniObjectRefCount.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
     }
+
+    JNIEnv *env = JNIWrapper::getEnvironment();
+    _jniObject = BGJS_NEW_GLOBAL_REF(env, _jniObjectWeak);
+    _atomicJniObjectRefCount.store(1, std::memory_order_release);
 }
 
 void JNIObject::releaseJObject() {
-    // optimized for the case where an object is likely to be retained for longer times
-    // => just update the atomic counter, no locking
-    // if retain counter never rises above one it could be faster to always use a mutex and non-atomic counters
+    // see retainJObject: only the 1 -> 0 transition takes the mutex
 
     JNI_ASSERT(isPersistent(), "Attempt to release non-persistent native object");
-    if(--_atomicJniObjectRefCount == 0) {
-        std::lock_guard<std::mutex> guard(_mutex);
-
-        // while this thread A was waiting for the mutex, the counter might have changed
-        // or another thread B could possible even already have released the object
-        // e.g. (1->0(A)->1->0(B), executed as 1->0->1 (B)(A)
-        // => check state here, guarded by mutex, and possibly do nothing
-        if(_atomicJniObjectRefCount > 0 || !_jniObject) {
+    uint32_t count = _atomicJniObjectRefCount.load(std::memory_order_relaxed);
+    while(count > 1) {
+        if(_atomicJniObjectRefCount.compare_exchange_weak(count, count - 1, std::memory_order_release, std::memory_order_relaxed)) {
             return;
         }
+    }
+    JNI_ASSERT(count == 1, "Attempt to release native object that is not retained");
+
+    std::lock_guard<std::mutex> guard(_mutex);
 
-        JNIEnv *env = JNIWrapper::getEnvironment();
-
-        // this method is executed automatically if a shared_ptr falls of the stack
-        // if an exception was thrown after the shared_ptr was created, we can
-        // not call any JNI functions without clearing the exception first and then rethrowing it
-        // In most cases this could be done in the method itself, but it is tedious and likely to be forgotten
-        // also, there are cases
-        // e.g. when an exception is thrown in a method that is not immediately called from Java/JNI, but the shared_ptr is used in a method further upp the call stack
-        // when it is very hard or even impossible to do this
-        // => handle this here!
-        jthrowable exc = nullptr;
-        if(env->ExceptionCheck()) {
-            exc = env->ExceptionOccurred();
-            env->ExceptionClear();
+    // other threads can still retain or release without the mutex while the count is > 0
+    // => the count only drops to zero if it is still one at the time of the exchange
+    count = _atomicJniObjectRefCount.load(std::memory_order_relaxed);
+    for(;;) {
+        if(count > 1) {
+            if(_atomicJniObjectRefCount.compare_exchange_weak(count, count - 1, std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        } else if(_atomicJniObjectRefCount.compare_exchange_weak(count, 0, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            break;
         }
+    }
 
-        env->DeleteGlobalRef(_jniObject);
-        _jniObject = nullptr;
+    JNIEnv *env = JNIWrapper::getEnvironment();
 
-        if(exc) env->Throw(exc);
+    // this method is executed automatically if a shared_ptr falls of the stack
+    // if an exception was thrown after the shared_ptr was created, we can
+    // not call any JNI functions without clearing the exception first and then rethrowing it
+    // In most cases this could be done in the method itself, but it is tedious and likely to be forgotten
+    // also, there are cases
+    // e.g. when an exception is thrown in a method that is not immediately called from Java/JNI, but the shared_ptr is used in a method further upp the call stack
+    // when it is very hard or even impossible to do this
+    // => handle this here!
+    jthrowable exc = nullptr;
+    if(env->ExceptionCheck()) {
+        exc = env->ExceptionOccurred();
+        env->ExceptionClear();
     }
+
+    BGJS_DELETE_GLOBAL_REF(env, _jniObject);
+    _jniObject = nullptr;
+
+    if(exc) env->Throw(exc);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -143,7 +174,7 @@ JNITypeName JNIObject::callJava##TypeName##Method(const char* name, ...) {\
     va_list args;\
     JNITypeName res;\
     va_start(args, name);\
-    res = env->Call##TypeName##MethodV(getJObject(), it->second.id, args);\
+    res = env->Call##TypeName##MethodV(getBorrowedJObject(), it->second.id, args);\
     va_end(args);\
     return res;\
 }
@@ -155,7 +186,7 @@ void JNIObject::callJavaVoidMethod(const char* name, ...) {
     JNI_ASSERTF(!it->second.isStatic, "Attempt to call non-static method '%s' as static", name);
     va_list args;
     va_start(args, name);\
-    env->CallVoidMethodV(getJObject(), it->second.id, args);
+    env->CallVoidMethodV(getBorrowedJObject(), it->second.id, args);
     va_end(args);
 }
 
@@ -169,6 +200,41 @@ METHOD(Int, jint)
 METHOD(Short, jshort)
 METHOD(Object, jobject)
 
+#define METHOD_HANDLE(TypeName, JNITypeName) \
+JNITypeName JNIObject::callJava##TypeName##Method(JNIMethodHandle method, ...) {\
+    JNIEnv* env = JNIWrapper::getEnvironment();\
+    JNI_ASSERT(method.slot >= 0 && method.slot < (int)_jniClassInfo->methodSlots.size(), "Attempt to call method with invalid handle");\
+    const JNIMethodInfo &info = _jniClassInfo->methodSlots[method.slot];\
+    JNI_ASSERTF(!info.isStatic, "Attempt to call static method '%s' as non-static", info.name.c_str());\
+    va_list args;\
+    JNITypeName res;\
+    va_start(args, method);\
+    res = env->Call##TypeName##MethodV(getBorrowedJObject(), info.id, args);\
+    va_end(args);\
+    return res;\
+}
+
+void JNIObject::callJavaVoidMethod(JNIMethodHandle method, ...) {
+    JNIEnv* env = JNIWrapper::getEnvironment();
+    JNI_ASSERT(method.slot >= 0 && method.slot < (int)_jniClassInfo->methodSlots.size(), "Attempt to call method with invalid handle");
+    const JNIMethodInfo &info = _jniClassInfo->methodSlots[method.slot];
+    JNI_ASSERTF(!info.isStatic, "Attempt to call static method '%s' as non-static", info.name.c_str());
+    va_list args;
+    va_start(args, method);
+    env->CallVoidMethodV(getBorrowedJObject(), info.id, args);
+    va_end(args);
+}
+
+METHOD_HANDLE(Long, jlong)
+METHOD_HANDLE(Boolean, jboolean)
+METHOD_HANDLE(Byte, jbyte)
+METHOD_HANDLE(Char, jchar)
+METHOD_HANDLE(Double, jdouble)
+METHOD_HANDLE(Float, jfloat)
+METHOD_HANDLE(Int, jint)
+METHOD_HANDLE(Short, jshort)
+METHOD_HANDLE(Object, jobject)
+
 void JNIObject::jniRegisterClass(JNIEnv *env, jobject obj, jstring derivedClass, jstring baseClass) {
     std::string strDerivedClass = JNIWrapper::jstring2string(derivedClass);
     std::replace(strDerivedClass.begin(), strDerivedClass.end(), '.', '/');
@@ -179,6 +245,27 @@ void JNIObject::jniRegisterClass(JNIEnv *env, jobject obj, jstring derivedClass,
     JNIWrapper::registerJavaObject(strDerivedClass, strBaseClass);
 }
 
+void JNIObject::jniInitializeClass(JNIEnv *env, jobject obj, jstring canonicalName) {
+    std::string strCanonicalName = JNIWrapper::jstring2string(canonicalName);
+    std::replace(strCanonicalName.begin(), strCanonicalName.end(), '.', '/');
+
+    JNIWrapper::initializeClass(strCanonicalName);
+}
+
+void JNIObject::jniPreloadClasses(JNIEnv *env, jobject obj, jobjectArray canonicalNames) {
+    jsize numNames = env->GetArrayLength(canonicalNames);
+    std::vector<std::string> names;
+    names.reserve((size_t)numNames);
+    for(jsize i = 0; i < numNames; i++) {
+        auto nameRef = (jstring)env->GetObjectArrayElement(canonicalNames, i);
+        names.push_back(JNIWrapper::jstring2string(nameRef));
+        std::replace(names.back().begin(), names.back().end(), '.', '/');
+        env->DeleteLocalRef(nameRef);
+    }
+
+    JNIWrapper::preloadClasses(names);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Exports
 //--------------------------------------------------------------------------------------------------
@@ -189,9 +276,7 @@ extern "C" {
 
     JNIEXPORT bool JNICALL Java_ag_boersego_bgjs_JNIObjectReference_disposeNative(JNIEnv *env, jobject obj, jlong nativeHandle) {
         JNIObject *jniObject = reinterpret_cast<JNIObject*>(nativeHandle);
-        if(jniObject->isRetained()) return false;
-        delete jniObject;
-        return true;
+        return jniObject->dispose();
     }
 }
 
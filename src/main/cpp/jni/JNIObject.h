@@ -9,6 +9,7 @@
 #include <jni.h>
 #include <mutex>
 #include "JNIBase.h"
+#include "JNIClassInfo.h"
 
 /**
  * Base class for all native classes associated with a java object
@@ -29,9 +30,23 @@ public:
 
     /**
      * returns the referenced java object
+     * the result is a new local reference that has to be deleted by the caller (or returned to java)
      */
     const jobject getJObject() const;
 
+    /**
+     * returns the reference to the java object that is held by this object without creating a new local reference
+     * the result is only valid as long as the native object is alive, and must NOT be deleted or returned to java
+     * use this for passing the object to jni calls
+     */
+    const jobject getBorrowedJObject() const;
+
+    /**
+     * deletes the native object unless it is currently retained
+     * called when the java object was collected or disposed manually; returns false if the object was not deleted
+     */
+    virtual bool dispose();
+
     /**
      * calls the specified java object method
      */
@@ -46,6 +61,20 @@ public:
     jshort callJavaShortMethod(const char* name, ...);
     jobject callJavaObjectMethod(const char* name, ...);
 
+    /**
+     * calls the java object method with the specified handle (as returned by JNIClassInfo::registerMethod)
+     */
+    void callJavaVoidMethod(JNIMethodHandle method, ...);
+    jlong callJavaLongMethod(JNIMethodHandle method, ...);
+    jboolean callJavaBooleanMethod(JNIMethodHandle method, ...);
+    jbyte callJavaByteMethod(JNIMethodHandle method, ...);
+    jchar callJavaCharMethod(JNIMethodHandle method, ...);
+    jdouble callJavaDoubleMethod(JNIMethodHandle method, ...);
+    jfloat callJavaFloatMethod(JNIMethodHandle method, ...);
+    jint callJavaIntMethod(JNIMethodHandle method, ...);
+    jshort callJavaShortMethod(JNIMethodHandle method, ...);
+    jobject callJavaObjectMethod(JNIMethodHandle method, ...);
+
 protected:
     void retainJObject();
     void releaseJObject();
@@ -53,12 +82,14 @@ protected:
 private:
     static void initializeJNIBindings(JNIClassInfo *info, bool isReload);
     static void jniRegisterClass(JNIEnv *env, jobject obj, jstring derivedClass, jstring baseClass);
+    static void jniInitializeClass(JNIEnv *env, jobject obj, jstring canonicalName);
+    static void jniPreloadClasses(JNIEnv *env, jobject obj, jobjectArray canonicalNames);
 
+    // only guards the transition between weak and strong reference; retain/release are lock-free otherwise
     std::mutex _mutex;
-    //pthread_mutex_t _mutex;
     jobject _jniObject;
     jweak _jniObjectWeak;
-    std::atomic<uint8_t> _atomicJniObjectRefCount;
+    std::atomic<uint32_t> _atomicJniObjectRefCount;
     std::weak_ptr<JNIObject> _weakPtr;
 };
 
@@ -7,17 +7,43 @@
 
 #include <jni.h>
 
+/**
+ * scoped local reference frame: all local references created while the frame exists are freed at once when it goes out of scope
+ * for bulk operations this is cheaper than deleting every local reference individually, and prevents overflowing the local reference table
+ */
 class JNILocalFrame {
 private:
     JNIEnv *_env;
+    bool _pushed;
 public:
-    JNILocalFrame(JNIEnv *env, size_t capacity = 0) {
+    /**
+     * if push is false no frame is created; used on paths that are known not to create any local references
+     */
+    JNILocalFrame(JNIEnv *env, size_t capacity = 0, bool push = true) {
         _env = env;
-        _env->PushLocalFrame((jint)capacity);
+        _pushed = push && _env->PushLocalFrame((jint)capacity) == 0;
     }
 
     ~JNILocalFrame() {
-        _env->PopLocalFrame(nullptr);
+        if(_pushed) _env->PopLocalFrame(nullptr);
+    }
+
+    /**
+     * pops the frame early and returns a new local reference to result that is valid in the enclosing frame
+     */
+    jobject pop(jobject result) {
+        if(!_pushed) return result;
+        _pushed = false;
+        return _env->PopLocalFrame(result);
+    }
+
+    /**
+     * frees all local references created so far and starts a new frame with the same capacity
+     * used for processing large collections in batches
+     */
+    void reset(size_t capacity = 0) {
+        if(_pushed) _env->PopLocalFrame(nullptr);
+        _pushed = _env->PushLocalFrame((jint)capacity) == 0;
     }
 };
 
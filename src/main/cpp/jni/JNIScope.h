@@ -80,7 +80,7 @@ JNITypeName callJavaSuper##TypeName##Method(const char* name, ...) {\
     va_list args;\
     JNITypeName res;\
     va_start(args, name);\
-    res = env->CallNonvirtual##TypeName##MethodV(jniObject->getJObject(), info->jniClassRef, it->second.id, args);\
+    res = env->CallNonvirtual##TypeName##MethodV(jniObject->getBorrowedJObject(), info->jniClassRef, it->second.id, args);\
     va_end(args);\
     return res;\
 }
@@ -92,7 +92,7 @@ JNITypeName getJava##TypeName##Field(const std::string& fieldName) {\
     auto it = info->fieldMap.find(fieldName);\
     JNI_ASSERTF(it != info->fieldMap.end(), "Attempt to get unregistered field '%s'", fieldName.c_str());\
     JNI_ASSERTF(!it->second.isStatic, "Attempt to get static field '%s' with non-static getter", fieldName.c_str());\
-    return env->Get##TypeName##Field(jniObject->getJObject(), it->second.id); \
+    return env->Get##TypeName##Field(jniObject->getBorrowedJObject(), it->second.id); \
 }
 
 #define SETTER(TypeName, JNITypeName) \
@@ -102,7 +102,7 @@ void setJava##TypeName##Field(const std::string& fieldName, JNITypeName value) {
     auto it = info->fieldMap.find(fieldName);\
     JNI_ASSERTF(it != info->fieldMap.end(), "Attempt to set unregistered field '%s'", fieldName.c_str());\
     JNI_ASSERTF(!it->second.isStatic, "Attempt to set static field '%s' with non-static setter", fieldName.c_str());\
-    return env->Set##TypeName##Field(jniObject->getJObject(), it->second.id, value); \
+    return env->Set##TypeName##Field(jniObject->getBorrowedJObject(), it->second.id, value); \
 }
 
 #define STATIC_GETTER(TypeName, JNITypeName) \
@@ -125,6 +125,53 @@ void setJavaStatic##TypeName##Field(const std::string& fieldName, JNITypeName va
     return env->SetStatic##TypeName##Field(info->jniClassRef, it->second.id, value); \
 }
 
+// handles resolve to the same slot on every level of the class hierarchy, but static members have to be accessed
+// through the class of the scope, just like with names
+#define HANDLE_SCOPE(Slots, handle) \
+CLASS_SCOPE() \
+JNI_ASSERT(handle.slot >= 0 && handle.slot < (int)info->Slots.size(), "Invalid handle encountered");
+
+#define STATIC_METHOD_HANDLE(TypeName, JNITypeName) \
+JNITypeName callJavaStatic##TypeName##Method(JNIMethodHandle method, ...) {\
+    HANDLE_SCOPE(methodSlots, method) \
+    JNIEnv* env = JNIWrapper::getEnvironment();\
+    JNI_ASSERTF(info->methodSlots[method.slot].isStatic, "Attempt to call non-static method '%s' as static", info->methodSlots[method.slot].name.c_str());\
+    va_list args;\
+    JNITypeName res;\
+    va_start(args, method);\
+    res = env->CallStatic##TypeName##MethodV(info->jniClassRef, info->methodSlots[method.slot].id, args);\
+    va_end(args);\
+    return res;\
+}
+
+#define GETTER_HANDLE(TypeName, JNITypeName) \
+JNITypeName getJava##TypeName##Field(JNIFieldHandle field) {\
+    HANDLE_SCOPE(fieldSlots, field) \
+    JNI_ASSERTF(!info->fieldSlots[field.slot].isStatic, "Attempt to get static field '%s' with non-static getter", info->fieldSlots[field.slot].name.c_str());\
+    return JNIWrapper::getEnvironment()->Get##TypeName##Field(jniObject->getBorrowedJObject(), info->fieldSlots[field.slot].id); \
+}
+
+#define SETTER_HANDLE(TypeName, JNITypeName) \
+void setJava##TypeName##Field(JNIFieldHandle field, JNITypeName value) {\
+    HANDLE_SCOPE(fieldSlots, field) \
+    JNI_ASSERTF(!info->fieldSlots[field.slot].isStatic, "Attempt to set static field '%s' with non-static setter", info->fieldSlots[field.slot].name.c_str());\
+    JNIWrapper::getEnvironment()->Set##TypeName##Field(jniObject->getBorrowedJObject(), info->fieldSlots[field.slot].id, value); \
+}
+
+#define STATIC_GETTER_HANDLE(TypeName, JNITypeName) \
+JNITypeName getJavaStatic##TypeName##Field(JNIFieldHandle field) {\
+    HANDLE_SCOPE(fieldSlots, field) \
+    JNI_ASSERTF(info->fieldSlots[field.slot].isStatic, "Attempt to get non-static field '%s' with static getter", info->fieldSlots[field.slot].name.c_str());\
+    return JNIWrapper::getEnvironment()->GetStatic##TypeName##Field(info->jniClassRef, info->fieldSlots[field.slot].id); \
+}
+
+#define STATIC_SETTER_HANDLE(TypeName, JNITypeName) \
+void setJavaStatic##TypeName##Field(JNIFieldHandle field, JNITypeName value) {\
+    HANDLE_SCOPE(fieldSlots, field) \
+    JNI_ASSERTF(info->fieldSlots[field.slot].isStatic, "Attempt to set non-static field '%s' with static setter", info->fieldSlots[field.slot].name.c_str());\
+    JNIWrapper::getEnvironment()->SetStatic##TypeName##Field(info->jniClassRef, info->fieldSlots[field.slot].id, value); \
+}
+
 template<class ScopeClass, class BaseClass = JNIObject> class JNIScope : public BaseClass {
 protected:
     /**
@@ -142,7 +189,7 @@ protected:
         JNI_ASSERTF(!it->second.isStatic, "Attempt to call static method '%s' as non-static", name);
         va_list args;
         va_start(args, name);
-        env->CallNonvirtualVoidMethodV(jniObject->getJObject(), info->jniClassRef, it->second.id, args);
+        env->CallNonvirtualVoidMethodV(jniObject->getBorrowedJObject(), info->jniClassRef, it->second.id, args);
         va_end(args);
     }
 
@@ -240,6 +287,71 @@ public:
     SETTER(Short, jshort)
     SETTER(Object, jobject)
 
+    /**
+     * same as above, but using handles as returned by JNIClassInfo::register*
+     * skips the lookup by name; handles always refer to the method/field they were registered for
+     * the handle has to be registered by the scope class or one of its baseclasses
+     */
+    void callJavaStaticVoidMethod(JNIMethodHandle method, ...) {
+        HANDLE_SCOPE(methodSlots, method)
+        JNIEnv* env = JNIWrapper::getEnvironment();
+        JNI_ASSERTF(info->methodSlots[method.slot].isStatic, "Attempt to call non-static method '%s' as static", info->methodSlots[method.slot].name.c_str());
+        va_list args;
+        va_start(args, method);
+        env->CallStaticVoidMethodV(info->jniClassRef, info->methodSlots[method.slot].id, args);
+        va_end(args);
+    }
+
+    STATIC_METHOD_HANDLE(Long, jlong)
+    STATIC_METHOD_HANDLE(Boolean, jboolean)
+    STATIC_METHOD_HANDLE(Byte, jbyte)
+    STATIC_METHOD_HANDLE(Char, jchar)
+    STATIC_METHOD_HANDLE(Double, jdouble)
+    STATIC_METHOD_HANDLE(Float, jfloat)
+    STATIC_METHOD_HANDLE(Int, jint)
+    STATIC_METHOD_HANDLE(Short, jshort)
+    STATIC_METHOD_HANDLE(Object, jobject)
+
+    STATIC_GETTER_HANDLE(Long, jlong)
+    STATIC_GETTER_HANDLE(Boolean, jboolean)
+    STATIC_GETTER_HANDLE(Byte, jbyte)
+    STATIC_GETTER_HANDLE(Char, jchar)
+    STATIC_GETTER_HANDLE(Double, jdouble)
+    STATIC_GETTER_HANDLE(Float, jfloat)
+    STATIC_GETTER_HANDLE(Int, jint)
+    STATIC_GETTER_HANDLE(Short, jshort)
+    STATIC_GETTER_HANDLE(Object, jobject)
+
+    STATIC_SETTER_HANDLE(Long, jlong)
+    STATIC_SETTER_HANDLE(Boolean, jboolean)
+    STATIC_SETTER_HANDLE(Byte, jbyte)
+    STATIC_SETTER_HANDLE(Char, jchar)
+    STATIC_SETTER_HANDLE(Double, jdouble)
+    STATIC_SETTER_HANDLE(Float, jfloat)
+    STATIC_SETTER_HANDLE(Int, jint)
+    STATIC_SETTER_HANDLE(Short, jshort)
+    STATIC_SETTER_HANDLE(Object, jobject)
+
+    GETTER_HANDLE(Long, jlong)
+    GETTER_HANDLE(Boolean, jboolean)
+    GETTER_HANDLE(Byte, jbyte)
+    GETTER_HANDLE(Char, jchar)
+    GETTER_HANDLE(Double, jdouble)
+    GETTER_HANDLE(Float, jfloat)
+    GETTER_HANDLE(Int, jint)
+    GETTER_HANDLE(Short, jshort)
+    GETTER_HANDLE(Object, jobject)
+
+    SETTER_HANDLE(Long, jlong)
+    SETTER_HANDLE(Boolean, jboolean)
+    SETTER_HANDLE(Byte, jbyte)
+    SETTER_HANDLE(Char, jchar)
+    SETTER_HANDLE(Double, jdouble)
+    SETTER_HANDLE(Float, jfloat)
+    SETTER_HANDLE(Int, jint)
+    SETTER_HANDLE(Short, jshort)
+    SETTER_HANDLE(Object, jobject)
+
 protected:
     virtual ~JNIScope() = default;
 };
@@ -0,0 +1,236 @@
+#include "JNIUTF.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define JNIUTF_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define JNIUTF_SSE2 1
+#endif
+
+#define UTF_REPLACEMENT_CHARACTER 0xFFFD
+
+/**
+ * converts the leading run of ASCII characters 8 at a time; returns the number of characters converted
+ */
+static inline size_t asciiUtf16ToUtf8(const uint16_t *src, size_t length, char *dst) {
+    size_t i = 0;
+#if defined(JNIUTF_NEON)
+    const uint16x8_t mask = vdupq_n_u16(0xFF80);
+    for (; i + 8 <= length; i += 8) {
+        uint16x8_t chars = vld1q_u16(src + i);
+        uint64x2_t high = vreinterpretq_u64_u16(vandq_u16(chars, mask));
+        if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1)) break;
+        vst1_u8((uint8_t*)dst + i, vmovn_u16(chars));
+    }
+#elif defined(JNIUTF_SSE2)
+    const __m128i mask = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= length; i += 8) {
+        __m128i chars = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chars, mask), zero)) != 0xFFFF) break;
+        _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(chars, chars));
+    }
+#endif
+    for (; i < length && src[i] < 0x80; i++) {
+        dst[i] = (char)src[i];
+    }
+    return i;
+}
+
+/**
+ * returns the length of the leading run of ASCII characters, checking 8 at a time
+ */
+static inline size_t asciiUtf16Length(const uint16_t *src, size_t length) {
+    size_t i = 0;
+#if defined(JNIUTF_NEON)
+    const uint16x8_t mask = vdupq_n_u16(0xFF80);
+    for (; i + 8 <= length; i += 8) {
+        uint64x2_t high = vreinterpretq_u64_u16(vandq_u16(vld1q_u16(src + i), mask));
+        if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1)) break;
+    }
+#elif defined(JNIUTF_SSE2)
+    const __m128i mask = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= length; i += 8) {
+        __m128i chars = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chars, mask), zero)) != 0xFFFF) break;
+    }
+#endif
+    for (; i < length && src[i] < 0x80; i++);
+    return i;
+}
+
+/**
+ * converts the leading run of ASCII characters 16 at a time; returns the number of characters converted
+ */
+static inline size_t asciiUtf8ToUtf16(const uint8_t *src, size_t length, uint16_t *dst) {
+    size_t i = 0;
+#if defined(JNIUTF_NEON)
+    const uint8x16_t mask = vdupq_n_u8(0x80);
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t chars = vld1q_u8(src + i);
+        uint64x2_t high = vreinterpretq_u64_u8(vandq_u8(chars, mask));
+        if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1)) break;
+        vst1q_u16(dst + i, vmovl_u8(vget_low_u8(chars)));
+        vst1q_u16(dst + i + 8, vmovl_u8(vget_high_u8(chars)));
+    }
+#elif defined(JNIUTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i chars = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(chars)) break;
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(chars, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(chars, zero));
+    }
+#endif
+    for (; i < length && src[i] < 0x80; i++) {
+        dst[i] = src[i];
+    }
+    return i;
+}
+
+static inline bool isContinuation(uint8_t c) {
+    return (c & 0xC0) == 0x80;
+}
+
+size_t JNIUTF::utf16ToUtf8(const uint16_t *src, size_t length, char *dst) {
+    size_t i = 0, o = 0;
+
+    while (i < length) {
+        size_t ascii = asciiUtf16ToUtf8(src + i, length - i, dst + o);
+        i += ascii;
+        o += ascii;
+        if (i >= length) break;
+
+        // stay scalar until two ascii characters in a row start a new run; probing after every character
+        // makes text with few or no ascii runs (latin-1, cjk) slower than not vectorizing at all
+        do {
+            uint32_t c = src[i++];
+            if (c < 0x80) {
+                dst[o++] = (char)c;
+                if (i < length && src[i] < 0x80) break;
+            } else if (c < 0x800) {
+                dst[o++] = (char)(0xC0 | (c >> 6));
+                dst[o++] = (char)(0x80 | (c & 0x3F));
+            } else if (c < 0xD800 || c > 0xDFFF) {
+                dst[o++] = (char)(0xE0 | (c >> 12));
+                dst[o++] = (char)(0x80 | ((c >> 6) & 0x3F));
+                dst[o++] = (char)(0x80 | (c & 0x3F));
+            } else if (c <= 0xDBFF && i < length && src[i] >= 0xDC00 && src[i] <= 0xDFFF) {
+                uint32_t codePoint = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)src[i++] - 0xDC00);
+                dst[o++] = (char)(0xF0 | (codePoint >> 18));
+                dst[o++] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+                dst[o++] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                dst[o++] = (char)(0x80 | (codePoint & 0x3F));
+            } else {
+                // unpaired surrogate
+                dst[o++] = '?';
+            }
+        } while (i < length);
+    }
+
+    return o;
+}
+
+size_t JNIUTF::utf16ToUtf8Length(const uint16_t *src, size_t length) {
+    size_t i = 0, o = 0;
+
+    while (i < length) {
+        size_t ascii = asciiUtf16Length(src + i, length - i);
+        i += ascii;
+        o += ascii;
+        if (i >= length) break;
+
+        // see utf16ToUtf8
+        do {
+            uint32_t c = src[i++];
+            if (c < 0xD800 || c > 0xDFFF) {
+                o += 1 + (c >= 0x80) + (c >= 0x800);
+                if (c < 0x80 && i < length && src[i] < 0x80) break;
+            } else if (c <= 0xDBFF && i < length && src[i] >= 0xDC00 && src[i] <= 0xDFFF) {
+                i++;
+                o += 4;
+            } else {
+                // unpaired surrogate is encoded as '?'
+                o++;
+            }
+        } while (i < length);
+    }
+
+    return o;
+}
+
+size_t JNIUTF::utf8ToUtf16(const char *source, size_t length, uint16_t *dst) {
+    auto src = (const uint8_t*)source;
+    size_t i = 0, o = 0;
+
+    while (i < length) {
+        size_t ascii = asciiUtf8ToUtf16(src + i, length - i, dst + o);
+        i += ascii;
+        o += ascii;
+        if (i >= length) break;
+
+        // see utf16ToUtf8
+        do {
+            uint8_t c = src[i];
+            if (c < 0x80) {
+                dst[o++] = c;
+                i++;
+                if (i < length && src[i] < 0x80) break;
+            } else if (c >= 0xC2 && c <= 0xDF) {
+                if (i + 1 < length && isContinuation(src[i + 1])) {
+                    dst[o++] = (uint16_t)(((c & 0x1F) << 6) | (src[i + 1] & 0x3F));
+                    i += 2;
+                } else {
+                    dst[o++] = UTF_REPLACEMENT_CHARACTER;
+                    i++;
+                }
+            } else if (c >= 0xE0 && c <= 0xEF) {
+                // exclude overlong encodings and surrogates
+                uint8_t lower = c == 0xE0 ? 0xA0 : 0x80, upper = c == 0xED ? 0x9F : 0xBF;
+                if (i + 1 < length && src[i + 1] >= lower && src[i + 1] <= upper) {
+                    if (i + 2 < length && isContinuation(src[i + 2])) {
+                        dst[o++] = (uint16_t)(((c & 0x0F) << 12) | ((src[i + 1] & 0x3F) << 6) | (src[i + 2] & 0x3F));
+                        i += 3;
+                    } else {
+                        dst[o++] = UTF_REPLACEMENT_CHARACTER;
+                        i += 2;
+                    }
+                } else {
+                    dst[o++] = UTF_REPLACEMENT_CHARACTER;
+                    i++;
+                }
+            } else if (c >= 0xF0 && c <= 0xF4) {
+                // exclude overlong encodings and code points above U+10FFFF
+                uint8_t lower = c == 0xF0 ? 0x90 : 0x80, upper = c == 0xF4 ? 0x8F : 0xBF;
+                size_t valid = 1;
+                if (i + 1 < length && src[i + 1] >= lower && src[i + 1] <= upper) {
+                    valid++;
+                    if (i + 2 < length && isContinuation(src[i + 2])) {
+                        valid++;
+                        if (i + 3 < length && isContinuation(src[i + 3])) {
+                            valid++;
+                        }
+                    }
+                }
+                if (valid == 4) {
+                    uint32_t codePoint = ((uint32_t)(c & 0x07) << 18) | ((uint32_t)(src[i + 1] & 0x3F) << 12) |
+                                         ((uint32_t)(src[i + 2] & 0x3F) << 6) | (uint32_t)(src[i + 3] & 0x3F);
+                    codePoint -= 0x10000;
+                    dst[o++] = (uint16_t)(0xD800 + (codePoint >> 10));
+                    dst[o++] = (uint16_t)(0xDC00 + (codePoint & 0x3FF));
+                } else {
+                    dst[o++] = UTF_REPLACEMENT_CHARACTER;
+                }
+                i += valid;
+            } else {
+                // continuation byte without lead byte, overlong two byte sequence or invalid lead byte
+                dst[o++] = UTF_REPLACEMENT_CHARACTER;
+                i++;
+            }
+        } while (i < length);
+    }
+
+    return o;
+}
@@ -0,0 +1,35 @@
+#ifndef ANDROID_TRADINGLIB_SAMPLE_JNIUTF_H
+#define ANDROID_TRADINGLIB_SAMPLE_JNIUTF_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * UTF-16 <=> UTF-8 transcoding used for converting between jstring and std::string
+ * runs of ASCII characters are converted with NEON/SSE2 if available
+ *
+ * invalid input is replaced the same way the Java UTF-8 charset does it:
+ * - unpaired surrogates are encoded as '?'
+ * - malformed UTF-8 sequences are decoded as U+FFFD (one per maximal invalid subsequence)
+ */
+class JNIUTF {
+public:
+    /**
+     * encodes UTF-16 as UTF-8
+     * dst must have room for utf16ToUtf8Length(src, length) bytes, which is never more than length * 3; returns the number of bytes written
+     */
+    static size_t utf16ToUtf8(const uint16_t *src, size_t length, char *dst);
+
+    /**
+     * returns the number of bytes utf16ToUtf8 writes for the specified input
+     */
+    static size_t utf16ToUtf8Length(const uint16_t *src, size_t length);
+
+    /**
+     * decodes UTF-8 as UTF-16
+     * dst must have room for at least length code units; returns the number of code units written
+     */
+    static size_t utf8ToUtf16(const char *src, size_t length, uint16_t *dst);
+};
+
+#endif //ANDROID_TRADINGLIB_SAMPLE_JNIUTF_H
@@ -5,7 +5,12 @@
 #include "stdlib.h"
 #include <jni.h>
 #include <cstdlib>
+#include <algorithm>
 #include "JNIWrapper.h"
+#include "JNIUTF.h"
+
+// strings up to this length (in UTF-16 code units) are converted using a buffer on the stack
+#define JNI_STRING_STACK_BUFFER_SIZE 256
 
 pthread_key_t JNIWrapper::_jniEnvKey = NULL;
 pthread_key_t JNIWrapper::_jniDetachThreadKey = NULL;
@@ -21,14 +26,22 @@ void JNIWrapper::init(JavaVM *vm) {
     pthread_key_create(&_jniDetachThreadKey, &detachThread);
     JNIEnv *env = JNIWrapper::getEnvironment();
 
-    _jniStringClass = (jclass)env->NewGlobalRef(env->FindClass("java/lang/String"));
-    _jniStringInit = env->GetMethodID(_jniStringClass, "<init>", "([BLjava/lang/String;)V");
-    _jniStringGetBytes = env->GetMethodID(_jniStringClass, "getBytes",
-                                          "(Ljava/lang/String;)[B");
-    _jniCharsetName = (jstring)env->NewGlobalRef(env->NewStringUTF("UTF-8"));
+    // classes are initialized lazily, possibly on natively attached threads that only see the system class loader
+    // => keep the class loader of the library around to be able to resolve application classes from anywhere
+    _jniClassClass = (jclass)env->NewGlobalRef(env->FindClass("java/lang/Class"));
+    _jniClassForNameId = env->GetStaticMethodID(_jniClassClass, "forName", "(Ljava/lang/String;ZLjava/lang/ClassLoader;)Ljava/lang/Class;");
+    jmethodID getClassLoaderId = env->GetMethodID(_jniClassClass, "getClassLoader", "()Ljava/lang/ClassLoader;");
+    jclass objectClass = env->FindClass(JNIBase::getCanonicalName<JNIObject>().c_str());
+    jobject classLoader = env->CallObjectMethod(objectClass, getClassLoaderId);
+    _jniClassLoader = env->NewGlobalRef(classLoader);
+    env->DeleteLocalRef(classLoader);
+    env->DeleteLocalRef(objectClass);
 
     _registerObject(typeid(JNIObject).hash_code(), JNIObjectType::kAbstract,
                     JNIBase::getCanonicalName<JNIObject>(), "", initialize<JNIObject>, nullptr);
+
+    // JNIObject is required by every other class and provides the natives used for registering & initializing them
+    _getClassInfo(JNIBase::getCanonicalName<JNIObject>());
 }
 
 bool JNIWrapper::isInitialized() {
@@ -36,22 +49,17 @@ bool JNIWrapper::isInitialized() {
 }
 
 bool JNIWrapper::isObjectInstanceOf(JNIObject *obj, const std::string &canonicalName) {
-    auto it = _objmap.find(canonicalName);
-    if(it == _objmap.end()) return false;
-    JNIClassInfo *info = it->second;
-    JNIClassInfo *info2 = obj->_jniClassInfo;
-    while(info2 != info) {
-        info2 = info2->baseClassInfo;
-        if(!info2) {
-            return false;
-        }
-    }
-    return true;
+    // classes that were not initialized yet can not have any instances
+    JNIClassInfo *info = _getClassInfo(canonicalName, false);
+    if(!info) return false;
+    return obj->_jniClassInfo->isSubclassOf(info);
 }
 
 void JNIWrapper::_registerObject(size_t hashCode, JNIObjectType type,
                                  const std::string &canonicalName, const std::string &baseCanonicalName,
                                  ObjectInitializer i, ObjectConstructor c) {
+    std::unique_lock<std::mutex> lock(_objmapMutex);
+
     // canonicalName may be already registered
     // (e.g. when called from JNI_OnLoad; when using multiple linked libraries it is called once for each library)
     if(_objmap.find(canonicalName) != _objmap.end()) {
@@ -102,22 +110,69 @@ void JNIWrapper::_registerObject(size_t hashCode, JNIObjectType type,
         }
     }
 
-    JNIEnv* env = JNIWrapper::getEnvironment();
+    auto *info = new JNIClassInfo(hashCode, type, canonicalName, i, c, baseInfo);
+    _objmap[canonicalName] = info;
+    lock.unlock();
+
+    // deferred classes are only declared here; everything that requires the java class is done on first use
+    if(!_deferClassInitialization.load(std::memory_order_relaxed)) {
+        _initializeClass(info);
+    }
+}
+
+JNIClassInfo* JNIWrapper::_getClassInfo(const std::string &canonicalName, bool initialize) {
+    JNIClassInfo *info;
+    {
+        std::lock_guard<std::mutex> lock(_objmapMutex);
+        auto it = _objmap.find(canonicalName);
+        if(it == _objmap.end()) return nullptr;
+        info = it->second;
+    }
+    if(initialize) {
+        if(!_initializeClass(info)) return nullptr;
+    } else if(!info->initialized.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return info;
+}
+
+bool JNIWrapper::_initializeClass(JNIClassInfo *info) {
+    if(info->initialized.load(std::memory_order_acquire)) return true;
 
-    // check if class exists
-    jclass clazz = env->FindClass(canonicalName.c_str());
+    // base classes have to be fully initialized first, because their fields and methods are inherited
+    if(info->baseClassInfo && !_initializeClass(info->baseClassInfo)) return false;
+
+    // the java class is loaded & initialized before acquiring the lock:
+    // its static initializer calls back into this method, possibly while another thread is already waiting for it
+    jclass clazz = findClass(info->canonicalName);
 
     // class has to exist...
-    JNI_ASSERTF(clazz != nullptr, "Class '%s' not found", canonicalName.c_str());
+    JNI_ASSERTF(clazz != nullptr, "Class '%s' not found", info->canonicalName.c_str());
+    if(!clazz) return false;
 
-    auto *info = new JNIClassInfo(hashCode, type, clazz, canonicalName, i, c, baseInfo);
-    _objmap[canonicalName] = info;
+    JNIEnv* env = JNIWrapper::getEnvironment();
+
+    std::lock_guard<std::recursive_mutex> lock(info->initMutex);
+    // initializing is only ever true here if this is a recursive call from the same thread
+    if(info->initialized.load(std::memory_order_relaxed) || info->initializing) {
+        env->DeleteLocalRef(clazz);
+        return true;
+    }
+    info->initializing = true;
+
+    // cache class
+    // if we wanted to allow dynamic class unloading we could use a weak global ref and check it every time before creating/wrapping an object
+    // but because that might happen from another thread we would have to make sure to use the correct class loader to require it..
+    // => for now we do not need it, as it can safely be assumed that most (if not all) jni classes will likely be used throughout the whole lifetime of the application
+    // so we are using a strong reference; this will ALWAYS keep the class from getting unloaded (e.g. if a future android version changes behaviour)
+    info->jniClassRef = (jclass)env->NewGlobalRef(clazz);
+    env->DeleteLocalRef(clazz);
 
     info->inherit();
 
     // if it is a persistent class, and has no base class, register the field for storing the native class
     // => this is only for JNIObject! ALL other objects have a baseclass
-    if(!baseInfo) {
+    if(!info->baseClassInfo) {
         info->registerField("nativeHandle", "J");
         _jniNativeHandleFieldID = info->fieldMap["nativeHandle"].id;
     }
@@ -125,7 +180,7 @@ void JNIWrapper::_registerObject(size_t hashCode, JNIObjectType type,
     // check if a default constructor without arguments is available
     jmethodID constructor = info->getMethodID("<init>","()V",false);
     if(constructor) {
-        info->methodMap["<init>"] = {false, "<init>", "()V", constructor};
+        info->methodMap["<init>"] = {false, "<init>", "()V", constructor, -1};
     }
 
     // call static initializer (for java derived classes it is empty)
@@ -133,7 +188,7 @@ void JNIWrapper::_registerObject(size_t hashCode, JNIObjectType type,
         info->initializer(info, false);
         // register methods
         if (!info->methods.empty()) {
-            env->RegisterNatives(clazz, &info->methods[0], (jint)info->methods.size());
+            env->RegisterNatives(info->jniClassRef, &info->methods[0], (jint)info->methods.size());
 
             // free pointers that were allocated in registerNativeMethod
             for (auto &entry : info->methods) {
@@ -143,6 +198,57 @@ void JNIWrapper::_registerObject(size_t hashCode, JNIObjectType type,
             info->methods.clear();
         }
     }
+
+    info->initializing = false;
+    info->initialized.store(true, std::memory_order_release);
+
+    return true;
+}
+
+void JNIWrapper::setDeferClassInitialization(bool defer) {
+    _deferClassInitialization.store(defer, std::memory_order_relaxed);
+}
+
+bool JNIWrapper::initializeClass(const std::string &canonicalName) {
+    JNIClassInfo *info = _getClassInfo(canonicalName);
+    JNI_ASSERTF(info, "Attempt to initialize unknown class '%s'", canonicalName.c_str());
+    return info != nullptr;
+}
+
+void JNIWrapper::preloadClasses(const std::vector<std::string> &canonicalNames) {
+    auto names = new std::vector<std::string>(canonicalNames);
+    pthread_t thread;
+    if(pthread_create(&thread, nullptr, &JNIWrapper::preloadThread, names) == 0) {
+        pthread_detach(thread);
+    } else {
+        delete names;
+    }
+}
+
+void* JNIWrapper::preloadThread(void *data) {
+    auto names = reinterpret_cast<std::vector<std::string>*>(data);
+    // thread is attached on first access to the environment, and detached again when it exits
+    for(auto &name : *names) {
+        _getClassInfo(name);
+    }
+    delete names;
+    return nullptr;
+}
+
+jclass JNIWrapper::findClass(const std::string &canonicalName) {
+    JNIEnv *env = JNIWrapper::getEnvironment();
+
+    std::string binaryName = canonicalName;
+    std::replace(binaryName.begin(), binaryName.end(), '/', '.');
+
+    jstring nameRef = env->NewStringUTF(binaryName.c_str());
+    auto clazz = (jclass)env->CallStaticObjectMethod(_jniClassClass, _jniClassForNameId, nameRef, JNI_TRUE, _jniClassLoader);
+    env->DeleteLocalRef(nameRef);
+    if(env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return nullptr;
+    }
+    return clazz;
 }
 
 JNIEnv* JNIWrapper::getEnvironment() {
@@ -165,21 +271,19 @@ void JNIWrapper::initializeNativeObject(jobject object, jstring className) {
     std::replace(canonicalName.begin(), canonicalName.end(), '.', '/');
 
     // now retrieve registered native class
-    auto it = _objmap.find(canonicalName);
+    JNIClassInfo *info = _getClassInfo(canonicalName);
 
     // if nothing was found, the class was not registered
-    JNI_ASSERTF(it != _objmap.end(), "Encountered unknown class '%s' during initialization", canonicalName.c_str());
+    JNI_ASSERTF(info, "Encountered unknown class '%s' during initialization", canonicalName.c_str());
 
-    JNIClassInfo *info = it->second;
     info->constructor(object, info);
 }
 
 jobject JNIWrapper::_createObject(const std::string& canonicalName, const char* constructorAlias, va_list constructorArgs) {
-    auto it = _objmap.find(canonicalName);
-    if (it == _objmap.end()) {
+    JNIClassInfo *info = _getClassInfo(canonicalName);
+    if (!info) {
         return nullptr;
     } else {
-        JNIClassInfo *info = it->second;
 
         if(info->type == JNIObjectType::kAbstract) return nullptr;
 
@@ -197,11 +301,10 @@ jobject JNIWrapper::_createObject(const std::string& canonicalName, const char*
 }
 
 std::shared_ptr<JNIClass> JNIWrapper::_wrapClass(const std::string& canonicalName) {
-    auto it = _objmap.find(canonicalName);
-    if (it == _objmap.end()){
+    JNIClassInfo *info = _getClassInfo(canonicalName);
+    if (!info){
         return nullptr;
     } else {
-        JNIClassInfo *info = it->second;
         return std::shared_ptr<JNIClass>(new JNIClass(info));
     }
 }
@@ -218,15 +321,29 @@ std::string JNIWrapper::jstring2string(jstring string) {
         return "";
     }
 
-    const auto stringJbytes = (jbyteArray) env->CallObjectMethod(string, _jniStringGetBytes, _jniCharsetName);
-    const jsize length = env->GetArrayLength(stringJbytes);
-    jbyte* pBytes = env->GetByteArrayElements(stringJbytes, nullptr);
-
-    std::string ret = std::string((char *)pBytes, (unsigned long)length);
+    // transcode natively instead of calling String.getBytes
+    const size_t length = (size_t)env->GetStringLength(string);
+    if(!length) return "";
 
-    env->ReleaseByteArrayElements(stringJbytes, pBytes, JNI_ABORT);
-    env->DeleteLocalRef(stringJbytes);
+    const jchar *chars = env->GetStringCritical(string, nullptr);
+    if(!chars) {
+        // out of memory; an exception is pending
+        return "";
+    }
 
+    std::string ret;
+    if(length <= JNI_STRING_STACK_BUFFER_SIZE) {
+        // every UTF-16 code unit takes up at most 3 bytes
+        char stackBuffer[JNI_STRING_STACK_BUFFER_SIZE * 3];
+        size_t written = JNIUTF::utf16ToUtf8((const uint16_t*)chars, length, stackBuffer);
+        env->ReleaseStringCritical(string, chars);
+        ret.assign(stackBuffer, written);
+    } else {
+        // size the result exactly, so that long strings do not keep up to three times their size in capacity
+        ret.resize(JNIUTF::utf16ToUtf8Length((const uint16_t*)chars, length));
+        JNIUTF::utf16ToUtf8((const uint16_t*)chars, length, &ret[0]);
+        env->ReleaseStringCritical(string, chars);
+    }
     return ret;
 }
 
@@ -237,22 +354,26 @@ jstring JNIWrapper::string2jstring(const std::string& string) {
     JNIEnv *env = JNIWrapper::getEnvironment();
     JNI_ASSERT(env, "JNI Environment not initialized");
 
-    auto len = (jsize)string.length();
-
-    const jbyteArray bytes = env->NewByteArray(len);
-    env->SetByteArrayRegion(bytes, 0, len, (jbyte*)string.c_str());
-
-    auto javaString = (jstring)env->NewObject(_jniStringClass, _jniStringInit, bytes, _jniCharsetName);
+    // a UTF-8 string never decodes to more UTF-16 code units than it has bytes
+    size_t len = string.length();
+    jchar stackBuffer[JNI_STRING_STACK_BUFFER_SIZE];
+    std::unique_ptr<jchar[]> heapBuffer;
+    jchar *chars = stackBuffer;
+    if(len > JNI_STRING_STACK_BUFFER_SIZE) {
+        heapBuffer.reset(new jchar[len]);
+        chars = heapBuffer.get();
+    }
 
-    env->DeleteLocalRef(bytes);
+    size_t written = JNIUTF::utf8ToUtf16(string.data(), len, (uint16_t*)chars);
 
-    return javaString;
+    return env->NewString(chars, (jsize)written);
 }
 
 std::map<std::string, JNIClassInfo*> JNIWrapper::_objmap;
+std::mutex JNIWrapper::_objmapMutex;
+std::atomic<bool> JNIWrapper::_deferClassInitialization(false);
+jclass JNIWrapper::_jniClassClass = nullptr;
+jmethodID JNIWrapper::_jniClassForNameId = nullptr;
+jobject JNIWrapper::_jniClassLoader = nullptr;
 jfieldID JNIWrapper::_jniNativeHandleFieldID = nullptr;
-JavaVM* JNIWrapper::_jniVM = nullptr;
-jstring JNIWrapper::_jniCharsetName = nullptr;
-jclass JNIWrapper::_jniStringClass = nullptr;
-jmethodID JNIWrapper::_jniStringInit = nullptr;
-jmethodID JNIWrapper::_jniStringGetBytes = nullptr;
\ No newline at end of file
+JavaVM* JNIWrapper::_jniVM = nullptr;
\ No newline at end of file
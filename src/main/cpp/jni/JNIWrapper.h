@@ -12,6 +12,8 @@
 #include "jni_assert.h"
 #include <unistd.h>
 #include <pthread.h>
+#include <atomic>
+#include <mutex>
 
 #include "JNIRef.h"
 #include "JNIClassInfo.h"
@@ -29,7 +31,26 @@ public:
      */
     static bool isObjectInstanceOf(JNIObject *obj, const std::string &canonicalName);
     template<class ObjectType> static bool isObjectInstanceOf(JNIObject *obj) {
-        return isObjectInstanceOf(obj, JNIBase::getCanonicalName<ObjectType>());
+        JNIClassInfo *info = getClassInfo<ObjectType>();
+        return info && obj->_jniClassInfo->isSubclassOf(info);
+    }
+
+    /**
+     * returns the class info registered for the specified native object type, or nullptr if it was not registered
+     * the class is initialized if that did not happen yet
+     * the result is cached per type, so only the first call has to look it up by name
+     */
+    template<class ObjectType> static
+    JNIClassInfo* getClassInfo() {
+        // class infos are never deallocated, so once resolved the pointer stays valid
+        static std::atomic<JNIClassInfo*> cachedInfo(nullptr);
+        JNIClassInfo *info = cachedInfo.load(std::memory_order_acquire);
+        if(!info) {
+            info = _getClassInfo(JNIBase::getCanonicalName<ObjectType>());
+            if(!info) return nullptr;
+            cachedInfo.store(info, std::memory_order_release);
+        }
+        return info;
     }
 
     /**
@@ -140,11 +161,10 @@ public:
      */
     template <typename ObjectType> static
     JNILocalRef<ObjectType> wrapObject(jobject object) {
-        auto it = _objmap.find(JNIBase::getCanonicalName<ObjectType>());
-        if (!object || it == _objmap.end()){
+        JNIClassInfo *info = object ? getClassInfo<ObjectType>() : nullptr;
+        if (!info){
             return nullptr;
         } else {
-            JNIClassInfo *info = it->second;
             JNIObject *jniObject;
             JNIEnv* env = JNIWrapper::getEnvironment();
             if(info->type == JNIObjectType::kPersistent || info->type == JNIObjectType::kAbstract) {
@@ -160,12 +180,8 @@ public:
                 }
                 jniObject = reinterpret_cast<JNIObject*>(handle);
                 // now check if this object is an instance of `ObjectType`
-                JNIClassInfo *info2 = jniObject->_jniClassInfo;
-                while(info2 != info) {
-                    info2 = info2->baseClassInfo;
-                    if(!info2) {
-                        return nullptr;
-                    }
+                if(!jniObject->_jniClassInfo->isSubclassOf(info)) {
+                    return nullptr;
                 }
             } else {
                 jniObject = new ObjectType(object, info);
@@ -201,24 +217,55 @@ public:
      * - createObject<NativeType>() if you want to create a new Java+Native object tuple
      */
     static void initializeNativeObject(jobject object, jstring canonicalName);
+
+    /**
+     * by default a class is initialized when it is registered: the java class is resolved, ids are cached and natives are registered
+     * classes registered while deferred initialization is enabled are only declared, and initialized on first use of the class instead
+     * only enable it around registrations of classes whose java side calls JNIObject.InitializeClass from its static initializer;
+     * otherwise static natives are not bound if they are called before the class is used from native code
+     */
+    static void setDeferClassInitialization(bool defer);
+
+    /**
+     * initializes a class that was registered with deferred initialization; this can be called to do it upfront
+     * java classes declaring native methods need to call this via JNIObject.InitializeClass from their static initializer
+     * thread-safe; calling it for a class that was already initialized is a no-op
+     */
+    static bool initializeClass(const std::string &canonicalName);
+
+    /**
+     * initializes the specified classes on a background thread
+     */
+    static void preloadClasses(const std::vector<std::string> &canonicalNames);
+
+    /**
+     * loads and initializes the java class with the specified canonical name (e.g. "ag/boersego/bgjs/JNIObject")
+     * in contrast to JNIEnv::FindClass this also works on natively attached threads, because it uses the class loader of the library
+     * returns nullptr if the class does not exist
+     */
+    static jclass findClass(const std::string &canonicalName);
 private:
     static void detachThread(void* _);
+    static void* preloadThread(void *data);
     // Factory method for creating objects
     static jobject _createObject(const std::string& canonicalName, const char* constructorAlias, va_list constructorArgs);
     static std::shared_ptr<JNIClass> _wrapClass(const std::string& canonicalName);
 
     static void _registerObject(size_t hashCode, JNIObjectType type, const std::string& canonicalName, const std::string& baseCanonicalName, ObjectInitializer i, ObjectConstructor c);
+    static JNIClassInfo* _getClassInfo(const std::string& canonicalName, bool initialize = true);
+    static bool _initializeClass(JNIClassInfo *info);
 
     static JavaVM *_jniVM;
     static pthread_key_t _jniEnvKey, _jniDetachThreadKey;
     static jfieldID _jniNativeHandleFieldID;
 
-    static jclass _jniStringClass;
-    static jmethodID _jniStringGetBytes;
-    static jmethodID _jniStringInit;
-    static jstring _jniCharsetName;
-
     static std::map<std::string, JNIClassInfo*> _objmap;
+    static std::mutex _objmapMutex;
+    static std::atomic<bool> _deferClassInitialization;
+
+    static jclass _jniClassClass;
+    static jmethodID _jniClassForNameId;
+    static jobject _jniClassLoader;
 
     template<class ObjectType>
     static JNIObject* instantiate(jobject obj, JNIClassInfo *info) {
@@ -0,0 +1,125 @@
+#include "BGJSHandleTracker.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <v8.h>
+
+// number of JavaScript frames stored per allocation site
+#define HANDLE_TRACKER_STACK_FRAMES 8
+
+std::atomic<bool> BGJSHandleTracker::_enabled(false);
+std::atomic<bool> BGJSHandleTracker::_captureJSStack(false);
+std::mutex BGJSHandleTracker::_mutex;
+std::unordered_map<std::string, BGJSHandleTracker::Site> BGJSHandleTracker::_sites;
+std::unordered_map<const void*, BGJSHandleTracker::Site*> BGJSHandleTracker::_handles;
+
+static const char* kindName(BGJSHandleTracker::Kind kind) {
+    switch(kind) {
+        case BGJSHandleTracker::Kind::kPersistent: return "persistent";
+        case BGJSHandleTracker::Kind::kGlobalRef: return "global";
+        case BGJSHandleTracker::Kind::kWeakGlobalRef: return "weak global";
+    }
+    return "unknown";
+}
+
+void BGJSHandleTracker::setEnabled(bool enabled, bool captureJSStack) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _captureJSStack.store(captureJSStack, std::memory_order_relaxed);
+    if(!enabled) {
+        _handles.clear();
+        _sites.clear();
+    }
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::string BGJSHandleTracker::captureJSStack() {
+    v8::Isolate *isolate = v8::Isolate::GetCurrent();
+    if(!isolate || !isolate->InContext()) return std::string();
+
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::StackTrace> stackTrace = v8::StackTrace::CurrentStackTrace(isolate, HANDLE_TRACKER_STACK_FRAMES);
+
+    std::string result;
+    for(int i = 0, n = stackTrace->GetFrameCount(); i < n; i++) {
+        v8::Local<v8::StackFrame> frame = stackTrace->GetFrame(isolate, (uint32_t)i);
+        v8::String::Utf8Value function(isolate, frame->GetFunctionName());
+        v8::String::Utf8Value script(isolate, frame->GetScriptName());
+        result += "\n    at ";
+        result += function.length() ? *function : "<anonymous>";
+        result += " (";
+        result += script.length() ? *script : "<unknown>";
+        result += ":" + std::to_string(frame->GetLineNumber()) + ":" + std::to_string(frame->GetColumn()) + ")";
+    }
+    return result;
+}
+
+void BGJSHandleTracker::track(Kind kind, const void *handle, const char *file, int line) {
+    std::string stack;
+    if(_captureJSStack.load(std::memory_order_relaxed)) {
+        stack = captureJSStack();
+    }
+
+    std::string key = std::string(file) + ":" + std::to_string(line) + ":" + std::to_string((int)kind) + stack;
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    if(!_enabled.load(std::memory_order_relaxed)) return;
+
+    auto it = _sites.find(key);
+    if(it == _sites.end()) {
+        it = _sites.insert(std::make_pair(std::move(key), Site{kind, file, line, std::move(stack), 0, 0})).first;
+    }
+    Site *site = &it->second;
+
+    // persistents can be reset to a new value without being cleared first
+    auto handleIt = _handles.find(handle);
+    if(handleIt != _handles.end()) {
+        handleIt->second->live--;
+        handleIt->second = site;
+    } else {
+        _handles[handle] = site;
+    }
+    site->live++;
+    site->total++;
+}
+
+void BGJSHandleTracker::untrack(const void *handle) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto it = _handles.find(handle);
+    if(it == _handles.end()) return;
+    it->second->live--;
+    _handles.erase(it);
+}
+
+size_t BGJSHandleTracker::getCount(Kind kind) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    size_t count = 0;
+    for(auto &it : _sites) {
+        if(it.second.kind == kind) count += it.second.live;
+    }
+    return count;
+}
+
+std::string BGJSHandleTracker::dump() {
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    std::vector<const Site*> sites;
+    size_t counts[3] = {0, 0, 0};
+    for(auto &it : _sites) {
+        if(!it.second.live) continue;
+        sites.push_back(&it.second);
+        counts[(int)it.second.kind] += it.second.live;
+    }
+    std::sort(sites.begin(), sites.end(), [](const Site *a, const Site *b) {
+        return a->live > b->live;
+    });
+
+    std::string result = "live handles: " + std::to_string(counts[0]) + " persistent, " +
+            std::to_string(counts[1]) + " global, " + std::to_string(counts[2]) + " weak global\n";
+    for(const Site *site : sites) {
+        const char *file = strrchr(site->file, '/');
+        result += std::to_string(site->live) + " of " + std::to_string(site->total) + " " + kindName(site->kind) + " " +
+                (file ? file + 1 : site->file) + ":" + std::to_string(site->line) + site->stack + "\n";
+    }
+    return result;
+}
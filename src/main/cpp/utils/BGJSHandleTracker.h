@@ -0,0 +1,94 @@
+#ifndef __BGJSHANDLETRACKER_H
+#define __BGJSHANDLETRACKER_H 1
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <jni.h>
+
+/**
+ * BGJSHandleTracker
+ * Opt-in registry of live v8::Persistent handles and JNI global/weak global references, counted per allocation site
+ *
+ * Handles are registered through the BGJS_*_PERSISTENT and BGJS_*_GLOBAL_REF macros.
+ * While tracking is disabled the macros only cost a single relaxed atomic load.
+ * Tracking is process wide; handles created before tracking was enabled are not reported.
+ */
+class BGJSHandleTracker {
+public:
+    enum class Kind {
+        kPersistent,
+        kGlobalRef,
+        kWeakGlobalRef
+    };
+
+    static inline bool isEnabled() {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * enables or disables tracking; all recorded handles are discarded when tracking is disabled
+     * if captureJSStack is set, the current JavaScript stack is stored as part of the allocation site
+     */
+    static void setEnabled(bool enabled, bool captureJSStack = false);
+
+    static void track(Kind kind, const void *handle, const char *file, int line);
+    static void untrack(const void *handle);
+
+    template<typename T>
+    static inline T tracked(Kind kind, T ref, const char *file, int line) {
+        if(isEnabled() && ref) track(kind, ref, file, line);
+        return ref;
+    }
+
+    /**
+     * returns the number of live handles of the specified kind
+     */
+    static size_t getCount(Kind kind);
+
+    /**
+     * returns a human readable list of all allocation sites with live handles, sorted by number of handles
+     */
+    static std::string dump();
+
+private:
+    struct Site {
+        Kind kind;
+        const char *file;
+        int line;
+        std::string stack;
+        size_t live, total;
+    };
+
+    static std::string captureJSStack();
+
+    static std::atomic<bool> _enabled;
+    static std::atomic<bool> _captureJSStack;
+    static std::mutex _mutex;
+    static std::unordered_map<std::string, Site> _sites;
+    static std::unordered_map<const void*, Site*> _handles;
+};
+
+#define BGJS_NEW_GLOBAL_REF(env, obj) BGJSHandleTracker::tracked(BGJSHandleTracker::Kind::kGlobalRef, (env)->NewGlobalRef(obj), __FILE__, __LINE__)
+#define BGJS_NEW_WEAK_GLOBAL_REF(env, obj) BGJSHandleTracker::tracked(BGJSHandleTracker::Kind::kWeakGlobalRef, (env)->NewWeakGlobalRef(obj), __FILE__, __LINE__)
+
+#define BGJS_DELETE_GLOBAL_REF(env, ref) do { \
+        if(BGJSHandleTracker::isEnabled()) BGJSHandleTracker::untrack(ref); \
+        (env)->DeleteGlobalRef(ref); \
+    } while(0)
+
+#define BGJS_DELETE_WEAK_GLOBAL_REF(env, ref) do { \
+        if(BGJSHandleTracker::isEnabled()) BGJSHandleTracker::untrack(ref); \
+        (env)->DeleteWeakGlobalRef(ref); \
+    } while(0)
+
+#define BGJS_TRACK_PERSISTENT(pers) do { \
+        if(BGJSHandleTracker::isEnabled()) BGJSHandleTracker::track(BGJSHandleTracker::Kind::kPersistent, &(pers), __FILE__, __LINE__); \
+    } while(0)
+
+#define BGJS_UNTRACK_PERSISTENT(pers) do { \
+        if(BGJSHandleTracker::isEnabled()) BGJSHandleTracker::untrack(&(pers)); \
+    } while(0)
+
+#endif
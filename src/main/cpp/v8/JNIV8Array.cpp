@@ -6,10 +6,56 @@
 #include "JNIV8Wrapper.h"
 #include "../bgjs/BGJSV8Engine.h"
 
+#include <algorithm>
+#include <vector>
+
 BGJS_JNI_LINK(JNIV8Array, "ag/boersego/bgjs/JNIV8Array");
 
 decltype(JNIV8Array::_jniObject) JNIV8Array::_jniObject = {0};
 
+// number of elements copied between java and native memory at once when converting primitive arrays
+#define JNIV8ARRAY_PRIMITIVE_CHUNK 512
+
+/**
+ * conversion of double[] from and to js arrays
+ */
+struct JNIV8ArrayDoubleTraits {
+    typedef jdouble Type;
+    typedef jdoubleArray ArrayType;
+    static const JNIV8JavaValueType valueType = JNIV8JavaValueType::kDouble;
+
+    static ArrayType newArray(JNIEnv *env, jsize length) { return env->NewDoubleArray(length); }
+    static void getRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, Type *buffer) { env->GetDoubleArrayRegion(array, start, length, buffer); }
+    static void setRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const Type *buffer) { env->SetDoubleArrayRegion(array, start, length, buffer); }
+    static bool getFast(v8::Local<v8::Value> value, Type *target) {
+        if(!value->IsNumber()) return false;
+        *target = value.As<v8::Number>()->Value();
+        return true;
+    }
+    static Type fromJavaValue(const jvalue &value) { return value.d; }
+    static v8::Local<v8::Value> toV8(v8::Isolate *isolate, Type value) { return v8::Number::New(isolate, value); }
+};
+
+/**
+ * conversion of int[] from and to js arrays
+ */
+struct JNIV8ArrayIntTraits {
+    typedef jint Type;
+    typedef jintArray ArrayType;
+    static const JNIV8JavaValueType valueType = JNIV8JavaValueType::kInteger;
+
+    static ArrayType newArray(JNIEnv *env, jsize length) { return env->NewIntArray(length); }
+    static void getRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, Type *buffer) { env->GetIntArrayRegion(array, start, length, buffer); }
+    static void setRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const Type *buffer) { env->SetIntArrayRegion(array, start, length, buffer); }
+    static bool getFast(v8::Local<v8::Value> value, Type *target) {
+        if(!value->IsInt32()) return false;
+        *target = value.As<v8::Int32>()->Value();
+        return true;
+    }
+    static Type fromJavaValue(const jvalue &value) { return value.i; }
+    static v8::Local<v8::Value> toV8(v8::Isolate *isolate, Type value) { return v8::Integer::New(isolate, value); }
+};
+
 /**
  * cache JNI class references
  */
@@ -26,9 +72,13 @@ void JNIV8Array::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
     info->registerNativeMethod("Create", "(Lag/boersego/bgjs/V8Engine;)Lag/boersego/bgjs/JNIV8Array;", (void*)JNIV8Array::jniCreate);
     info->registerNativeMethod("CreateWithLength", "(Lag/boersego/bgjs/V8Engine;I)Lag/boersego/bgjs/JNIV8Array;", (void*)JNIV8Array::jniCreateWithLength);
     info->registerNativeMethod("CreateWithArray", "(Lag/boersego/bgjs/V8Engine;[Ljava/lang/Object;)Lag/boersego/bgjs/JNIV8Array;", (void*)JNIV8Array::jniCreateWithArray);
+    info->registerNativeMethod("CreateWithDoubleArray", "(Lag/boersego/bgjs/V8Engine;[D)Lag/boersego/bgjs/JNIV8Array;", (void*)JNIV8Array::jniCreateWithDoubleArray);
+    info->registerNativeMethod("CreateWithIntArray", "(Lag/boersego/bgjs/V8Engine;[I)Lag/boersego/bgjs/JNIV8Array;", (void*)JNIV8Array::jniCreateWithIntArray);
     info->registerNativeMethod("getV8Length", "()I", (void*)JNIV8Array::jniGetV8Length);
     info->registerNativeMethod("_getV8Elements", "(IILjava/lang/Class;II)[Ljava/lang/Object;", (void*)JNIV8Array::jniGetV8ElementsInRange);
     info->registerNativeMethod("_getV8Element", "(IILjava/lang/Class;I)Ljava/lang/Object;", (void*)JNIV8Array::jniGetV8Element);
+    info->registerNativeMethod("_getV8ElementsAsDoubleArray", "(II)[D", (void*)JNIV8Array::jniGetV8ElementsAsDoubleArray);
+    info->registerNativeMethod("_getV8ElementsAsIntArray", "(II)[I", (void*)JNIV8Array::jniGetV8ElementsAsIntArray);
 }
 
 /**
@@ -159,6 +209,89 @@ jobject JNIV8Array::jniGetV8Element(JNIEnv *env, jobject obj, jint flags, jint t
     return jval.l;
 }
 
+jdoubleArray JNIV8Array::jniGetV8ElementsAsDoubleArray(JNIEnv *env, jobject obj, jint from, jint to) {
+    return getElementsAsPrimitiveArray<JNIV8ArrayDoubleTraits>(env, obj, from, to);
+}
+
+jintArray JNIV8Array::jniGetV8ElementsAsIntArray(JNIEnv *env, jobject obj, jint from, jint to) {
+    return getElementsAsPrimitiveArray<JNIV8ArrayIntTraits>(env, obj, from, to);
+}
+
+template<typename Traits>
+typename Traits::ArrayType JNIV8Array::getElementsAsPrimitiveArray(JNIEnv *env, jobject obj, jint from, jint to) {
+    JNIV8Object_PrepareJNICall(JNIV8Array, v8::Array, nullptr);
+
+    uint32_t len = localRef->Length();
+    uint32_t size;
+
+    // clamp range
+    if(to>=len) to = len - 1;
+    if(from<0) from = 0;
+
+    // now determine size of slice
+    if(from < len && from <= to) {
+        size = (uint32_t)((to-from)+1);
+    } else {
+        size = 0;
+    }
+
+    typename Traits::ArrayType elements = Traits::newArray(env, size);
+    if(!size) return elements;
+
+    // only used for elements that are not stored as numbers, e.g. holes or mixed arrays
+    const JNIV8JavaValue arg = JNIV8Marshalling::valueWithType(Traits::valueType, false, JNIV8MarshallingFlags::kNonNull);
+
+    // elements are collected in chunks; this keeps the number of JNI calls low without allocating a buffer for the whole array
+    typename Traits::Type buffer[JNIV8ARRAY_PRIMITIVE_CHUNK];
+    uint32_t numBuffered = 0;
+
+    for(uint32_t i=(uint32_t)from; i<=(uint32_t)to; i++) {
+        v8::Local<v8::Value> value;
+        if(!localRef->Get(context, i).ToLocal(&value)) {
+            // a getter threw an exception
+            engine->forwardV8ExceptionToJNI(&try_catch);
+            return nullptr;
+        }
+
+        if(!Traits::getFast(value, &buffer[numBuffered])) {
+            jvalue jval;
+            memset(&jval, 0, sizeof(jvalue));
+            JNIV8MarshallingError res = JNIV8Marshalling::convertV8ValueToJavaValue(env, value, arg, &jval);
+            if(res != JNIV8MarshallingError::kOk) {
+                // conversion errors are thrown directly to the java caller, like in JNIV8Object::jniGetV8Fields
+                switch(res) {
+                    default:
+                    case JNIV8MarshallingError::kWrongType:
+                        ThrowJNICastError("wrong type for value of element #" + std::to_string(i));
+                        break;
+                    case JNIV8MarshallingError::kUndefined:
+                        ThrowJNICastError("value of element #" + std::to_string(i) + " must not be undefined");
+                        break;
+                    case JNIV8MarshallingError::kNoNaN:
+                        ThrowJNICastError("value of element #" + std::to_string(i) + " must not be NaN");
+                        break;
+                    case JNIV8MarshallingError::kOutOfRange:
+                        ThrowJNICastError("value '"+
+                                          JNIV8Marshalling::v8string2string(value->ToString(isolate))+"' is out of range for element #" + std::to_string(i));
+                        break;
+                }
+                return nullptr;
+            }
+            buffer[numBuffered] = Traits::fromJavaValue(jval);
+        }
+
+        if(++numBuffered == JNIV8ARRAY_PRIMITIVE_CHUNK) {
+            Traits::setRegion(env, elements, (jsize)(i + 1 - numBuffered - from), (jsize)numBuffered, buffer);
+            numBuffered = 0;
+        }
+    }
+    if(numBuffered) {
+        Traits::setRegion(env, elements, (jsize)(size - numBuffered), (jsize)numBuffered, buffer);
+    }
+
+    return elements;
+}
+
 jobject JNIV8Array::jniCreate(JNIEnv *env, jobject obj, jobject engineObj) {
     return jniCreateWithLength(env, obj, engineObj, 0);
 }
@@ -188,16 +321,50 @@ jobject JNIV8Array::jniCreateWithArray(JNIEnv *env, jobject obj, jobject engineO
     v8::HandleScope scope(isolate);
     v8::Context::Scope ctxScope(engine->getContext());
 
+    // creating the array from all elements at once is a lot faster than setting them one by one
     jsize numArgs = env->GetArrayLength(elements);
-    v8::Local<v8::Object> objRef = v8::Array::New(isolate, numArgs);
-    if (numArgs) {
-        jobject obj;
-        for(jsize i=0; i<numArgs; i++) {
-            obj = env->GetObjectArrayElement(elements, i);
-            objRef->Set(i, JNIV8Marshalling::jobject2v8value(obj));
-            env->DeleteLocalRef(obj);
+    std::vector<v8::Local<v8::Value>> values((size_t)numArgs);
+    for(jsize i=0; i<numArgs; i++) {
+        jobject obj = env->GetObjectArrayElement(elements, i);
+        values[i] = JNIV8Marshalling::jobject2v8value(obj);
+        env->DeleteLocalRef(obj);
+    }
+    v8::Local<v8::Object> objRef = v8::Array::New(isolate, values.data(), values.size());
+
+    return JNIV8Wrapper::wrapObject<JNIV8Array>(objRef)->getJObject();
+}
+
+jobject JNIV8Array::jniCreateWithDoubleArray(JNIEnv *env, jobject obj, jobject engineObj, jdoubleArray elements) {
+    return createWithPrimitiveArray<JNIV8ArrayDoubleTraits>(env, engineObj, elements);
+}
+
+jobject JNIV8Array::jniCreateWithIntArray(JNIEnv *env, jobject obj, jobject engineObj, jintArray elements) {
+    return createWithPrimitiveArray<JNIV8ArrayIntTraits>(env, engineObj, elements);
+}
+
+template<typename Traits>
+jobject JNIV8Array::createWithPrimitiveArray(JNIEnv *env, jobject engineObj, typename Traits::ArrayType elements) {
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Context::Scope ctxScope(engine->getContext());
+
+    jsize numElements = env->GetArrayLength(elements);
+    std::vector<v8::Local<v8::Value>> values((size_t)numElements);
+
+    typename Traits::Type buffer[JNIV8ARRAY_PRIMITIVE_CHUNK];
+    for(jsize start=0; start<numElements; start+=JNIV8ARRAY_PRIMITIVE_CHUNK) {
+        jsize count = std::min<jsize>(JNIV8ARRAY_PRIMITIVE_CHUNK, numElements - start);
+        Traits::getRegion(env, elements, start, count, buffer);
+        for(jsize i=0; i<count; i++) {
+            values[start + i] = Traits::toV8(isolate, buffer[i]);
         }
     }
+    v8::Local<v8::Object> objRef = v8::Array::New(isolate, values.data(), values.size());
 
     return JNIV8Wrapper::wrapObject<JNIV8Array>(objRef)->getJObject();
 }
@@ -17,6 +17,8 @@ public:
     static jobject jniCreate(JNIEnv *env, jobject obj, jobject engineObj);
     static jobject jniCreateWithLength(JNIEnv *env, jobject obj, jobject engineObj, jint length);
     static jobject jniCreateWithArray(JNIEnv *env, jobject obj, jobject engineObj, jobjectArray elements);
+    static jobject jniCreateWithDoubleArray(JNIEnv *env, jobject obj, jobject engineObj, jdoubleArray elements);
+    static jobject jniCreateWithIntArray(JNIEnv *env, jobject obj, jobject engineObj, jintArray elements);
 
     /**
      * returns the length of the array
@@ -34,6 +36,13 @@ public:
      */
     static jobject jniGetV8Element(JNIEnv *env, jobject obj, jint flags, jint type, jclass returnType, jint index);
 
+    /**
+     * Returns all elements from a specified range inside of the array as a primitive array
+     * elements that are not numbers are converted like arguments of the respective primitive type
+     */
+    static jdoubleArray jniGetV8ElementsAsDoubleArray(JNIEnv *env, jobject obj, jint from, jint to);
+    static jintArray jniGetV8ElementsAsIntArray(JNIEnv *env, jobject obj, jint from, jint to);
+
     /**
      * cache JNI class references
      */
@@ -42,6 +51,11 @@ private:
     static struct {
         jclass clazz;
     } _jniObject;
+
+    template<typename Traits>
+    static typename Traits::ArrayType getElementsAsPrimitiveArray(JNIEnv *env, jobject obj, jint from, jint to);
+    template<typename Traits>
+    static jobject createWithPrimitiveArray(JNIEnv *env, jobject engineObj, typename Traits::ArrayType elements);
 };
 
 BGJS_JNI_LINK_DEF(JNIV8Array)
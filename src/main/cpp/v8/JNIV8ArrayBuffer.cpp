@@ -3,20 +3,138 @@
 //
 
 #include "JNIV8ArrayBuffer.h"
+#include "../bgjs/BGJSV8Engine.h"
 
 #include <stdlib.h>
 
 BGJS_JNI_LINK(JNIV8ArrayBuffer, "ag/boersego/bgjs/JNIV8ArrayBuffer");
 
+/**
+ * internal struct for keeping the java memory of an ArrayBuffer alive
+ */
+struct JNIV8ArrayBufferHolder {
+    v8::Persistent<v8::ArrayBuffer> persistent;
+    jobject byteBuffer;
+    BGJSV8Engine *engine;
+};
+
 /**
  * cache JNI class references
  */
 void JNIV8ArrayBuffer::initJNICache() {
 }
 
+void JNIV8ArrayBufferWeakPersistentCallback(const v8::WeakCallbackInfo<void>& data) {
+    JNIEnv *env = JNIWrapper::getEnvironment();
+
+    JNIV8ArrayBufferHolder *holder = reinterpret_cast<JNIV8ArrayBufferHolder*>(data.GetParameter());
+    holder->engine->getExternalArrayBuffers().erase(holder);
+    BGJS_DELETE_GLOBAL_REF(env, holder->byteBuffer);
+
+    BGJS_CLEAR_PERSISTENT(holder->persistent);
+    delete holder;
+}
+
+void JNIV8ArrayBuffer::releaseExternalBuffers(BGJSV8Engine *engine) {
+    JNIEnv *env = JNIWrapper::getEnvironment();
+
+    for (auto holder : engine->getExternalArrayBuffers()) {
+        BGJS_DELETE_GLOBAL_REF(env, holder->byteBuffer);
+        BGJS_CLEAR_PERSISTENT(holder->persistent);
+        delete holder;
+    }
+    engine->getExternalArrayBuffers().clear();
+}
+
 bool JNIV8ArrayBuffer::isWrappableV8Object(v8::Local<v8::Object> object) {
     return object->IsArrayBuffer() || (object->IsProxy() && object.As<v8::Proxy>()->GetTarget()->IsArrayBuffer());
 }
 
 void JNIV8ArrayBuffer::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
-}
\ No newline at end of file
+    info->registerNativeMethod("CreateWithLength", "(Lag/boersego/bgjs/V8Engine;I)Lag/boersego/bgjs/JNIV8ArrayBuffer;", (void*)JNIV8ArrayBuffer::jniCreateWithLength);
+    info->registerNativeMethod("CreateWithByteBuffer", "(Lag/boersego/bgjs/V8Engine;Ljava/nio/ByteBuffer;)Lag/boersego/bgjs/JNIV8ArrayBuffer;", (void*)JNIV8ArrayBuffer::jniCreateWithByteBuffer);
+    info->registerNativeMethod("getV8ByteLength", "()I", (void*)JNIV8ArrayBuffer::jniGetV8ByteLength);
+    info->registerNativeMethod("_getV8ByteBuffer", "()Ljava/nio/ByteBuffer;", (void*)JNIV8ArrayBuffer::jniGetV8ByteBuffer);
+}
+
+v8::Local<v8::ArrayBuffer> JNIV8ArrayBuffer::getArrayBuffer(v8::Local<v8::Object> object) {
+    if (object->IsProxy()) {
+        return object.As<v8::Proxy>()->GetTarget().As<v8::ArrayBuffer>();
+    }
+    return object.As<v8::ArrayBuffer>();
+}
+
+jobject JNIV8ArrayBuffer::jniCreateWithLength(JNIEnv *env, jobject obj, jobject engineObj, jint length) {
+    if (length < 0) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "length must not be negative");
+        return nullptr;
+    }
+
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Context::Scope ctxScope(engine->getContext());
+
+    v8::Local<v8::ArrayBuffer> bufferRef = v8::ArrayBuffer::New(isolate, (size_t)length);
+
+    return JNIV8Wrapper::wrapObject<JNIV8ArrayBuffer>(bufferRef)->getJObject();
+}
+
+jobject JNIV8ArrayBuffer::jniCreateWithByteBuffer(JNIEnv *env, jobject obj, jobject engineObj, jobject byteBuffer) {
+    void *data = env->GetDirectBufferAddress(byteBuffer);
+    jlong capacity = env->GetDirectBufferCapacity(byteBuffer);
+    if (!data || capacity < 0) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "ByteBuffer must be a direct buffer");
+        return nullptr;
+    }
+
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Context::Scope ctxScope(engine->getContext());
+
+    // externalized: v8 never frees the memory, it stays owned by the ByteBuffer
+    v8::Local<v8::ArrayBuffer> bufferRef = v8::ArrayBuffer::New(isolate, data, (size_t)capacity, v8::ArrayBufferCreationMode::kExternalized);
+
+    // the ByteBuffer has to stay alive as long as the ArrayBuffer can be accessed from js
+    // we keep track of the ArrayBuffer using a weak persistent; when it is gc'd we can release the java reference
+    JNIV8ArrayBufferHolder *holder = new JNIV8ArrayBufferHolder();
+    holder->byteBuffer = BGJS_NEW_GLOBAL_REF(env, byteBuffer);
+    holder->engine = engine.get();
+    engine->getExternalArrayBuffers().insert(holder);
+    BGJS_RESET_PERSISTENT(isolate, holder->persistent, bufferRef);
+    holder->persistent.SetWeak((void*)holder, JNIV8ArrayBufferWeakPersistentCallback, v8::WeakCallbackType::kParameter);
+
+    return JNIV8Wrapper::wrapObject<JNIV8ArrayBuffer>(bufferRef)->getJObject();
+}
+
+jint JNIV8ArrayBuffer::jniGetV8ByteLength(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8ArrayBuffer, v8::Object, 0);
+    return (jint)getArrayBuffer(localRef)->ByteLength();
+}
+
+jobject JNIV8ArrayBuffer::jniGetV8ByteBuffer(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8ArrayBuffer, v8::Object, nullptr);
+
+    v8::Local<v8::ArrayBuffer> bufferRef = getArrayBuffer(localRef);
+    return newDirectByteBuffer(env, bufferRef, 0, bufferRef->ByteLength());
+}
+
+jobject JNIV8ArrayBuffer::newDirectByteBuffer(JNIEnv *env, v8::Local<v8::ArrayBuffer> buffer, size_t byteOffset, size_t byteLength) {
+    // the contents of an ArrayBuffer never move; they stay valid until the buffer is garbage collected or neutered
+    // the java side ties the returned buffer to the wrapper, which keeps the js object alive (see JNIV8ByteBufferReference)
+    v8::ArrayBuffer::Contents contents = buffer->GetContents();
+    if (!contents.Data() || !byteLength || byteOffset + byteLength > contents.ByteLength()) {
+        return nullptr;
+    }
+
+    return env->NewDirectByteBuffer((uint8_t*)contents.Data() + byteOffset, (jlong)byteLength);
+}
@@ -14,6 +14,39 @@ public:
     static bool isWrappableV8Object(v8::Local<v8::Object> object);
     static void initializeJNIBindings(JNIClassInfo *info, bool isReload);
 
+    static jobject jniCreateWithLength(JNIEnv *env, jobject obj, jobject engineObj, jint length);
+    /**
+     * creates an ArrayBuffer that uses the memory of a direct ByteBuffer without copying it
+     * the ByteBuffer is kept alive by a global reference until the ArrayBuffer is garbage collected
+     */
+    static jobject jniCreateWithByteBuffer(JNIEnv *env, jobject obj, jobject engineObj, jobject byteBuffer);
+
+    /**
+     * returns the length of the buffer in bytes
+     */
+    static jint jniGetV8ByteLength(JNIEnv *env, jobject obj);
+
+    /**
+     * returns a direct ByteBuffer sharing the memory of the ArrayBuffer, or null if the buffer is empty or neutered
+     */
+    static jobject jniGetV8ByteBuffer(JNIEnv *env, jobject obj);
+
+    /**
+     * returns the ArrayBuffer of a wrapped object, unwrapping proxies
+     */
+    static v8::Local<v8::ArrayBuffer> getArrayBuffer(v8::Local<v8::Object> object);
+
+    /**
+     * returns a direct ByteBuffer sharing the specified range of the ArrayBuffer memory, or null if the range is empty
+     */
+    static jobject newDirectByteBuffer(JNIEnv *env, v8::Local<v8::ArrayBuffer> buffer, size_t byteOffset, size_t byteLength);
+
+    /**
+     * releases the java memory of all ArrayBuffers created with jniCreateWithByteBuffer that were not garbage collected yet
+     * called when the engine is destroyed
+     */
+    static void releaseExternalBuffers(BGJSV8Engine *engine);
+
     /**
      * cache JNI class references
      */
@@ -22,4 +55,4 @@ public:
 
 BGJS_JNI_LINK_DEF(JNIV8ArrayBuffer)
 
-#endif //ANDROID_TRADINGLIB_SAMPLE_JNIV8ARRAYBUFFER_H
\ No newline at end of file
+#endif //ANDROID_TRADINGLIB_SAMPLE_JNIV8ARRAYBUFFER_H
@@ -12,6 +12,9 @@
 
 using namespace v8;
 
+// arguments of java methods with up to this many parameters are marshalled on the stack
+#define JNIV8_STACK_ARGUMENTS 8
+
 static bool startsWith(const std::string& s, const std::string& prefix) {
     return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
 }
@@ -22,8 +25,7 @@ Local<Name> JNIV8ClassInfo::_makeName(std::string name) {
     Local<Name> nameRef;
 
     if(startsWith(name, "string:")) {
-        nameRef = String::NewFromUtf8(isolate, name.c_str() + 7,
-                                      v8::NewStringType::kNormal).ToLocalChecked().As<Name>();
+        nameRef = engine->getPropertyNameCache().get(isolate, name.substr(7)).As<Name>();
     } else if(startsWith(name, "symbol:")) {
         if(name == "symbol:ITERATOR") {
             nameRef = v8::Symbol::GetIterator(isolate);
@@ -92,9 +94,10 @@ void JNIV8ClassInfo::initJNICache() {
     _jniObject.clazz = (jclass)env->NewGlobalRef(env->FindClass("java/lang/Object"));
 }
 
+template<bool isPrimitive>
 void JNIV8ClassInfo::v8JavaAccessorGetterCallback(Local<Name> property, const PropertyCallbackInfo<Value> &info) {
     JNIEnv *env = JNIWrapper::getEnvironment();
-    JNILocalFrame localFrame(env, 1);
+    JNILocalFrame localFrame(env, 1, !isPrimitive);
 
     Isolate *isolate = info.GetIsolate();
     HandleScope scope(isolate);
@@ -110,27 +113,24 @@ void JNIV8ClassInfo::v8JavaAccessorGetterCallback(Local<Name> property, const Pr
             ext = info.This()->GetInternalField(0).As<v8::External>();
             auto *v8Object = reinterpret_cast<JNIV8Object *>(ext->Value());
 
-            jobj = v8Object->getJObject();
+            jobj = v8Object->getBorrowedJObject();
         }
 
-        v8::Local<v8::Value> value;
-
-        value = JNIV8Marshalling::callJavaMethod(env, cb->propertyType, cb->javaClass, cb->javaGetterId, jobj, nullptr);
+        JNIV8Marshalling::callJavaMethod(env, cb->propertyType, cb->javaClass, cb->javaGetterId, jobj, nullptr, info.GetReturnValue());
 
         // java method could have thrown an exception; if so forward it to v8
         if(env->ExceptionCheck()) {
             BGJSV8Engine::GetInstance(isolate)->forwardJNIExceptionToV8();
             return;
         }
-
-        info.GetReturnValue().Set(value);
     }
 }
 
 
+template<bool isPrimitive>
 void JNIV8ClassInfo::v8JavaAccessorSetterCallback(Local<Name> property, Local<Value> value, const PropertyCallbackInfo<void> &info) {
     JNIEnv *env = JNIWrapper::getEnvironment();
-    JNILocalFrame localFrame(env, 1);
+    JNILocalFrame localFrame(env, 1, !isPrimitive);
 
     Isolate *isolate = info.GetIsolate();
     HandleScope scope(isolate);
@@ -149,7 +149,7 @@ void JNIV8ClassInfo::v8JavaAccessorSetterCallback(Local<Name> property, Local<Va
             ext = info.This()->GetInternalField(0).As<v8::External>();
             auto *v8Object = reinterpret_cast<JNIV8Object *>(ext->Value());
 
-            jobj = v8Object->getJObject();
+            jobj = v8Object->getBorrowedJObject();
         }
 
         JNIV8MarshallingError res;
@@ -194,9 +194,98 @@ void JNIV8ClassInfo::v8JavaAccessorSetterCallback(Local<Name> property, Local<Va
     }
 }
 
+void JNIV8ObjectJavaCallbackHolder::addSignature(jmethodID methodId, std::vector<JNIV8JavaValue> *arguments) {
+    // generic methods receive an Object[]
+    bool isPrimitive = arguments && JNIV8Marshalling::isPrimitive(returnType);
+    if(isPrimitive) {
+        for(auto &arg : *arguments) {
+            if(!JNIV8Marshalling::isPrimitive(arg)) {
+                isPrimitive = false;
+                break;
+            }
+        }
+    }
+    signatures.push_back({methodId, arguments, isPrimitive});
+
+    // adding a signature might have moved the existing ones => rebuild the lookup table
+    signaturesByArity.clear();
+    genericSignature = nullptr;
+    for(auto &sig : signatures) {
+        if(!sig.arguments) {
+            if(!genericSignature) genericSignature = &sig;
+            continue;
+        }
+        size_t arity = sig.arguments->size();
+        if(signaturesByArity.size() <= arity) {
+            signaturesByArity.resize(arity + 1);
+        }
+        signaturesByArity[arity].push_back(&sig);
+    }
+}
+
+/**
+ * quick check if the supplied values are a natural fit for the argument types of an overload
+ * used to choose between overloads with the same number of arguments; does not replace the actual conversion
+ */
+static bool signatureAcceptsArguments(JNIEnv *env, const JNIV8ObjectJavaSignatureInfo *sig, const v8::FunctionCallbackInfo<v8::Value>& args, jclass objectClass) {
+    for(int idx = 0, n = args.Length(); idx < n; idx++) {
+        const JNIV8JavaValue &arg = (*sig->arguments)[idx];
+        v8::Local<v8::Value> value = args[idx];
+        if(value->IsNullOrUndefined()) {
+            // only objects and boxed primitives can represent null
+            if(!arg.clazz) return false;
+            continue;
+        }
+        switch(arg.valueType) {
+            case JNIV8JavaValueType::kBoolean:
+                if(!value->IsBoolean()) return false;
+                break;
+            case JNIV8JavaValueType::kByte:
+            case JNIV8JavaValueType::kShort:
+            case JNIV8JavaValueType::kInteger:
+            case JNIV8JavaValueType::kLong:
+            case JNIV8JavaValueType::kFloat:
+            case JNIV8JavaValueType::kDouble:
+                if(!value->IsNumber()) return false;
+                break;
+            case JNIV8JavaValueType::kCharacter:
+            case JNIV8JavaValueType::kString:
+                if(!value->IsString()) return false;
+                break;
+            case JNIV8JavaValueType::kVoid:
+                return false;
+            case JNIV8JavaValueType::kObject: {
+                // Object accepts everything; any other class is a JNIV8Object subclass, which only js objects and symbols can map to
+                if(env->IsSameObject(arg.clazz, objectClass)) break;
+                if(!value->IsObject() && !value->IsSymbol()) return false;
+                // wrappers are cached, so the conversion of the chosen overload reuses the one created here
+                jobject obj = JNIV8Marshalling::v8value2jobject(value);
+                bool matches = obj && env->IsInstanceOf(obj, arg.clazz);
+                env->DeleteLocalRef(obj);
+                if(!matches) return false;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+JNIV8ObjectJavaSignatureInfo* JNIV8ObjectJavaCallbackHolder::findSignature(JNIEnv *env, const v8::FunctionCallbackInfo<v8::Value>& args, jclass objectClass) {
+    size_t arity = (size_t)args.Length();
+    if(arity >= signaturesByArity.size() || signaturesByArity[arity].empty()) {
+        return genericSignature;
+    }
+    auto &candidates = signaturesByArity[arity];
+    if(candidates.size() > 1) {
+        for(auto sig : candidates) {
+            if(signatureAcceptsArguments(env, sig, args, objectClass)) return sig;
+        }
+    }
+    return candidates[0];
+}
+
 void JNIV8ClassInfo::v8JavaMethodCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
     JNIEnv *env = JNIWrapper::getEnvironment();
-    JNILocalFrame localFrame(env);
 
     HandleScope scope(args.GetIsolate());
     Isolate *isolate = args.GetIsolate();
@@ -215,28 +304,23 @@ void JNIV8ClassInfo::v8JavaMethodCallback(const v8::FunctionCallbackInfo<v8::Val
         // this is not really "safe".. but how could it be? another part of the program could store arbitrary stuff in internal fields
         ext = internalField.As<v8::External>();
         auto *v8Object = reinterpret_cast<JNIV8Object *>(ext->Value());
-        jobj = v8Object->getJObject();
+        jobj = v8Object->getBorrowedJObject();
     }
 
     // try to find a matching signature
-    JNIV8ObjectJavaSignatureInfo *signature = nullptr;
-
-    for (auto& sig : cb->signatures) {
-        if (!sig.arguments) {
-            if (!signature) {
-                signature = &sig;
-            }
-        } else if (sig.arguments->size() == args.Length()) {
-            signature = &sig;
-            break;
-        }
-    }
+    JNIV8ObjectJavaSignatureInfo *signature = cb->findSignature(env, args, _jniObject.clazz);
 
     if(!signature) {
         isolate->ThrowException(v8::Exception::TypeError(String::NewFromUtf8(isolate, ("invalid number of arguments (" + std::to_string(args.Length()) + ") supplied to " + cb->methodName).c_str())));
         return;
     }
 
+    // calls that only pass numbers and booleans do not create local references
+    JNILocalFrame localFrame(env, 0, !signature->isPrimitive);
+
+    // arguments are stored on the stack unless there are a lot of them
+    jvalue stackArgs[JNIV8_STACK_ARGUMENTS];
+    jvalue *heapArgs = nullptr;
     jvalue *jargs;
     jobject obj;
     size_t numJArgs;
@@ -244,9 +328,7 @@ void JNIV8ClassInfo::v8JavaMethodCallback(const v8::FunctionCallbackInfo<v8::Val
     if(!signature->arguments) {
         // generic case: an array of objects!
         // nothing to validate here, this always works
-        numJArgs = 1;
-        jargs = (jvalue*)malloc(sizeof(jvalue)*numJArgs);
-        memset(jargs, 0, sizeof(jvalue)*numJArgs);
+        jargs = stackArgs;
         jobjectArray jArray = env->NewObjectArray(args.Length(), _jniObject.clazz, nullptr);
         for (int idx = 0, n = args.Length(); idx < n; idx++) {
             obj = JNIV8Marshalling::v8value2jobject(args[idx]);
@@ -259,7 +341,10 @@ void JNIV8ClassInfo::v8JavaMethodCallback(const v8::FunctionCallbackInfo<v8::Val
         // arguments might have to be of a certain type, so we need to validate!
         numJArgs = (size_t)args.Length();
         if(numJArgs) {
-            jargs = (jvalue *) malloc(sizeof(jvalue) * numJArgs);
+            if(numJArgs > JNIV8_STACK_ARGUMENTS) {
+                heapArgs = (jvalue *) malloc(sizeof(jvalue) * numJArgs);
+            }
+            jargs = heapArgs ? heapArgs : stackArgs;
             memset(jargs, 0, sizeof(jvalue) * numJArgs);
 
             for(int idx = 0, n = args.Length(); idx < n; idx++) {
@@ -269,7 +354,7 @@ void JNIV8ClassInfo::v8JavaMethodCallback(const v8::FunctionCallbackInfo<v8::Val
                 JNIV8MarshallingError res = JNIV8Marshalling::convertV8ValueToJavaValue(env, value, arg, &(jargs[idx]));
                 if(res != JNIV8MarshallingError::kOk) {
                     // conversion failed => simply clean up & throw an exception
-                    free(jargs);
+                    free(heapArgs);
                     switch(res) {
                         default:
                         case JNIV8MarshallingError::kWrongType:
@@ -300,21 +385,15 @@ void JNIV8ClassInfo::v8JavaMethodCallback(const v8::FunctionCallbackInfo<v8::Val
         }
     }
 
-    v8::Local<v8::Value> result;
+    JNIV8Marshalling::callJavaMethod(env, cb->returnType, cb->javaClass, signature->javaMethodId, jobj, jargs, args.GetReturnValue());
 
-    result = JNIV8Marshalling::callJavaMethod(env, cb->returnType, cb->javaClass, signature->javaMethodId, jobj, jargs);
-
-    if(jargs) {
-        free(jargs);
-    }
+    free(heapArgs);
 
     // java method could have thrown an exception; if so forward it to v8
     if(env->ExceptionCheck()) {
         BGJSV8Engine::GetInstance(isolate)->forwardJNIExceptionToV8();
         return;
     }
-
-    args.GetReturnValue().Set(result);
 }
 
 void JNIV8ClassInfo::v8AccessorGetterCallback(Local<Name> property, const PropertyCallbackInfo<Value> &info) {
@@ -382,9 +461,10 @@ void JNIV8ClassInfo::v8MethodCallback(const v8::FunctionCallbackInfo<v8::Value>&
     }
 }
 
-JNIV8ClassInfoContainer::JNIV8ClassInfoContainer(JNIV8ObjectType type, const std::string& canonicalName, JNIV8ObjectInitializer i,
+JNIV8ClassInfoContainer::JNIV8ClassInfoContainer(size_t typeId, JNIV8ObjectType type, const std::string& canonicalName, JNIV8ObjectInitializer i,
                                            JNIV8ObjectCreator c, size_t s, JNIV8ClassInfoContainer *baseClassInfo) :
-        type(type), canonicalName(canonicalName), initializer(i), creator(c), size(s), baseClassInfo(baseClassInfo) {
+        typeId(typeId), hashCode(std::hash<std::string>()(canonicalName)), type(type), canonicalName(canonicalName), initializer(i), creator(c), size(s), baseClassInfo(baseClassInfo),
+        clsObject(nullptr), clsBinding(nullptr), initialized(false) {
     if(baseClassInfo) {
         if (!creator) {
             creator = baseClassInfo->creator;
@@ -393,21 +473,25 @@ JNIV8ClassInfoContainer::JNIV8ClassInfoContainer(JNIV8ObjectType type, const std
             size = baseClassInfo->size;
         }
     }
+}
+
+void JNIV8ClassInfoContainer::initialize() {
+    if(initialized) return;
+    initialized = true;
 
     JNIEnv *env = JNIWrapper::getEnvironment();
     jclass clazz;
 
-    clazz = env->FindClass(canonicalName.c_str());
+    clazz = JNIWrapper::findClass(canonicalName);
     JNI_ASSERT(clazz != nullptr, "Failed to retrieve java class");
     clsObject = (jclass)env->NewGlobalRef(clazz);
+    env->DeleteLocalRef(clazz);
 
-    // binding is optional; if it does not exist we have to clear the pending exception
-    clazz = env->FindClass((canonicalName+"$V8Binding").c_str());
+    // binding is optional
+    clazz = JNIWrapper::findClass(canonicalName+"$V8Binding");
     if(clazz) {
         clsBinding = (jclass)env->NewGlobalRef(clazz);
-    } else {
-        clsBinding = nullptr;
-        env->ExceptionClear();
+        env->DeleteLocalRef(clazz);
     }
 
     // if creation from native/javascript is allowed, we need the special constructor!
@@ -440,14 +524,14 @@ JNIV8ClassInfo::~JNIV8ClassInfo() {
     }
     JNIEnv *env = JNIWrapper::getEnvironment();
     for(auto &it : javaAccessorHolders) {
-        env->DeleteGlobalRef(it->javaClass);
+        BGJS_DELETE_GLOBAL_REF(env, it->javaClass);
         if(it->propertyType.clazz) {
             env->DeleteGlobalRef(it->propertyType.clazz);
         }
         delete it;
     }
     for(auto &it : javaCallbackHolders) {
-        env->DeleteGlobalRef(it->javaClass);
+        BGJS_DELETE_GLOBAL_REF(env, it->javaClass);
         for(auto sig : it->signatures) {
             if(!sig.arguments) continue;
             for(auto arg : *sig.arguments) {
@@ -510,7 +594,7 @@ void JNIV8ClassInfo::registerJavaMethod(const std::string& methodName, jmethodID
             JNI_ASSERTF(returnType.valueType == it->returnType.valueType && JNIWrapper::getEnvironment()->IsSameObject(returnType.clazz, it->returnType.clazz),
                         "Overload for method '%s' of class '%s' has a different return type", methodName.c_str(), container->canonicalName.c_str());
             // register overload
-            it->signatures.push_back({methodId, arguments});
+            it->addSignature(methodId, arguments);
             return;
         }
     }
@@ -519,7 +603,7 @@ void JNIV8ClassInfo::registerJavaMethod(const std::string& methodName, jmethodID
     auto *holder = new JNIV8ObjectJavaCallbackHolder(returnType);
     holder->methodName = methodName;
     holder->isStatic = false;
-    holder->signatures.push_back({methodId, arguments});
+    holder->addSignature(methodId, arguments);
     _registerJavaMethod(holder);
 }
 
@@ -531,7 +615,7 @@ void JNIV8ClassInfo::registerStaticJavaMethod(const std::string &methodName, jme
             JNI_ASSERTF(returnType.valueType == it->returnType.valueType && JNIWrapper::getEnvironment()->IsSameObject(returnType.clazz, it->returnType.clazz),
                         "Overload for method '%s' of class '%s' has a different return type", methodName.c_str(), container->canonicalName.c_str());
             // register overload
-            it->signatures.push_back({methodId, arguments});
+            it->addSignature(methodId, arguments);
             return;
         }
     }
@@ -540,7 +624,7 @@ void JNIV8ClassInfo::registerStaticJavaMethod(const std::string &methodName, jme
     auto *holder = new JNIV8ObjectJavaCallbackHolder(returnType);
     holder->methodName = methodName;
     holder->isStatic = true;
-    holder->signatures.push_back({methodId, arguments});
+    holder->addSignature(methodId, arguments);
     _registerJavaMethod(holder);
 }
 
@@ -617,7 +701,7 @@ void JNIV8ClassInfo::_registerJavaMethod(JNIV8ObjectJavaCallbackHolder *holder)
     Local<FunctionTemplate> ft = Local<FunctionTemplate>::New(isolate, functionTemplate);
 
     JNIEnv *env = JNIWrapper::getEnvironment();
-    holder->javaClass = (jclass)env->NewGlobalRef(env->FindClass(container->canonicalName.c_str()));;
+    holder->javaClass = (jclass)BGJS_NEW_GLOBAL_REF(env, container->clsObject);
     javaCallbackHolders.push_back(holder);
 
     Local<External> data = External::New(isolate, (void*)holder);
@@ -648,15 +732,18 @@ void JNIV8ClassInfo::_registerJavaAccessor(JNIV8ObjectJavaAccessorHolder *holder
     Local<FunctionTemplate> ft = Local<FunctionTemplate>::New(isolate, functionTemplate);
 
     JNIEnv *env = JNIWrapper::getEnvironment();
-    holder->javaClass = (jclass)env->NewGlobalRef(env->FindClass(container->canonicalName.c_str()));
+    holder->javaClass = (jclass)BGJS_NEW_GLOBAL_REF(env, container->clsObject);
     javaAccessorHolders.push_back(holder);
 
     Local<External> data = External::New(isolate, (void*)holder);
 
+    // choose the callbacks specialized for the property type
+    bool isPrimitive = JNIV8Marshalling::isPrimitive(holder->propertyType);
+    AccessorNameGetterCallback finalGetter = isPrimitive ? v8JavaAccessorGetterCallback<true> : v8JavaAccessorGetterCallback<false>;
     AccessorNameSetterCallback finalSetter = 0;
     v8::PropertyAttribute settings = v8::PropertyAttribute::None;
     if(holder->javaSetterId) {
-        finalSetter = v8JavaAccessorSetterCallback;
+        finalSetter = isPrimitive ? v8JavaAccessorSetterCallback<true> : v8JavaAccessorSetterCallback<false>;
     } else {
         settings = v8::PropertyAttribute::ReadOnly;
     }
@@ -666,12 +753,12 @@ void JNIV8ClassInfo::_registerJavaAccessor(JNIV8ObjectJavaAccessorHolder *holder
     if(holder->isStatic) {
         Local<Function> f = ft->GetFunction();
         f->SetAccessor(engine->getContext(), nameRef,
-                       v8JavaAccessorGetterCallback, finalSetter,
+                       finalGetter, finalSetter,
                        data, DEFAULT, settings);
     } else {
         Local<ObjectTemplate> instanceTpl = ft->InstanceTemplate();
         instanceTpl->SetAccessor(nameRef,
-                                 v8JavaAccessorGetterCallback, finalSetter,
+                                 finalGetter, finalSetter,
                                  data, DEFAULT, settings);
     }
 }
@@ -104,10 +104,18 @@ struct JNIV8ObjectJavaCallbackHolder {
     std::string methodName;
     JNIV8JavaValue returnType;
     std::vector<JNIV8ObjectJavaSignatureInfo> signatures;
+    // overloads indexed by number of arguments, and the overload accepting an Object[] (if any)
+    // both point into signatures and are rebuilt whenever an overload is added
+    std::vector<std::vector<JNIV8ObjectJavaSignatureInfo*>> signaturesByArity;
+    JNIV8ObjectJavaSignatureInfo *genericSignature;
     jclass javaClass;
     bool isStatic;
 
-    JNIV8ObjectJavaCallbackHolder(JNIV8JavaValue returnType) : returnType(returnType) {};
+    JNIV8ObjectJavaCallbackHolder(JNIV8JavaValue returnType) : returnType(returnType), genericSignature(nullptr) {};
+
+    void addSignature(jmethodID methodId, std::vector<JNIV8JavaValue> *arguments);
+    // objectClass is java.lang.Object; parameters of that type accept any value
+    JNIV8ObjectJavaSignatureInfo* findSignature(JNIEnv *env, const v8::FunctionCallbackInfo<v8::Value>& args, jclass objectClass);
 };
 
 /**
@@ -232,7 +240,10 @@ private:
         jclass clazz;
     } _jniObject;
 
+    // accessors of primitive type are registered with the isPrimitive specialization, which skips the local reference frame
+    template<bool isPrimitive>
     static void v8JavaAccessorGetterCallback(v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value> &info);
+    template<bool isPrimitive>
     static void v8JavaAccessorSetterCallback(v8::Local<v8::Name> property, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<void> &info);
     static void v8JavaMethodCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void v8AccessorGetterCallback(v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value> &info);
@@ -246,24 +257,34 @@ typedef void(*JNIV8ObjectInitializer)(JNIV8ClassInfo *info);
 typedef JNIRetainedRef<JNIV8Object>(*JNIV8ObjectCreator)(JNIV8ClassInfo *info, v8::Persistent<v8::Object> *jsObj, jobjectArray arguments);
 
 /**
- * internal container object for managing all class info instances (one for each v8 engine) of an object
+ * internal container object describing a registered class
+ * the class info instances (one for each v8 engine) are stored in the JNIV8ClassInfoTable of the respective engine
  */
 struct JNIV8ClassInfoContainer {
     friend class JNIV8Object;
     friend class JNIV8Wrapper;
     friend class JNIV8ClassInfo;
 private:
-    JNIV8ClassInfoContainer(JNIV8ObjectType type, const std::string& canonicalName, JNIV8ObjectInitializer i, JNIV8ObjectCreator c, size_t size, JNIV8ClassInfoContainer *baseClassInfo);
+    JNIV8ClassInfoContainer(size_t typeId, JNIV8ObjectType type, const std::string& canonicalName, JNIV8ObjectInitializer i, JNIV8ObjectCreator c, size_t size, JNIV8ClassInfoContainer *baseClassInfo);
+
+    /**
+     * resolves the java classes; deferred until the class is first used in an engine
+     * has to be called with JNIV8Wrapper::_mutexEnv held
+     */
+    void initialize();
 
+    // index into the class info table of each engine; assigned in order of registration
+    size_t typeId;
+    size_t hashCode;
     JNIV8ObjectType type;
     JNIV8ClassInfoContainer *baseClassInfo;
     size_t size;
     std::string canonicalName;
     JNIV8ObjectInitializer initializer;
     JNIV8ObjectCreator creator;
-    std::vector<JNIV8ClassInfo*> classInfos;
 
     jclass clsObject, clsBinding;
+    bool initialized;
 };
 
 #endif //TRADINGLIB_SAMPLE_V8CLASSINFO_H
@@ -0,0 +1,44 @@
+#include "JNIV8ClassInfoTable.h"
+#include "../jni/jni_assert.h"
+
+JNIV8ClassInfoTable::JNIV8ClassInfoTable() {
+    for (size_t i = 0; i < kMaxPages; i++) {
+        _pages[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+JNIV8ClassInfoTable::~JNIV8ClassInfoTable() {
+    // entries are owned by JNIV8Wrapper and have already been deleted in JNIV8Wrapper::cleanupV8Engine
+    for (size_t i = 0; i < kMaxPages; i++) {
+        delete _pages[i].load(std::memory_order_relaxed);
+    }
+}
+
+void JNIV8ClassInfoTable::set(size_t typeId, JNIV8ClassInfo *info) {
+    JNI_ASSERT(typeId < kCapacity, "Class info table capacity exceeded");
+
+    Page *page = _pages[typeId / kPageSize].load(std::memory_order_relaxed);
+    if (!page) {
+        page = new Page();
+        for (size_t i = 0; i < kPageSize; i++) {
+            page->entries[i].store(nullptr, std::memory_order_relaxed);
+        }
+        _pages[typeId / kPageSize].store(page, std::memory_order_release);
+    }
+    page->entries[typeId % kPageSize].store(info, std::memory_order_release);
+}
+
+std::vector<JNIV8ClassInfo*> JNIV8ClassInfoTable::clear() {
+    std::vector<JNIV8ClassInfo*> infos;
+    for (size_t i = 0; i < kMaxPages; i++) {
+        Page *page = _pages[i].load(std::memory_order_relaxed);
+        if (!page) continue;
+        for (size_t j = 0; j < kPageSize; j++) {
+            JNIV8ClassInfo *info = page->entries[j].exchange(nullptr, std::memory_order_relaxed);
+            if (info) {
+                infos.push_back(info);
+            }
+        }
+    }
+    return infos;
+}
@@ -0,0 +1,54 @@
+#ifndef ANDROID_TRADINGLIB_SAMPLE_JNIV8CLASSINFOTABLE_H
+#define ANDROID_TRADINGLIB_SAMPLE_JNIV8CLASSINFOTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+class JNIV8ClassInfo;
+
+/**
+ * class infos of an engine, indexed by the type id that is assigned to each class when it is registered on JNIV8Wrapper
+ * lookups do not take a lock; entries are created lazily by JNIV8Wrapper while holding its mutex and published with a release store
+ *
+ * storage is allocated in pages that are never moved or freed while the table exists,
+ * so registering more classes later on does not invalidate entries that are being read concurrently
+ */
+class JNIV8ClassInfoTable {
+public:
+    static const size_t kPageSize = 64;
+    static const size_t kMaxPages = 64;
+    static const size_t kCapacity = kPageSize * kMaxPages;
+
+    JNIV8ClassInfoTable();
+    ~JNIV8ClassInfoTable();
+
+    /**
+     * returns the class info for the specified type id, or nullptr if it was not created yet
+     */
+    inline JNIV8ClassInfo* get(size_t typeId) const {
+        const Page *page = _pages[typeId / kPageSize].load(std::memory_order_acquire);
+        return page ? page->entries[typeId % kPageSize].load(std::memory_order_acquire) : nullptr;
+    }
+
+    /**
+     * publishes a fully initialized class info
+     * has to be called with JNIV8Wrapper::_mutexEnv held
+     */
+    void set(size_t typeId, JNIV8ClassInfo *info);
+
+    /**
+     * removes all entries and returns them so that they can be deleted
+     * has to be called with JNIV8Wrapper::_mutexEnv held, and only once the engine is not used anymore
+     */
+    std::vector<JNIV8ClassInfo*> clear();
+
+private:
+    struct Page {
+        std::atomic<JNIV8ClassInfo*> entries[kPageSize];
+    };
+
+    std::atomic<Page*> _pages[kMaxPages];
+};
+
+#endif //ANDROID_TRADINGLIB_SAMPLE_JNIV8CLASSINFOTABLE_H
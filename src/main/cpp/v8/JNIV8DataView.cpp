@@ -0,0 +1,80 @@
+#include "JNIV8DataView.h"
+#include "JNIV8ArrayBuffer.h"
+#include "JNIV8TypedArray.h"
+#include "../bgjs/BGJSV8Engine.h"
+
+BGJS_JNI_LINK(JNIV8DataView, "ag/boersego/bgjs/JNIV8DataView");
+
+/**
+ * cache JNI class references
+ */
+void JNIV8DataView::initJNICache() {
+}
+
+bool JNIV8DataView::isWrappableV8Object(v8::Local<v8::Object> object) {
+    return object->IsDataView() || (object->IsProxy() && object.As<v8::Proxy>()->GetTarget()->IsDataView());
+}
+
+void JNIV8DataView::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
+    info->registerNativeMethod("_createWithBuffer", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8ArrayBuffer;II)Lag/boersego/bgjs/JNIV8DataView;", (void*)JNIV8DataView::jniCreateWithBuffer);
+    info->registerNativeMethod("getV8ByteOffset", "()I", (void*)JNIV8DataView::jniGetV8ByteOffset);
+    info->registerNativeMethod("getV8ByteLength", "()I", (void*)JNIV8DataView::jniGetV8ByteLength);
+    info->registerNativeMethod("getV8Buffer", "()Lag/boersego/bgjs/JNIV8ArrayBuffer;", (void*)JNIV8DataView::jniGetV8Buffer);
+    info->registerNativeMethod("_getV8ByteBuffer", "()Ljava/nio/ByteBuffer;", (void*)JNIV8DataView::jniGetV8ByteBuffer);
+}
+
+v8::Local<v8::DataView> JNIV8DataView::getDataView(v8::Local<v8::Object> object) {
+    if (object->IsProxy()) {
+        return object.As<v8::Proxy>()->GetTarget().As<v8::DataView>();
+    }
+    return object.As<v8::DataView>();
+}
+
+jobject JNIV8DataView::jniCreateWithBuffer(JNIEnv *env, jobject obj, jobject engineObj, jobject bufferObj, jint byteOffset, jint byteLength) {
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Context::Scope ctxScope(engine->getContext());
+
+    auto buffer = JNIWrapper::wrapObject<JNIV8ArrayBuffer>(bufferObj);
+    if (!buffer) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "ArrayBuffer must not be null or disposed");
+        return nullptr;
+    }
+
+    v8::Local<v8::ArrayBuffer> bufferRef = JNIV8ArrayBuffer::getArrayBuffer(buffer->getJSObject());
+    if (byteOffset < 0 || byteLength < 0 || (size_t)byteOffset + (size_t)byteLength > bufferRef->ByteLength()) {
+        env->ThrowNew(env->FindClass("java/lang/IndexOutOfBoundsException"), "Invalid byte offset or length for ArrayBuffer");
+        return nullptr;
+    }
+
+    v8::Local<v8::DataView> viewRef = v8::DataView::New(bufferRef, (size_t)byteOffset, (size_t)byteLength);
+
+    return JNIV8Wrapper::wrapObject<JNIV8DataView>(viewRef)->getJObject();
+}
+
+jint JNIV8DataView::jniGetV8ByteOffset(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8DataView, v8::Object, 0);
+    return JNIV8TypedArray::toJavaSize(env, getDataView(localRef)->ByteOffset());
+}
+
+jint JNIV8DataView::jniGetV8ByteLength(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8DataView, v8::Object, 0);
+    return JNIV8TypedArray::toJavaSize(env, getDataView(localRef)->ByteLength());
+}
+
+jobject JNIV8DataView::jniGetV8Buffer(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8DataView, v8::Object, nullptr);
+    return JNIV8Wrapper::wrapObject<JNIV8ArrayBuffer>(getDataView(localRef)->Buffer())->getJObject();
+}
+
+jobject JNIV8DataView::jniGetV8ByteBuffer(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8DataView, v8::Object, nullptr);
+
+    v8::Local<v8::DataView> viewRef = getDataView(localRef);
+    return JNIV8ArrayBuffer::newDirectByteBuffer(env, viewRef->Buffer(), viewRef->ByteOffset(), viewRef->ByteLength());
+}
@@ -0,0 +1,33 @@
+#ifndef ANDROID_TRADINGLIB_SAMPLE_JNIV8DATAVIEW_H
+#define ANDROID_TRADINGLIB_SAMPLE_JNIV8DATAVIEW_H
+
+#include "JNIV8Wrapper.h"
+
+class JNIV8DataView : public JNIScope<JNIV8DataView, JNIV8Object> {
+public:
+    JNIV8DataView(jobject obj, JNIClassInfo *info) : JNIScope(obj, info) {};
+
+    static bool isWrappableV8Object(v8::Local<v8::Object> object);
+    static void initializeJNIBindings(JNIClassInfo *info, bool isReload);
+
+    /**
+     * creates a DataView on an existing ArrayBuffer without copying it
+     */
+    static jobject jniCreateWithBuffer(JNIEnv *env, jobject obj, jobject engineObj, jobject bufferObj, jint byteOffset, jint byteLength);
+
+    static jint jniGetV8ByteOffset(JNIEnv *env, jobject obj);
+    static jint jniGetV8ByteLength(JNIEnv *env, jobject obj);
+    static jobject jniGetV8Buffer(JNIEnv *env, jobject obj);
+    static jobject jniGetV8ByteBuffer(JNIEnv *env, jobject obj);
+
+    /**
+     * cache JNI class references
+     */
+    static void initJNICache();
+private:
+    static v8::Local<v8::DataView> getDataView(v8::Local<v8::Object> object);
+};
+
+BGJS_JNI_LINK_DEF(JNIV8DataView)
+
+#endif //ANDROID_TRADINGLIB_SAMPLE_JNIV8DATAVIEW_H
@@ -15,25 +15,70 @@ struct JNIV8FunctionCallbackHolder {
     v8::Persistent<v8::Function> persistent;
     jobject jFuncRef;
     jmethodID callbackMethodId;
+    JNIV8FunctionHandlerType type;
 };
 
+/**
+ * internal struct for storing information about the supported handler interfaces
+ */
+struct JNIV8FunctionHandlerInfo {
+    jclass clazz;
+    jmethodID callbackId;
+    std::vector<JNIV8JavaValue> arguments;
+    JNIV8JavaValue returnType = JNIV8JavaValue(JNIV8JavaValueType::kObject, nullptr);
+};
+
+static JNIV8FunctionHandlerInfo _handlerInfos[(int)JNIV8FunctionHandlerType::kDoubleToBoolean + 1];
+
+// typed handlers never take more arguments than this
+#define JNIV8FUNCTION_MAX_TYPED_ARGUMENTS 2
+
 decltype(JNIV8Function::_jniObject) JNIV8Function::_jniObject = {0};
 
+static void initHandlerInfo(JNIEnv *env, JNIV8FunctionHandlerType type, const char *className, const std::vector<std::string> &argumentTypes,
+                            const std::string &returnType = "Ljava/lang/Object;") {
+    JNIV8FunctionHandlerInfo &handlerInfo = _handlerInfos[(int)type];
+    std::string strSignature = "(";
+    for(auto &argumentType : argumentTypes) {
+        handlerInfo.arguments.push_back(JNIV8Marshalling::persistentArgumentWithTypeSignature(argumentType));
+        strSignature += argumentType;
+    }
+    strSignature += ")" + returnType;
+    handlerInfo.returnType = JNIV8Marshalling::persistentValueWithTypeSignature(returnType);
+
+    handlerInfo.clazz = (jclass)env->NewGlobalRef(env->FindClass(className));
+    handlerInfo.callbackId = env->GetMethodID(handlerInfo.clazz, "Callback", strSignature.c_str());
+    JNI_ASSERT(handlerInfo.arguments.size() <= JNIV8FUNCTION_MAX_TYPED_ARGUMENTS || type == JNIV8FunctionHandlerType::kGeneric, "too many arguments for typed handler");
+}
+
 /**
  * cache JNI class references
  */
 void JNIV8Function::initJNICache() {
     JNIEnv *env = JNIWrapper::getEnvironment();
     _jniObject.clazz = (jclass)env->NewGlobalRef(env->FindClass("java/lang/Object"));
+
+    // the generic handler is not converted by JNIV8Marshalling::convertV8ValueToJavaValue, so no argument types are needed
+    _handlerInfos[(int)JNIV8FunctionHandlerType::kGeneric].clazz = (jclass)env->NewGlobalRef(env->FindClass("ag/boersego/bgjs/JNIV8Function$Handler"));
+    _handlerInfos[(int)JNIV8FunctionHandlerType::kGeneric].callbackId = env->GetMethodID(_handlerInfos[(int)JNIV8FunctionHandlerType::kGeneric].clazz, "Callback", "(Ljava/lang/Object;[Ljava/lang/Object;)Ljava/lang/Object;");
+
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kDouble, "ag/boersego/bgjs/JNIV8Function$DoubleHandler", {"D"});
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kDouble2, "ag/boersego/bgjs/JNIV8Function$Double2Handler", {"D", "D"});
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kString, "ag/boersego/bgjs/JNIV8Function$StringHandler", {"Ljava/lang/String;"});
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kObject, "ag/boersego/bgjs/JNIV8Function$ObjectHandler", {"Ljava/lang/Object;"});
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kV8Object, "ag/boersego/bgjs/JNIV8Function$V8ObjectHandler", {"Lag/boersego/bgjs/JNIV8Object;"});
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kDoubleToDouble, "ag/boersego/bgjs/JNIV8Function$DoubleToDoubleHandler", {"D"}, "D");
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kDouble2ToDouble, "ag/boersego/bgjs/JNIV8Function$Double2ToDoubleHandler", {"D", "D"}, "D");
+    initHandlerInfo(env, JNIV8FunctionHandlerType::kDoubleToBoolean, "ag/boersego/bgjs/JNIV8Function$DoubleToBooleanHandler", {"D"}, "Z");
 }
 
 void JNIV8FunctionWeakPersistentCallback(const v8::WeakCallbackInfo<void>& data) {
     JNIEnv *env = JNIWrapper::getEnvironment();
 
     JNIV8FunctionCallbackHolder *holder = reinterpret_cast<JNIV8FunctionCallbackHolder*>(data.GetParameter());
-    env->DeleteGlobalRef(holder->jFuncRef);
+    BGJS_DELETE_GLOBAL_REF(env, holder->jFuncRef);
 
-    holder->persistent.Reset();
+    BGJS_CLEAR_PERSISTENT(holder->persistent);
     delete holder;
 }
 
@@ -51,6 +96,57 @@ void JNIV8Function::v8FunctionCallback(const v8::FunctionCallbackInfo<v8::Value>
 
     JNIV8FunctionCallbackHolder *holder = static_cast<JNIV8FunctionCallbackHolder*>(ext->Value());
 
+    if(holder->type != JNIV8FunctionHandlerType::kGeneric) {
+        // typed handlers: convert arguments directly to the declared types; no receiver and no argument array
+        const JNIV8FunctionHandlerInfo &handlerInfo = _handlerInfos[(int)holder->type];
+        jvalue jargs[JNIV8FUNCTION_MAX_TYPED_ARGUMENTS];
+        size_t numTypedArgs = handlerInfo.arguments.size();
+
+        for(size_t idx = 0; idx < numTypedArgs; idx++) {
+            // missing arguments are passed as undefined
+            v8::Local<v8::Value> value = args[(int)idx + 1];
+            JNIV8MarshallingError res = JNIV8Marshalling::convertV8ValueToJavaValue(env, value, handlerInfo.arguments[idx], &jargs[idx]);
+            if(res != JNIV8MarshallingError::kOk) {
+                for(size_t idx2 = 0; idx2 < idx; idx2++) {
+                    if(!JNIV8Marshalling::isPrimitive(handlerInfo.arguments[idx2])) env->DeleteLocalRef(jargs[idx2].l);
+                }
+                switch(res) {
+                    default:
+                    case JNIV8MarshallingError::kWrongType:
+                        ThrowV8TypeError("wrong type for argument #" + std::to_string(idx));
+                        break;
+                    case JNIV8MarshallingError::kUndefined:
+                        ThrowV8TypeError("argument #" + std::to_string(idx) + " does not accept undefined");
+                        break;
+                    case JNIV8MarshallingError::kNotNullable:
+                        ThrowV8TypeError("argument #" + std::to_string(idx) + " is not nullable");
+                        break;
+                    case JNIV8MarshallingError::kNoNaN:
+                        ThrowV8TypeError("argument #" + std::to_string(idx) + " must not be NaN");
+                        break;
+                    case JNIV8MarshallingError::kOutOfRange:
+                        ThrowV8RangeError("value '"+
+                                          JNIV8Marshalling::v8string2string(value->ToString(args.GetIsolate()))+"' is out of range for argument #" + std::to_string(idx));
+                        break;
+                }
+                return;
+            }
+        }
+
+        // primitive results are stored in the return value directly; objects are converted and their local reference released
+        JNIV8Marshalling::callJavaMethod(env, handlerInfo.returnType, handlerInfo.clazz, holder->callbackMethodId, holder->jFuncRef, jargs, args.GetReturnValue());
+
+        // functions can be called many times from a single native frame (e.g. in a loop in js) => release local references immediately
+        for(size_t idx = 0; idx < numTypedArgs; idx++) {
+            if(!JNIV8Marshalling::isPrimitive(handlerInfo.arguments[idx])) env->DeleteLocalRef(jargs[idx].l);
+        }
+
+        if(env->ExceptionCheck()) {
+            BGJSV8Engine::GetInstance(args.GetIsolate())->forwardJNIExceptionToV8();
+        }
+        return;
+    }
+
     jobject receiver = JNIV8Marshalling::v8value2jobject(args.This());
     jobjectArray arguments = nullptr;
     jobject value;
@@ -77,8 +173,18 @@ bool JNIV8Function::isWrappableV8Object(v8::Local<v8::Object> object) {
 }
 
 void JNIV8Function::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
-    info->registerNativeMethod("Create", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$Handler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate);
+    info->registerNativeMethod("Create", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$Handler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kGeneric>);
+    info->registerNativeMethod("CreateDouble", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$DoubleHandler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kDouble>);
+    info->registerNativeMethod("CreateDouble2", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$Double2Handler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kDouble2>);
+    info->registerNativeMethod("CreateString", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$StringHandler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kString>);
+    info->registerNativeMethod("CreateObject", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$ObjectHandler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kObject>);
+    info->registerNativeMethod("CreateV8Object", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$V8ObjectHandler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kV8Object>);
+    info->registerNativeMethod("CreateDoubleToDouble", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$DoubleToDoubleHandler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kDoubleToDouble>);
+    info->registerNativeMethod("CreateDouble2ToDouble", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$Double2ToDoubleHandler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kDouble2ToDouble>);
+    info->registerNativeMethod("CreateDoubleToBoolean", "(Lag/boersego/bgjs/V8Engine;Lag/boersego/bgjs/JNIV8Function$DoubleToBooleanHandler;)Lag/boersego/bgjs/JNIV8Function;", (void*)JNIV8Function::jniCreate<JNIV8FunctionHandlerType::kDoubleToBoolean>);
     info->registerNativeMethod("_callAsV8Function", "(ZIILjava/lang/Class;Ljava/lang/Object;[Ljava/lang/Object;)Ljava/lang/Object;", (void*)JNIV8Function::jniCallAsV8Function);
+    info->registerNativeMethod("_callAsV8Functions", "([Lag/boersego/bgjs/JNIV8Function;[Ljava/lang/Object;[[Ljava/lang/Object;[Ljava/lang/Throwable;)[Ljava/lang/Object;", (void*)JNIV8Function::jniCallAsV8Functions);
+    info->registerNativeMethod("_callAsV8FunctionBatch", "(Ljava/lang/Object;[[Ljava/lang/Object;[Ljava/lang/Throwable;)[Ljava/lang/Object;", (void*)JNIV8Function::jniCallAsV8FunctionBatch);
 }
 
 jobject JNIV8Function::jniCallAsV8Function(JNIEnv *env, jobject obj, jboolean asConstructor, jint flags, jint type, jclass returnType, jobject receiver, jobjectArray arguments) {
@@ -181,6 +287,136 @@ jobject JNIV8Function::jniCallAsV8Function(JNIEnv *env, jobject obj, jboolean as
     return jval.l;
 }
 
+jobjectArray JNIV8Function::jniCallAsV8Functions(JNIEnv *env, jobject obj, jobjectArray functions, jobjectArray receivers, jobjectArray arguments, jobjectArray errors) {
+    jsize numCalls = env->GetArrayLength(functions);
+    if(env->GetArrayLength(arguments) != numCalls || (receivers && env->GetArrayLength(receivers) != numCalls) ||
+       (errors && env->GetArrayLength(errors) != numCalls)) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "all arrays must have the same length");
+        return nullptr;
+    }
+
+    // validate all functions first, so that the batch is either executed completely or not at all
+    // the references are dropped again right away; the calls resolve each function when they get to it
+    BGJSV8Engine *engine = nullptr;
+    for(jsize i=0; i<numCalls; i++) {
+        jobject functionObj = env->GetObjectArrayElement(functions, i);
+        auto ptr = JNIWrapper::wrapObject<JNIV8Function>(functionObj);
+        env->DeleteLocalRef(functionObj);
+        if(!ptr) {
+            env->ThrowNew(env->FindClass("java/lang/RuntimeException"),
+                          "Attempt to call method on disposed or invalid object");
+            return nullptr;
+        }
+        if(engine && ptr->getEngine() != engine) {
+            env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "all functions of a batch must belong to the same engine");
+            return nullptr;
+        }
+        engine = ptr->getEngine();
+    }
+
+    return callBatch(env, engine, nullptr, functions, nullptr, receivers, arguments, errors);
+}
+
+jobjectArray JNIV8Function::jniCallAsV8FunctionBatch(JNIEnv *env, jobject obj, jobject receiver, jobjectArray arguments, jobjectArray errors) {
+    auto ptr = JNIWrapper::wrapObject<JNIV8Function>(obj);
+    if(!ptr) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"),
+                      "Attempt to call method on disposed or invalid object");
+        return nullptr;
+    }
+    if(errors && env->GetArrayLength(errors) != env->GetArrayLength(arguments)) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "all arrays must have the same length");
+        return nullptr;
+    }
+
+    return callBatch(env, ptr->getEngine(), ptr.get(), nullptr, receiver, nullptr, arguments, errors);
+}
+
+/**
+ * calls either `function` for every argument list, or every element of `functions` with its own argument list
+ * locker, scopes and buffers are set up only once for the whole batch; java references are scoped to each call
+ * exceptions are stored in `errors` if specified; otherwise the first exception is rethrown once all calls are done
+ */
+jobjectArray JNIV8Function::callBatch(JNIEnv *env, BGJSV8Engine *engine, JNIV8Function *function, jobjectArray functions, jobject receiver, jobjectArray receivers, jobjectArray arguments, jobjectArray errors) {
+    jsize numCalls = env->GetArrayLength(arguments);
+    jobjectArray results = env->NewObjectArray(numCalls, _jniObject.clazz, nullptr);
+    if(!numCalls) {
+        return results;
+    }
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = engine->getContext();
+    v8::Context::Scope ctxScope(context);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+
+    v8::TryCatch try_catch(isolate);
+
+    jthrowable firstError = nullptr;
+    v8::Local<v8::Value> defaultReceiver = JNIV8Marshalling::jobject2v8value(receiver);
+    // reused for all calls; only grows if a call has more arguments than any call before
+    std::vector<v8::Local<v8::Value>> args;
+
+    for(jsize i=0; i<numCalls; i++) {
+        v8::HandleScope callScope(isolate);
+        // everything the call creates on the java side is released before the next one starts
+        JNILocalFrame localFrame(env);
+
+        v8::Local<v8::Function> functionRef;
+        if(functions) {
+            jobject functionObj = env->GetObjectArrayElement(functions, i);
+            functionRef = JNIWrapper::wrapObject<JNIV8Function>(functionObj)->getJSObject().As<v8::Function>();
+        } else {
+            functionRef = function->getJSObject().As<v8::Function>();
+        }
+
+        jobjectArray callArguments = (jobjectArray)env->GetObjectArrayElement(arguments, i);
+        jsize numArgs = callArguments ? env->GetArrayLength(callArguments) : 0;
+        args.resize((size_t)numArgs);
+        for(jsize j=0; j<numArgs; j++) {
+            jobject tempObj = env->GetObjectArrayElement(callArguments, j);
+            args[j] = JNIV8Marshalling::jobject2v8value(tempObj);
+            env->DeleteLocalRef(tempObj);
+        }
+
+        v8::Local<v8::Value> receiverRef = defaultReceiver;
+        if(receivers) {
+            receiverRef = JNIV8Marshalling::jobject2v8value(env->GetObjectArrayElement(receivers, i));
+        }
+
+        v8::MaybeLocal<v8::Value> maybeLocal = functionRef->Call(context, receiverRef, numArgs, numArgs ? args.data() : nullptr);
+        v8::Local<v8::Value> resultRef;
+        if(!env->ExceptionCheck()) {
+            if(maybeLocal.ToLocal(&resultRef)) {
+                env->SetObjectArrayElement(results, i, JNIV8Marshalling::v8value2jobject(resultRef));
+                continue;
+            }
+            // raise the exception on this thread instead of the main thread, so that it can be captured below
+            engine->forwardV8ExceptionToJNI(&try_catch, false);
+        }
+
+        // capture the exception and continue with the next call
+        jthrowable error = env->ExceptionOccurred();
+        env->ExceptionClear();
+        try_catch.Reset();
+        if(errors) {
+            env->SetObjectArrayElement(errors, i, error);
+        } else if(!firstError) {
+            // has to outlive the frame of this call
+            firstError = (jthrowable)localFrame.pop(error);
+        }
+    }
+
+    if(firstError) {
+        env->Throw(firstError);
+        return nullptr;
+    }
+
+    return results;
+}
+
 v8::MaybeLocal<v8::Function> JNIV8Function::getJNIV8FunctionBaseFunction() {
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
     v8::EscapableHandleScope scope(isolate);
@@ -238,6 +474,7 @@ v8::MaybeLocal<v8::Function> JNIV8Function::getJNIV8FunctionBaseFunction() {
     return scope.Escape(funcRef);
 }
 
+template<JNIV8FunctionHandlerType type>
 jobject JNIV8Function::jniCreate(JNIEnv *env, jobject obj, jobject engineObj, jobject handler) {
     auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
 
@@ -250,7 +487,7 @@ jobject JNIV8Function::jniCreate(JNIEnv *env, jobject obj, jobject engineObj, jo
     v8::Context::Scope ctxScope(context);
 
     v8::Local<v8::Function> funcRef;
-    auto maybeFuncRef = createJavaBackedFunction(engine, handler);
+    auto maybeFuncRef = createJavaBackedFunction(engine, type, handler);
     if (!maybeFuncRef.ToLocal(&funcRef)) {
         // exception will already have been thrown at this point
         return nullptr;
@@ -259,7 +496,7 @@ jobject JNIV8Function::jniCreate(JNIEnv *env, jobject obj, jobject engineObj, jo
     return JNIV8Wrapper::wrapObject<JNIV8Function>(funcRef)->getJObject();
 }
 
-v8::MaybeLocal<v8::Function> JNIV8Function::createJavaBackedFunction(JNILocalRef<BGJSV8Engine> engine, jobject handler) {
+v8::MaybeLocal<v8::Function> JNIV8Function::createJavaBackedFunction(JNILocalRef<BGJSV8Engine> engine, JNIV8FunctionHandlerType type, jobject handler) {
     JNIEnv *env = JNIWrapper::getEnvironment();
 
     v8::Isolate* isolate = engine->getIsolate();
@@ -273,8 +510,9 @@ v8::MaybeLocal<v8::Function> JNIV8Function::createJavaBackedFunction(JNILocalRef
 
     // java reference is stored in the functions data parameter to be retrieved when called
     JNIV8FunctionCallbackHolder *holder = new JNIV8FunctionCallbackHolder();
-    holder->jFuncRef = env->NewGlobalRef(handler);
-    holder->callbackMethodId = env->GetMethodID(env->GetObjectClass(handler), "Callback", "(Ljava/lang/Object;[Ljava/lang/Object;)Ljava/lang/Object;");
+    holder->jFuncRef = BGJS_NEW_GLOBAL_REF(env, handler);
+    holder->callbackMethodId = _handlerInfos[(int)type].callbackId;
+    holder->type = type;
 
     v8::Local<v8::External> data = v8::External::New(isolate, (void*)holder);
 
@@ -294,7 +532,7 @@ v8::MaybeLocal<v8::Function> JNIV8Function::createJavaBackedFunction(JNILocalRef
     funcRef = v8::Local<v8::Function>::Cast(localRef);
 
     // we keep track of the function using a weak persistent; when it is gc'd we can release the java reference
-    holder->persistent.Reset(isolate, funcRef);
+    BGJS_RESET_PERSISTENT(isolate, holder->persistent, funcRef);
     holder->persistent.SetWeak((void*)holder, JNIV8FunctionWeakPersistentCallback, v8::WeakCallbackType::kParameter);
 
     return scope.Escape(funcRef);
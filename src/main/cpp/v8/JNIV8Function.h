@@ -7,6 +7,32 @@
 
 #include "JNIV8Wrapper.h"
 
+/**
+ * java handler interfaces that can back a function
+ * typed handlers receive their arguments converted to the declared java types, so that e.g. numbers are not boxed;
+ * the handlers returning primitives do not box their result either
+ */
+enum class JNIV8FunctionHandlerType {
+    // Handler: (Object receiver, Object[] arguments)
+    kGeneric,
+    // DoubleHandler: (double)
+    kDouble,
+    // Double2Handler: (double, double)
+    kDouble2,
+    // StringHandler: (String)
+    kString,
+    // ObjectHandler: (Object)
+    kObject,
+    // V8ObjectHandler: (JNIV8Object)
+    kV8Object,
+    // DoubleToDoubleHandler: (double) -> double
+    kDoubleToDouble,
+    // Double2ToDoubleHandler: (double, double) -> double
+    kDouble2ToDouble,
+    // DoubleToBooleanHandler: (double) -> boolean
+    kDoubleToBoolean
+};
+
 class JNIV8Function : public JNIScope<JNIV8Function, JNIV8Object> {
 public:
     JNIV8Function(jobject obj, JNIClassInfo *info) : JNIScope(obj, info) {};
@@ -14,8 +40,11 @@ public:
     static bool isWrappableV8Object(v8::Local<v8::Object> object);
     static void initializeJNIBindings(JNIClassInfo *info, bool isReload);
 
+    template<JNIV8FunctionHandlerType type>
     static jobject jniCreate(JNIEnv *env, jobject obj, jobject engineObj, jobject handler);
     static jobject jniCallAsV8Function(JNIEnv *env, jobject obj, jboolean asConstructor, jint flags, jint type, jclass returnType, jobject receiver, jobjectArray arguments);
+    static jobjectArray jniCallAsV8Functions(JNIEnv *env, jobject obj, jobjectArray functions, jobjectArray receivers, jobjectArray arguments, jobjectArray errors);
+    static jobjectArray jniCallAsV8FunctionBatch(JNIEnv *env, jobject obj, jobject receiver, jobjectArray arguments, jobjectArray errors);
 
     /**
      * cache JNI class references
@@ -26,8 +55,9 @@ private:
         jclass clazz;
     } _jniObject;
     static v8::MaybeLocal<v8::Function> getJNIV8FunctionBaseFunction();
-    static v8::MaybeLocal<v8::Function> createJavaBackedFunction(JNILocalRef<BGJSV8Engine> engine, jobject handler);
+    static v8::MaybeLocal<v8::Function> createJavaBackedFunction(JNILocalRef<BGJSV8Engine> engine, JNIV8FunctionHandlerType type, jobject handler);
     static void v8FunctionCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static jobjectArray callBatch(JNIEnv *env, BGJSV8Engine *engine, JNIV8Function *function, jobjectArray functions, jobject receiver, jobjectArray receivers, jobjectArray arguments, jobjectArray errors);
 };
 
 BGJS_JNI_LINK_DEF(JNIV8Function)
@@ -0,0 +1,291 @@
+#include "JNIV8JSONWriter.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace v8;
+
+// maximum nesting depth; JSON.stringify would throw a stack overflow at some point as well
+#define JSON_MAX_DEPTH 1024
+
+// largest integer that can be represented exactly as a double (2^53)
+#define JSON_MAX_SAFE_INTEGER 9007199254740992.0
+
+static const char kHexDigits[] = "0123456789abcdef";
+
+JNIV8JSONWriter::JNIV8JSONWriter(Isolate *isolate, Local<Context> context) :
+        _isolate(isolate), _context(context), _isUndefined(false) {
+    _toJSONString = String::NewFromOneByte(isolate, (const uint8_t*)"toJSON", NewStringType::kInternalized).ToLocalChecked();
+    _buffer.reserve(256);
+}
+
+bool JNIV8JSONWriter::write(Local<Value> value) {
+    bool written = false;
+    if(!writeValue(String::Empty(_isolate), value, written)) {
+        return false;
+    }
+    _isUndefined = !written;
+    return true;
+}
+
+bool JNIV8JSONWriter::isUndefined() const {
+    return _isUndefined;
+}
+
+const std::string& JNIV8JSONWriter::getBuffer() const {
+    return _buffer;
+}
+
+bool JNIV8JSONWriter::writeValue(Local<Value> key, Local<Value> value, bool &written) {
+    written = false;
+
+    // objects (and bigints) can customize their representation via toJSON
+    if(value->IsObject() || value->IsBigInt()) {
+        Local<Object> objectRef;
+        if(!value->ToObject(_context).ToLocal(&objectRef)) return false;
+        Local<Value> toJSONRef;
+        if(!objectRef->Get(_context, _toJSONString).ToLocal(&toJSONRef)) return false;
+        if(toJSONRef->IsFunction()) {
+            // array indices are passed as numbers and only converted if they are actually required
+            if(!key->IsString() && !key->ToString(_context).ToLocal(&key)) return false;
+            Local<Value> args[] = {key};
+            if(!toJSONRef.As<Function>()->Call(_context, value, 1, args).ToLocal(&value)) return false;
+        }
+    }
+
+    // unwrap primitive wrapper objects
+    if(value->IsNumberObject()) {
+        double number;
+        if(!value->NumberValue(_context).To(&number)) return false;
+        value = Number::New(_isolate, number);
+    } else if(value->IsStringObject()) {
+        if(!value->ToString(_context).ToLocal(&value)) return false;
+    } else if(value->IsBooleanObject()) {
+        value = Boolean::New(_isolate, value.As<BooleanObject>()->ValueOf());
+    } else if(value->IsBigIntObject()) {
+        value = value.As<BigIntObject>()->ValueOf();
+    }
+
+    if(value->IsNull()) {
+        _buffer.append("null", 4);
+    } else if(value->IsTrue()) {
+        _buffer.append("true", 4);
+    } else if(value->IsFalse()) {
+        _buffer.append("false", 5);
+    } else if(value->IsString()) {
+        writeString(value.As<String>());
+    } else if(value->IsNumber()) {
+        writeNumber(value);
+    } else if(value->IsBigInt()) {
+        _isolate->ThrowException(Exception::TypeError(
+                String::NewFromUtf8(_isolate, "Do not know how to serialize a BigInt")));
+        return false;
+    } else if(value->IsObject() && !value->IsFunction()) {
+        if(_stack.size() >= JSON_MAX_DEPTH) {
+            _isolate->ThrowException(Exception::RangeError(
+                    String::NewFromUtf8(_isolate, "Maximum call stack size exceeded")));
+            return false;
+        }
+        Local<Object> objectRef = value.As<Object>();
+        if(std::find(_stack.begin(), _stack.end(), objectRef) != _stack.end()) {
+            _isolate->ThrowException(Exception::TypeError(
+                    String::NewFromUtf8(_isolate, "Converting circular structure to JSON")));
+            return false;
+        }
+
+        bool success;
+        _stack.push_back(objectRef);
+        if(value->IsArray()) {
+            success = writeArray(objectRef, value.As<Array>()->Length());
+        } else if(value->IsProxy() && value.As<Proxy>()->GetTarget()->IsArray()) {
+            // proxies are serialized based on their target, but all access has to go through the proxy
+            Local<Value> lengthRef;
+            uint32_t length;
+            success = objectRef->Get(_context, String::NewFromOneByte(_isolate, (const uint8_t*)"length", NewStringType::kInternalized).ToLocalChecked()).ToLocal(&lengthRef) &&
+                      lengthRef->Uint32Value(_context).To(&length) &&
+                      writeArray(objectRef, length);
+        } else {
+            success = writeObject(objectRef);
+        }
+        _stack.pop_back();
+        if(!success) return false;
+    } else {
+        // undefined, functions & symbols have no JSON representation
+        return true;
+    }
+
+    written = true;
+    return true;
+}
+
+bool JNIV8JSONWriter::writeObject(Local<Object> object) {
+    HandleScope scope(_isolate);
+
+    Local<Array> keysRef;
+    if(!object->GetOwnPropertyNames(_context).ToLocal(&keysRef)) return false;
+
+    bool first = true, written;
+    size_t rollback;
+
+    _buffer.push_back('{');
+    for(uint32_t i = 0, n = keysRef->Length(); i < n; i++) {
+        HandleScope itemScope(_isolate);
+        Local<Value> keyRef, valueRef;
+        Local<String> keyStringRef;
+
+        if(!keysRef->Get(_context, i).ToLocal(&keyRef)) return false;
+        if(!object->Get(_context, keyRef).ToLocal(&valueRef)) return false;
+        if(!keyRef->ToString(_context).ToLocal(&keyStringRef)) return false;
+
+        // properties without a JSON representation are skipped entirely => key has to be removed again
+        rollback = _buffer.size();
+        if(!first) _buffer.push_back(',');
+        writeString(keyStringRef);
+        _buffer.push_back(':');
+        if(!writeValue(keyStringRef, valueRef, written)) return false;
+        if(written) {
+            first = false;
+        } else {
+            _buffer.resize(rollback);
+        }
+    }
+    _buffer.push_back('}');
+
+    return true;
+}
+
+bool JNIV8JSONWriter::writeArray(Local<Object> array, uint32_t length) {
+    bool written;
+
+    _buffer.push_back('[');
+    for(uint32_t i = 0; i < length; i++) {
+        HandleScope itemScope(_isolate);
+        Local<Value> valueRef;
+
+        if(i) _buffer.push_back(',');
+        if(!array->Get(_context, i).ToLocal(&valueRef)) return false;
+        if(!writeValue(Integer::NewFromUnsigned(_isolate, i), valueRef, written)) return false;
+        // elements without a JSON representation are serialized as null
+        if(!written) {
+            _buffer.append("null", 4);
+        }
+    }
+    _buffer.push_back(']');
+
+    return true;
+}
+
+void JNIV8JSONWriter::writeNumber(Local<Value> number) {
+    double value = number.As<Number>()->Value();
+
+    if(!std::isfinite(value)) {
+        _buffer.append("null", 4);
+        return;
+    }
+
+    // fast path for integers; everything else has to be formatted exactly like Number.prototype.toString
+    if(value == std::trunc(value) && std::fabs(value) < JSON_MAX_SAFE_INTEGER) {
+        char digits[24];
+        int64_t integer = (int64_t)value;
+        uint64_t magnitude = integer < 0 ? (uint64_t)-integer : (uint64_t)integer;
+        char *end = digits + sizeof(digits), *p = end;
+        do {
+            *--p = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while(magnitude);
+        if(integer < 0) *--p = '-';
+        _buffer.append(p, (size_t)(end - p));
+        return;
+    }
+
+    Local<String> stringRef = number->ToString(_context).ToLocalChecked();
+    size_t offset = _buffer.size();
+    int length = stringRef->Length();
+    _buffer.resize(offset + length);
+    stringRef->WriteOneByte(_isolate, (uint8_t*)&_buffer[offset], 0, length, String::NO_NULL_TERMINATION);
+}
+
+void JNIV8JSONWriter::writeString(Local<String> string) {
+    int length = string->Length();
+
+    _buffer.push_back('"');
+    if(length) {
+        _scratch.resize((size_t)length);
+        if(string->IsOneByte()) {
+            auto chars = (uint8_t*)_scratch.data();
+            string->WriteOneByte(_isolate, chars, 0, length, String::NO_NULL_TERMINATION);
+            writeLatin1(chars, length);
+        } else {
+            string->Write(_isolate, _scratch.data(), 0, length, String::NO_NULL_TERMINATION);
+            writeUTF16(_scratch.data(), length);
+        }
+    }
+    _buffer.push_back('"');
+}
+
+/**
+ * appends the escape sequence for the specified character if it has to be escaped in JSON
+ * returns false if the character can be written as is
+ */
+static inline bool appendEscaped(std::string &buffer, uint16_t c) {
+    switch(c) {
+        case '"': buffer.append("\\\"", 2); return true;
+        case '\\': buffer.append("\\\\", 2); return true;
+        case '\b': buffer.append("\\b", 2); return true;
+        case '\f': buffer.append("\\f", 2); return true;
+        case '\n': buffer.append("\\n", 2); return true;
+        case '\r': buffer.append("\\r", 2); return true;
+        case '\t': buffer.append("\\t", 2); return true;
+        default:
+            // control characters and lone surrogates
+            if(c < 0x20 || (c >= 0xD800 && c <= 0xDFFF)) {
+                char escaped[6] = {'\\', 'u', kHexDigits[c >> 12], kHexDigits[(c >> 8) & 0xF],
+                                   kHexDigits[(c >> 4) & 0xF], kHexDigits[c & 0xF]};
+                buffer.append(escaped, 6);
+                return true;
+            }
+            return false;
+    }
+}
+
+void JNIV8JSONWriter::writeLatin1(const uint8_t *chars, int length) {
+    int start = 0;
+    for(int i = 0; i < length; i++) {
+        uint8_t c = chars[i];
+        if(c >= 0x20 && c < 0x80 && c != '"' && c != '\\') continue;
+
+        // flush run of plain ascii characters
+        _buffer.append((const char*)chars + start, (size_t)(i - start));
+        start = i + 1;
+
+        if(c >= 0x80) {
+            _buffer.push_back((char)(0xC0 | (c >> 6)));
+            _buffer.push_back((char)(0x80 | (c & 0x3F)));
+        } else {
+            appendEscaped(_buffer, c);
+        }
+    }
+    _buffer.append((const char*)chars + start, (size_t)(length - start));
+}
+
+void JNIV8JSONWriter::writeUTF16(const uint16_t *chars, int length) {
+    for(int i = 0; i < length; i++) {
+        uint16_t c = chars[i];
+        if(c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+            _buffer.push_back((char)c);
+        } else if(c >= 0x80 && c < 0x800) {
+            _buffer.push_back((char)(0xC0 | (c >> 6)));
+            _buffer.push_back((char)(0x80 | (c & 0x3F)));
+        } else if(c >= 0xD800 && c <= 0xDBFF && i + 1 < length && chars[i + 1] >= 0xDC00 && chars[i + 1] <= 0xDFFF) {
+            // valid surrogate pair
+            uint32_t codePoint = 0x10000 + (((uint32_t)c - 0xD800) << 10) + ((uint32_t)chars[++i] - 0xDC00);
+            _buffer.push_back((char)(0xF0 | (codePoint >> 18)));
+            _buffer.push_back((char)(0x80 | ((codePoint >> 12) & 0x3F)));
+            _buffer.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+            _buffer.push_back((char)(0x80 | (codePoint & 0x3F)));
+        } else if(!appendEscaped(_buffer, c)) {
+            _buffer.push_back((char)(0xE0 | (c >> 12)));
+            _buffer.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            _buffer.push_back((char)(0x80 | (c & 0x3F)));
+        }
+    }
+}
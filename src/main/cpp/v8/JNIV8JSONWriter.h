@@ -0,0 +1,51 @@
+#ifndef ANDROID_TRADINGLIB_SAMPLE_JNIV8JSONWRITER_H
+#define ANDROID_TRADINGLIB_SAMPLE_JNIV8JSONWRITER_H
+
+#include <v8.h>
+#include <string>
+#include <vector>
+
+/**
+ * serializes v8 values to UTF-8 encoded JSON without going through JSON.stringify and a v8::String
+ * output is identical to JSON.stringify(value) (without replacer or indentation)
+ */
+class JNIV8JSONWriter {
+public:
+    JNIV8JSONWriter(v8::Isolate *isolate, v8::Local<v8::Context> context);
+
+    /**
+     * serialize the specified value and append it to the buffer
+     * returns false if an exception was thrown; in that case the content of the buffer is undefined
+     * if the value can not be represented in JSON (undefined, functions, symbols) isUndefined() will return true
+     */
+    bool write(v8::Local<v8::Value> value);
+
+    /**
+     * returns true if the last value passed to write did not produce any output
+     */
+    bool isUndefined() const;
+
+    const std::string& getBuffer() const;
+private:
+    /**
+     * writes a single value; returns false if an exception was thrown
+     * if the value can not be serialized nothing is written and written is set to false
+     */
+    bool writeValue(v8::Local<v8::Value> key, v8::Local<v8::Value> value, bool &written);
+    bool writeObject(v8::Local<v8::Object> object);
+    bool writeArray(v8::Local<v8::Object> array, uint32_t length);
+    void writeNumber(v8::Local<v8::Value> number);
+    void writeString(v8::Local<v8::String> string);
+    void writeUTF16(const uint16_t *chars, int length);
+    void writeLatin1(const uint8_t *chars, int length);
+
+    v8::Isolate *_isolate;
+    v8::Local<v8::Context> _context;
+    v8::Local<v8::String> _toJSONString;
+    std::string _buffer;
+    std::vector<v8::Local<v8::Object>> _stack;
+    std::vector<uint16_t> _scratch;
+    bool _isUndefined;
+};
+
+#endif //ANDROID_TRADINGLIB_SAMPLE_JNIV8JSONWRITER_H
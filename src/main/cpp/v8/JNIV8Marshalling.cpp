@@ -12,6 +12,8 @@
 #include "JNIV8Promise.h"
 #include "JNIV8Array.h"
 #include "JNIV8ArrayBuffer.h"
+#include "JNIV8TypedArray.h"
+#include "JNIV8DataView.h"
 #include "JNIV8Symbol.h"
 #include "JNIV8GenericObject.h"
 
@@ -208,7 +210,7 @@ void JNIV8Marshalling::initJNICache() {
  * converts a v8 value to a java value based on the provided type information
  * if conversion was successful method will return kOk and target will contain a valid jvalue
  */
-JNIV8MarshallingError JNIV8Marshalling::convertV8ValueToJavaValue(JNIEnv *env, v8::Local<v8::Value> v8Value, JNIV8JavaValue arg, jvalue *target) {
+JNIV8MarshallingError JNIV8Marshalling::convertV8ValueToJavaValue(JNIEnv *env, v8::Local<v8::Value> v8Value, const JNIV8JavaValue &arg, jvalue *target) {
     double numberValue;
     // non-primitive types can handle null; and undefined if it is configured to be mapped to null!
     if(!(arg.flags & JNIV8MarshallingFlags::kCoerceNull) && arg.clazz &&
@@ -428,6 +430,57 @@ v8::Local<v8::Value> JNIV8Marshalling::callJavaMethod(JNIEnv *env, JNIV8JavaValu
     return handleScope.Escape(result);
 }
 
+void JNIV8Marshalling::callJavaMethod(JNIEnv *env, const JNIV8JavaValue &returnType, jclass clazz, jmethodID methodId, jobject object, jvalue *args, v8::ReturnValue<v8::Value> returnValue) {
+    // if the method throws, the value that is set here is ignored because the exception is forwarded to v8 by the caller
+    if(!returnType.clazz) {
+        switch(returnType.valueType) {
+            case JNIV8JavaValueType::kBoolean:
+                returnValue.Set((bool)(object ? env->CallBooleanMethodA(object, methodId, args) :
+                                       env->CallStaticBooleanMethodA(clazz, methodId, args)));
+                return;
+            case JNIV8JavaValueType::kByte:
+                returnValue.Set((int32_t)(object ? env->CallByteMethodA(object, methodId, args) :
+                                          env->CallStaticByteMethodA(clazz, methodId, args)));
+                return;
+            case JNIV8JavaValueType::kShort:
+                returnValue.Set((int32_t)(object ? env->CallShortMethodA(object, methodId, args) :
+                                          env->CallStaticShortMethodA(clazz, methodId, args)));
+                return;
+            case JNIV8JavaValueType::kInteger:
+                returnValue.Set((int32_t)(object ? env->CallIntMethodA(object, methodId, args) :
+                                          env->CallStaticIntMethodA(clazz, methodId, args)));
+                return;
+            case JNIV8JavaValueType::kLong:
+                returnValue.Set((double)(object ? env->CallLongMethodA(object, methodId, args) :
+                                         env->CallStaticLongMethodA(clazz, methodId, args)));
+                return;
+            case JNIV8JavaValueType::kFloat:
+                returnValue.Set((double)(object ? env->CallFloatMethodA(object, methodId, args) :
+                                         env->CallStaticFloatMethodA(clazz, methodId, args)));
+                return;
+            case JNIV8JavaValueType::kDouble:
+                returnValue.Set(object ? env->CallDoubleMethodA(object, methodId, args) :
+                                env->CallStaticDoubleMethodA(clazz, methodId, args));
+                return;
+            case JNIV8JavaValueType::kVoid:
+                if (object) {
+                    env->CallVoidMethodA(object, methodId, args);
+                } else {
+                    env->CallStaticVoidMethodA(clazz, methodId, args);
+                }
+                returnValue.SetUndefined();
+                return;
+            default:
+                break;
+        }
+    }
+
+    returnValue.Set(callJavaMethod(env, returnType, clazz, methodId, object, args));
+}
+
+bool JNIV8Marshalling::isPrimitive(const JNIV8JavaValue &value) {
+    return !value.clazz && value.valueType != JNIV8JavaValueType::kObject && value.valueType != JNIV8JavaValueType::kString;
+}
 
 /**
  * convert a jstring to a std::string
@@ -500,6 +553,10 @@ jobject JNIV8Marshalling::v8value2jobject(v8::Local<v8::Value> valueRef) {
             return JNIV8Wrapper::wrapObject<JNIV8Promise>(objectRef)->getJObject();
         } else if(valueRef->IsArrayBuffer()) {
             return JNIV8Wrapper::wrapObject<JNIV8ArrayBuffer>(objectRef)->getJObject();
+        } else if(valueRef->IsTypedArray()) {
+            return JNIV8Wrapper::wrapObject<JNIV8TypedArray>(objectRef)->getJObject();
+        } else if(valueRef->IsDataView()) {
+            return JNIV8Wrapper::wrapObject<JNIV8DataView>(objectRef)->getJObject();
         }
         auto ptr = JNIV8Wrapper::wrapObject<JNIV8Object>(objectRef);
         if (ptr) {
@@ -538,9 +595,11 @@ v8::Local<v8::Value> JNIV8Marshalling::jobject2v8value(jobject object) {
     JNIEnv *env = JNIWrapper::getEnvironment();
 
     // jobject referencing "null" can actually be non-null..
-    if(env->IsSameObject(object, nullptr) || !object) {
-        resultRef = v8::Null(isolate);
-    } else if(env->IsInstanceOf(object, _jniString.clazz)) {
+    if(!object || env->IsSameObject(object, nullptr)) {
+        return scope.Escape(v8::Null(isolate));
+    }
+
+    if(env->IsInstanceOf(object, _jniString.clazz)) {
         resultRef = JNIV8Marshalling::jstring2v8string((jstring)object);
     } else if(env->IsInstanceOf(object, _jniCharacter.clazz)) {
         jchar c = env->CallCharMethod(object, _jniCharacter.charValueId);
@@ -560,6 +619,14 @@ v8::Local<v8::Value> JNIV8Marshalling::jobject2v8value(jobject object) {
         if(resultRef->IsSymbolObject()) {
             resultRef = resultRef.As<v8::SymbolObject>()->ValueOf();
         }
+    } else {
+        // primitive arrays are copied into typed arrays with the same element type
+        jclass clazz = env->GetObjectClass(object);
+        JNIV8TypedArrayType arrayType;
+        if(JNIV8TypedArray::getTypeForArrayClass(env, clazz, &arrayType)) {
+            resultRef = JNIV8TypedArray::newTypedArrayWithArray(env, isolate, arrayType, (jarray)object);
+        }
+        env->DeleteLocalRef(clazz);
     }
     if(resultRef.IsEmpty()) {
         resultRef = v8::Undefined(isolate);
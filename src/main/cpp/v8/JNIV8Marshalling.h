@@ -74,6 +74,8 @@ struct JNIV8JavaValue {
 struct JNIV8ObjectJavaSignatureInfo {
     jmethodID javaMethodId;
     std::vector<JNIV8JavaValue>* arguments;
+    // true if neither arguments nor return value require local references
+    bool isPrimitive;
 };
 
 class JNIV8Marshalling {
@@ -98,7 +100,7 @@ public:
      * converts a v8 value to a java value based on the provided type information
      * if conversion was successful method will return kOk and target will contain a valid jvalue
      */
-    static JNIV8MarshallingError convertV8ValueToJavaValue(JNIEnv *env, v8::Local<v8::Value> v8Value, JNIV8JavaValue arg, jvalue *target);
+    static JNIV8MarshallingError convertV8ValueToJavaValue(JNIEnv *env, v8::Local<v8::Value> v8Value, const JNIV8JavaValue &arg, jvalue *target);
 
     /**
      * calls a java method with the provided arguments
@@ -106,6 +108,17 @@ public:
      */
     static v8::Local<v8::Value> callJavaMethod(JNIEnv *env, JNIV8JavaValue returnType, jclass clazz, jmethodID methodId, jobject object, jvalue *args);
 
+    /**
+     * calls a java method and stores the result in the provided return value
+     * numbers and booleans are stored directly, without creating a handle or a local reference frame
+     */
+    static void callJavaMethod(JNIEnv *env, const JNIV8JavaValue &returnType, jclass clazz, jmethodID methodId, jobject object, jvalue *args, v8::ReturnValue<v8::Value> returnValue);
+
+    /**
+     * returns true if values of the specified type can be converted without creating local references
+     */
+    static bool isPrimitive(const JNIV8JavaValue &value);
+
     /**
      * convert a v8 value to an instance of Object
      */
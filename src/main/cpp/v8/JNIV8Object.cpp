@@ -6,11 +6,15 @@
 #include "JNIV8Wrapper.h"
 #include "../bgjs/BGJSV8Engine.h"
 #include "JNIV8Function.h"
+#include "JNIV8JSONWriter.h"
 
 #include <stdlib.h>
 
 #define LOG_TAG "JNIV8Object"
 
+// number of entries processed per local reference frame when converting large objects
+#define JNI_LOCAL_FRAME_BATCH_SIZE 128
+
 using namespace v8;
 
 BGJS_JNI_LINK(JNIV8Object, "ag/boersego/bgjs/JNIV8Object");
@@ -59,18 +63,40 @@ JNIV8Object::JNIV8Object(jobject obj, JNIClassInfo *info) : JNIObject(obj, info)
 }
 
 JNIV8Object::~JNIV8Object() {
-    v8::Locker l(_bgjsEngine->getIsolate());
+    Isolate *isolate = _bgjsEngine->getIsolate();
+    v8::Locker l(isolate);
     // __android_log_print(ANDROID_LOG_INFO, "JNIV8Object", "deleted v8 object: %s", getCanonicalName().c_str());
     if(!_jsObject.IsEmpty()) {
+        if(_v8ClassInfo->container->type == JNIV8ObjectType::kWrapper) {
+            // unlink from the js object, unless a newer wrapper has already replaced this one (see JNIV8Wrapper::wrapObject)
+            Isolate::Scope isolateScope(isolate);
+            HandleScope scope(isolate);
+            Local<Context> context = _bgjsEngine->getContext();
+            Context::Scope ctxScope(context);
+            Local<Object> jsObject = Local<Object>::New(isolate, _jsObject);
+            Local<Private> peerKey = _bgjsEngine->getWrapperPeerKey();
+            Local<Value> peerValue;
+            if(jsObject->GetPrivate(context, peerKey).ToLocal(&peerValue) && peerValue->IsExternal() &&
+               peerValue.As<External>()->Value() == (void*)this) {
+                jsObject->DeletePrivate(context, peerKey);
+            }
+        }
         // adjust external memory counter if required
         JNI_ASSERT(!_jsObject.IsWeak(), "JNIV8Object deleted while still referenced by JavaScript");
-        _jsObject.Reset();
+        BGJS_CLEAR_PERSISTENT(_jsObject);
     }
 }
 
 void JNIV8Object::OnJSObjectAssigned() {
 }
 
+bool JNIV8Object::dispose() {
+    // wrappers can be handed out again by JNIV8Wrapper::wrapObject while holding the locker
+    // => the check and the deletion must not be interleaved with that
+    v8::Locker l(_bgjsEngine->getIsolate());
+    return JNIObject::dispose();
+}
+
 void JNIV8Object::weakPersistentCallback(const WeakCallbackInfo<void>& data) {
     // never use the raw pointer directly; this way we are retaining the object until this method finishes!
     auto jniV8Object = reinterpret_cast<JNIV8Object*>(data.GetParameter());
@@ -115,7 +141,7 @@ void JNIV8Object::linkJSObject(v8::Handle<v8::Object> jsObject) {
     }
 
     // store reference in persistent
-    _jsObject.Reset(isolate, jsObject);
+    BGJS_RESET_PERSISTENT(isolate, _jsObject, jsObject);
 }
 
 void JNIV8Object::adjustJSExternalMemory(int64_t change) {
@@ -191,15 +217,21 @@ void JNIV8Object::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
     info->registerNativeMethod("_getV8Field", "(Ljava/lang/String;IILjava/lang/Class;)Ljava/lang/Object;", (void*)JNIV8Object::jniGetV8FieldWithReturnType);
     info->registerNativeMethod("setV8Field", "(Ljava/lang/String;Ljava/lang/Object;)V", (void*)JNIV8Object::jniSetV8Field);
     info->registerNativeMethod("setV8Fields", "(Ljava/util/Map;)V", (void*)JNIV8Object::jniSetV8Fields);
+    info->registerNativeMethod("setV8Fields", "([Ljava/lang/String;[Ljava/lang/Object;)V", (void*)JNIV8Object::jniSetV8FieldsWithArrays);
+    info->registerNativeMethod("setV8Fields", "([Ljava/lang/String;[D)V", (void*)JNIV8Object::jniSetV8FieldsWithDoubles);
     info->registerNativeMethod("setV8Accessor", "(Ljava/lang/String;Lag/boersego/bgjs/JNIV8Function;Lag/boersego/bgjs/JNIV8Function;)V", (void*)JNIV8Object::jniSetV8Accessor);
 
     info->registerNativeMethod("hasV8Field", "(Ljava/lang/String;Z)Z", (void*)JNIV8Object::jniHasV8Field);
     info->registerNativeMethod("getV8Keys", "(Z)[Ljava/lang/String;", (void*)JNIV8Object::jniGetV8Keys);
     info->registerNativeMethod("getV8Fields", "(ZIILjava/lang/Class;)Ljava/util/Map;", (void*)JNIV8Object::jniGetV8Fields);
+    info->registerNativeMethod("_getV8Fields", "([Ljava/lang/String;IILjava/lang/Class;)[Ljava/lang/Object;", (void*)JNIV8Object::jniGetV8FieldsWithArray);
+    info->registerNativeMethod("getV8Fields", "([Ljava/lang/String;[D)V", (void*)JNIV8Object::jniGetV8FieldsWithDoubles);
 
     info->registerNativeMethod("toNumber", "()D", (void*)JNIV8Object::jniToNumber);
     info->registerNativeMethod("toString", "()Ljava/lang/String;", (void*)JNIV8Object::jniToString);
     info->registerNativeMethod("toJSON", "()Ljava/lang/String;", (void*)JNIV8Object::jniToJSON);
+    info->registerNativeMethod("toJSONBytes", "()[B", (void*)JNIV8Object::jniToJSONBytes);
+    info->registerNativeMethod("toJSONBytes", "(Ljava/nio/ByteBuffer;)I", (void*)JNIV8Object::jniToJSONBuffer);
 
     info->registerNativeMethod("isInstanceOf", "(Lag/boersego/bgjs/JNIV8Function;)Z", (void*)JNIV8Object::jniIsInstanceOfByConstructor);
     info->registerNativeMethod("isInstanceOf", "(Ljava/lang/String;)Z", (void*)JNIV8Object::jniIsInstanceOfByName);
@@ -224,7 +256,7 @@ jobject JNIV8Object::jniCreate(JNIEnv *env, jobject obj, jobject engineObj, jstr
     v8::TryCatch try_catch(isolate);
 
     v8::Local<v8::Value> localRef;
-    v8::MaybeLocal<v8::Value> maybeLocalRef = globalRef->Get(context, JNIV8Marshalling::jstring2v8string(name));
+    v8::MaybeLocal<v8::Value> maybeLocalRef = globalRef->Get(context, engine->getPropertyNameCache().get(isolate, name));
     if(!maybeLocalRef.ToLocal(&localRef)) {
         engine->forwardV8ExceptionToJNI(&try_catch);
         return nullptr;
@@ -280,7 +312,7 @@ jobject JNIV8Object::jniGetV8FieldWithReturnType(JNIEnv *env, jobject obj, jstri
 
     JNIV8JavaValue arg = JNIV8Marshalling::valueWithClass(type, returnType, (JNIV8MarshallingFlags)flags);
 
-    MaybeLocal<Value> valueRef = localRef->Get(context, JNIV8Marshalling::jstring2v8string(name));
+    MaybeLocal<Value> valueRef = localRef->Get(context, engine->getPropertyNameCache().get(isolate, name));
     if(valueRef.IsEmpty()) {
         ptr->getEngine()->forwardV8ExceptionToJNI(&try_catch);
         return nullptr;
@@ -322,7 +354,7 @@ jobject JNIV8Object::jniGetV8FieldWithReturnType(JNIEnv *env, jobject obj, jstri
 void JNIV8Object::jniSetV8Field(JNIEnv *env, jobject obj, jstring name, jobject value) {
     JNIV8Object_PrepareJNICall(JNIV8Object, Object, void());
 
-    Maybe<bool> res = localRef->Set(context, JNIV8Marshalling::jstring2v8string(name), JNIV8Marshalling::jobject2v8value(value));
+    Maybe<bool> res = localRef->Set(context, engine->getPropertyNameCache().get(isolate, name), JNIV8Marshalling::jobject2v8value(value));
     if(res.IsNothing()) {
         ptr->getEngine()->forwardV8ExceptionToJNI(&try_catch);
     }
@@ -341,20 +373,84 @@ void JNIV8Object::jniSetV8Fields(JNIEnv *env, jobject obj, jobject map) {
         return;
     }
 
+    // local references of the entries are released in batches instead of individually
+    JNILocalFrame localFrame(env, JNI_LOCAL_FRAME_BATCH_SIZE * 3);
+    size_t count = 0;
     while (env->CallBooleanMethod(iter, _jniIterator.hasNextId)) {
+        if(count && count % JNI_LOCAL_FRAME_BATCH_SIZE == 0) {
+            localFrame.reset(JNI_LOCAL_FRAME_BATCH_SIZE * 3);
+        }
+        count++;
+        HandleScope itemScope(isolate);
+
         jobject entry = env->CallObjectMethod(iter, _jniIterator.nextId);
         jstring key = (jstring) env->CallObjectMethod(entry, _jniMapEntry.getKeyId);
         jobject value = env->CallObjectMethod(entry, _jniMapEntry.getValueId);
 
-        Maybe<bool> res = localRef->Set(context, JNIV8Marshalling::jstring2v8string(key), JNIV8Marshalling::jobject2v8value(value));
+        Maybe<bool> res = localRef->Set(context, engine->getPropertyNameCache().get(isolate, key), JNIV8Marshalling::jobject2v8value(value));
         if(res.IsNothing()) {
             ptr->getEngine()->forwardV8ExceptionToJNI(&try_catch);
             break;
         }
+    }
+}
+
+void JNIV8Object::jniSetV8FieldsWithArrays(JNIEnv *env, jobject obj, jobjectArray keys, jobjectArray values) {
+    JNIV8Object_PrepareJNICall(JNIV8Object, Object, void());
+
+    jsize numFields = env->GetArrayLength(keys);
+    if(env->GetArrayLength(values) != numFields) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Number of keys and values does not match");
+        return;
+    }
+
+    JNILocalFrame localFrame(env, JNI_LOCAL_FRAME_BATCH_SIZE * 2);
+    for(jsize i = 0; i < numFields; i++) {
+        if(i && i % JNI_LOCAL_FRAME_BATCH_SIZE == 0) {
+            localFrame.reset(JNI_LOCAL_FRAME_BATCH_SIZE * 2);
+        }
+        HandleScope itemScope(isolate);
+
+        auto key = (jstring)env->GetObjectArrayElement(keys, i);
+        jobject value = env->GetObjectArrayElement(values, i);
+
+        Maybe<bool> res = localRef->Set(context, engine->getPropertyNameCache().get(isolate, key), JNIV8Marshalling::jobject2v8value(value));
+        if(res.IsNothing()) {
+            engine->forwardV8ExceptionToJNI(&try_catch);
+            return;
+        }
+    }
+}
+
+void JNIV8Object::jniSetV8FieldsWithDoubles(JNIEnv *env, jobject obj, jobjectArray keys, jdoubleArray values) {
+    JNIV8Object_PrepareJNICall(JNIV8Object, Object, void());
+
+    jsize numFields = env->GetArrayLength(keys);
+    if(env->GetArrayLength(values) != numFields) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Number of keys and values does not match");
+        return;
+    }
+
+    // all values are copied with a single call
+    std::vector<jdouble> numbers((size_t)numFields);
+    if(numFields) {
+        env->GetDoubleArrayRegion(values, 0, numFields, numbers.data());
+    }
+
+    JNILocalFrame localFrame(env, JNI_LOCAL_FRAME_BATCH_SIZE);
+    for(jsize i = 0; i < numFields; i++) {
+        if(i && i % JNI_LOCAL_FRAME_BATCH_SIZE == 0) {
+            localFrame.reset(JNI_LOCAL_FRAME_BATCH_SIZE);
+        }
+        HandleScope itemScope(isolate);
+
+        auto key = (jstring)env->GetObjectArrayElement(keys, i);
 
-        env->DeleteLocalRef(entry);
-        env->DeleteLocalRef(key);
-        env->DeleteLocalRef(value);
+        Maybe<bool> res = localRef->Set(context, engine->getPropertyNameCache().get(isolate, key), Number::New(isolate, numbers[i]));
+        if(res.IsNothing()) {
+            engine->forwardV8ExceptionToJNI(&try_catch);
+            return;
+        }
     }
 }
 
@@ -367,7 +463,7 @@ void JNIV8Object::jniSetV8Accessor(JNIEnv *env, jobject obj, jstring name, jobje
     if(!getterFunction) return;
 
     localRef->SetAccessorProperty(
-        JNIV8Marshalling::jstring2v8string(name),
+        engine->getPropertyNameCache().get(isolate, name),
         getterFunction->getJSObject().As<Function>(),
         setterFunction ? setterFunction->getJSObject().As<Function>() : Local<Function>(),
         !setterFunction ? PropertyAttribute::ReadOnly : PropertyAttribute::None
@@ -381,7 +477,7 @@ jobject JNIV8Object::jniCallV8MethodWithReturnType(JNIEnv *env, jobject obj, jst
 
     MaybeLocal<Value> maybeLocal;
     Local<Value> funcRef;
-    maybeLocal = localRef->Get(context, JNIV8Marshalling::jstring2v8string(name));
+    maybeLocal = localRef->Get(context, engine->getPropertyNameCache().get(isolate, name));
     if (!maybeLocal.ToLocal<Value>(&funcRef)) {
         ptr->getEngine()->forwardV8ExceptionToJNI(&try_catch);
         return nullptr;
@@ -455,7 +551,7 @@ jobject JNIV8Object::jniCallV8MethodWithReturnType(JNIEnv *env, jobject obj, jst
 jboolean JNIV8Object::jniHasV8Field(JNIEnv *env, jobject obj, jstring name, jboolean ownOnly) {
     JNIV8Object_PrepareJNICall(JNIV8Object, Object, false);
 
-    Local<String> keyRef = JNIV8Marshalling::jstring2v8string(name);
+    Local<String> keyRef = engine->getPropertyNameCache().get(isolate, name);
     Maybe<bool> res = ownOnly ? localRef->HasOwnProperty(context, keyRef) : localRef->Has(context, keyRef);
     if(res.IsNothing()) {
         ptr->getEngine()->forwardV8ExceptionToJNI(&try_catch);
@@ -520,7 +616,15 @@ jobject JNIV8Object::jniGetV8Fields(JNIEnv *env, jobject obj, jboolean ownOnly,
     memset(&jval, 0, sizeof(jvalue));
 
     jobject result = env->NewObject(_jniHashMap.clazz, _jniHashMap.initId);
+
+    // local references of the entries are released in batches instead of individually
+    JNILocalFrame localFrame(env, JNI_LOCAL_FRAME_BATCH_SIZE * 3);
     for(uint32_t i=0,n=arrayRef->Length(); i<n; i++) {
+        if(i && i % JNI_LOCAL_FRAME_BATCH_SIZE == 0) {
+            localFrame.reset(JNI_LOCAL_FRAME_BATCH_SIZE * 3);
+        }
+        HandleScope itemScope(isolate);
+
         MaybeLocal<Value> maybeValueRef = arrayRef->Get(context, i);
         if(!maybeValueRef.ToLocal<Value>(&valueRef)) {
             ptr->getEngine()->forwardV8ExceptionToJNI(&try_catch);
@@ -568,13 +672,108 @@ jobject JNIV8Object::jniGetV8Fields(JNIEnv *env, jobject obj, jboolean ownOnly,
                               strObj,
                               jval.l
         );
-        env->DeleteLocalRef(jval.l);
-        env->DeleteLocalRef(strObj);
     }
 
     return result;
 }
 
+jobjectArray JNIV8Object::jniGetV8FieldsWithArray(JNIEnv *env, jobject obj, jobjectArray keys, jint flags, jint type, jclass returnType) {
+    JNIV8Object_PrepareJNICall(JNIV8Object, Object, nullptr);
+
+    JNIV8JavaValue arg = JNIV8Marshalling::valueWithClass(type, returnType, (JNIV8MarshallingFlags)flags);
+
+    jsize numFields = env->GetArrayLength(keys);
+    jobjectArray result = env->NewObjectArray(numFields, _jniObject.clazz, nullptr);
+
+    Local<Value> valueRef;
+    jvalue jval;
+    memset(&jval, 0, sizeof(jvalue));
+
+    // local references of the entries are released in batches instead of individually
+    JNILocalFrame localFrame(env, JNI_LOCAL_FRAME_BATCH_SIZE * 2);
+    for(jsize i = 0; i < numFields; i++) {
+        if(i && i % JNI_LOCAL_FRAME_BATCH_SIZE == 0) {
+            localFrame.reset(JNI_LOCAL_FRAME_BATCH_SIZE * 2);
+        }
+        HandleScope itemScope(isolate);
+
+        auto key = (jstring)env->GetObjectArrayElement(keys, i);
+        Local<String> keyRef = engine->getPropertyNameCache().get(isolate, key);
+
+        if(!localRef->Get(context, keyRef).ToLocal(&valueRef)) {
+            engine->forwardV8ExceptionToJNI(&try_catch);
+            return nullptr;
+        }
+
+        JNIV8MarshallingError res = JNIV8Marshalling::convertV8ValueToJavaValue(env, valueRef, arg, &jval);
+        if(res != JNIV8MarshallingError::kOk) {
+            std::string strPropertyName = JNIV8Marshalling::v8string2string(keyRef);
+            switch(res) {
+                default:
+                case JNIV8MarshallingError::kWrongType:
+                    ThrowJNICastError("wrong type for value of '" + strPropertyName + "'");
+                    break;
+                case JNIV8MarshallingError::kUndefined:
+                    ThrowJNICastError("value of '" + strPropertyName + "' must not be undefined");
+                    break;
+                case JNIV8MarshallingError::kNotNullable:
+                    ThrowJNICastError("value of '" + strPropertyName + "' is not nullable");
+                    break;
+                case JNIV8MarshallingError::kNoNaN:
+                    ThrowJNICastError("value of '" + strPropertyName + "' must not be NaN");
+                    break;
+                case JNIV8MarshallingError::kVoidNotNull:
+                    ThrowJNICastError("value of '" + strPropertyName + "' can only be null or undefined");
+                    break;
+                case JNIV8MarshallingError::kOutOfRange:
+                    ThrowJNICastError("value '"+
+                                      JNIV8Marshalling::v8string2string(valueRef->ToString(context).ToLocalChecked())+"' is out of range for property '" + strPropertyName + "'");
+                    break;
+            }
+            return nullptr;
+        }
+
+        env->SetObjectArrayElement(result, i, jval.l);
+    }
+
+    return result;
+}
+
+void JNIV8Object::jniGetV8FieldsWithDoubles(JNIEnv *env, jobject obj, jobjectArray keys, jdoubleArray target) {
+    JNIV8Object_PrepareJNICall(JNIV8Object, Object, void());
+
+    jsize numFields = env->GetArrayLength(keys);
+    if(env->GetArrayLength(target) < numFields) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Target array is too small");
+        return;
+    }
+
+    std::vector<jdouble> numbers((size_t)numFields);
+    Local<Value> valueRef;
+
+    JNILocalFrame localFrame(env, JNI_LOCAL_FRAME_BATCH_SIZE);
+    for(jsize i = 0; i < numFields; i++) {
+        if(i && i % JNI_LOCAL_FRAME_BATCH_SIZE == 0) {
+            localFrame.reset(JNI_LOCAL_FRAME_BATCH_SIZE);
+        }
+        HandleScope itemScope(isolate);
+
+        auto key = (jstring)env->GetObjectArrayElement(keys, i);
+
+        // values are converted using the javascript coercion rules, same as toNumber
+        if(!localRef->Get(context, engine->getPropertyNameCache().get(isolate, key)).ToLocal(&valueRef) ||
+           !valueRef->NumberValue(context).To(&numbers[i])) {
+            engine->forwardV8ExceptionToJNI(&try_catch);
+            return;
+        }
+    }
+
+    // all values are copied with a single call
+    if(numFields) {
+        env->SetDoubleArrayRegion(target, 0, numFields, numbers.data());
+    }
+}
+
 jdouble JNIV8Object::jniToNumber(JNIEnv *env, jobject obj) {
     JNIV8Object_PrepareJNICall(JNIV8Object, Object, 0);
     v8::Maybe<double> numberValue = localRef->NumberValue(context);
@@ -595,6 +794,49 @@ jstring JNIV8Object::jniToJSON(JNIEnv *env, jobject obj) {
     return JNIV8Marshalling::v8string2jstring(stringValue.ToLocalChecked().As<v8::String>());
 }
 
+jbyteArray JNIV8Object::jniToJSONBytes(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8Object, Object, nullptr);
+    JNIV8JSONWriter writer(isolate, context);
+    if(!writer.write(localRef)) {
+        engine->forwardV8ExceptionToJNI(&try_catch);
+        return nullptr;
+    }
+    if(writer.isUndefined()) {
+        return nullptr;
+    }
+    const std::string &json = writer.getBuffer();
+    jbyteArray result = env->NewByteArray((jsize)json.size());
+    if(result) {
+        env->SetByteArrayRegion(result, 0, (jsize)json.size(), (const jbyte*)json.data());
+    }
+    return result;
+}
+
+jint JNIV8Object::jniToJSONBuffer(JNIEnv *env, jobject obj, jobject buffer) {
+    JNIV8Object_PrepareJNICall(JNIV8Object, Object, -1);
+    auto target = (char*)env->GetDirectBufferAddress(buffer);
+    if(!target) {
+        ptr = nullptr; // release shared_ptr before throwing an exception!
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Buffer is not a direct buffer");
+        return -1;
+    }
+    JNIV8JSONWriter writer(isolate, context);
+    if(!writer.write(localRef)) {
+        engine->forwardV8ExceptionToJNI(&try_catch);
+        return -1;
+    }
+    if(writer.isUndefined()) {
+        return 0;
+    }
+    // serialized JSON is never empty, so a negative size unambiguously signals that nothing was written
+    const std::string &json = writer.getBuffer();
+    if((jlong)json.size() > env->GetDirectBufferCapacity(buffer)) {
+        return -(jint)json.size();
+    }
+    memcpy(target, json.data(), json.size());
+    return (jint)json.size();
+}
+
 jstring JNIV8Object::jniToString(JNIEnv *env, jobject obj) {
     JNIV8Object_PrepareJNICall(JNIV8Object, Object, nullptr);
     MaybeLocal<String> maybeLocal = localRef->ToString(context);
@@ -621,7 +863,7 @@ jboolean JNIV8Object::jniIsInstanceOfByConstructor(JNIEnv *env, jobject obj, job
 jboolean JNIV8Object::jniIsInstanceOfByName(JNIEnv *env, jobject obj, jstring name) {
     JNIV8Object_PrepareJNICall(JNIV8Object, Object, false);
 
-    auto constructorName = JNIV8Marshalling::jstring2v8string(name);
+    auto constructorName = engine->getPropertyNameCache().get(isolate, name);
 
     v8::Local<v8::Value> constructorRef;
     auto maybeConstructorRef = context->Global()->Get(context, constructorName);
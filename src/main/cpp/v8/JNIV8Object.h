@@ -61,6 +61,8 @@ public:
      */
     BGJSV8Engine* getEngine() const;
 
+    bool dispose() override;
+
     /**
      * cache JNI class references
      */
@@ -90,14 +92,20 @@ private:
     static jobject jniGetV8FieldWithReturnType(JNIEnv *env, jobject obj, jstring name, jint flags, jint type, jclass returnType);
     static void jniSetV8Field(JNIEnv *env, jobject obj, jstring name, jobject value);
     static void jniSetV8Fields(JNIEnv *env, jobject obj, jobject map);
+    static void jniSetV8FieldsWithArrays(JNIEnv *env, jobject obj, jobjectArray keys, jobjectArray values);
+    static void jniSetV8FieldsWithDoubles(JNIEnv *env, jobject obj, jobjectArray keys, jdoubleArray values);
     static void jniSetV8Accessor(JNIEnv *env, jobject obj, jstring name, jobject getter, jobject setter);
     static jobject jniCallV8MethodWithReturnType(JNIEnv *env, jobject obj, jstring name, jint flags, jint type, jclass returnType, jobjectArray arguments);
     static jboolean jniHasV8Field(JNIEnv *env, jobject obj, jstring name, jboolean ownOnly);
     static jobjectArray jniGetV8Keys(JNIEnv *env, jobject obj, jboolean ownOnly);
     static jobject jniGetV8Fields(JNIEnv *env, jobject obj, jboolean ownOnly, jint flags, jint type, jclass returnType);
+    static jobjectArray jniGetV8FieldsWithArray(JNIEnv *env, jobject obj, jobjectArray keys, jint flags, jint type, jclass returnType);
+    static void jniGetV8FieldsWithDoubles(JNIEnv *env, jobject obj, jobjectArray keys, jdoubleArray target);
     static jdouble jniToNumber(JNIEnv *env, jobject obj);
     static jstring jniToString(JNIEnv *env, jobject obj);
     static jstring jniToJSON(JNIEnv *env, jobject obj);
+    static jbyteArray jniToJSONBytes(JNIEnv *env, jobject obj);
+    static jint jniToJSONBuffer(JNIEnv *env, jobject obj, jobject buffer);
     static jboolean jniIsInstanceOfByConstructor(JNIEnv *env, jobject obj, jobject constructor);
     static jboolean jniIsInstanceOfByName(JNIEnv *env, jobject obj, jstring name);
     static void jniRegisterV8Class(JNIEnv *env, jobject obj, jstring derivedClass, jstring baseClass);
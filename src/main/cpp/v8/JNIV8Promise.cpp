@@ -86,6 +86,8 @@ void JNIV8PromiseResolver::initializeJNIBindings(JNIClassInfo *info, bool isRelo
     info->registerNativeMethod("getPromise", "()Lag/boersego/bgjs/JNIV8Promise;", (void*)JNIV8PromiseResolver::jniGetPromise);
     info->registerNativeMethod("resolve", "(Ljava/lang/Object;)Z", (void*)JNIV8PromiseResolver::jniResolve);
     info->registerNativeMethod("reject", "(Ljava/lang/Object;)Z", (void*)JNIV8PromiseResolver::jniReject);
+    info->registerNativeMethod("resolveAsync", "(Ljava/lang/Object;)V", (void*)JNIV8PromiseResolver::jniResolveAsync);
+    info->registerNativeMethod("rejectAsync", "(Ljava/lang/Object;)V", (void*)JNIV8PromiseResolver::jniRejectAsync);
 }
 
 jobject JNIV8PromiseResolver::jniGetPromise(JNIEnv *env, jobject obj) {
@@ -116,4 +118,27 @@ jboolean JNIV8PromiseResolver::jniReject(JNIEnv *env, jobject obj, jobject value
     }
 
     return (jboolean)result.FromJust();
-}
\ No newline at end of file
+}
+
+void JNIV8PromiseResolver::jniResolveAsync(JNIEnv *env, jobject obj, jobject value) {
+    auto ptr = JNIWrapper::wrapObject<JNIV8PromiseResolver>(obj);
+    if(!ptr) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Attempt to call method on disposed object");
+        return;
+    }
+    // only primitive values are read here; creating v8 values requires the locker
+    if(!ptr->getEngine()->enqueueLoopWork(BGJSV8Engine::ELoopWorkType::kResolve, obj, value)) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalStateException"), "Engine has been stopped");
+    }
+}
+
+void JNIV8PromiseResolver::jniRejectAsync(JNIEnv *env, jobject obj, jobject value) {
+    auto ptr = JNIWrapper::wrapObject<JNIV8PromiseResolver>(obj);
+    if(!ptr) {
+        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), "Attempt to call method on disposed object");
+        return;
+    }
+    if(!ptr->getEngine()->enqueueLoopWork(BGJSV8Engine::ELoopWorkType::kReject, obj, value)) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalStateException"), "Engine has been stopped");
+    }
+}
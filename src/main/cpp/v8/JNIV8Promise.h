@@ -38,6 +38,13 @@ public:
     static jboolean jniResolve(JNIEnv *env, jobject obj, jobject value);
     static jboolean jniReject(JNIEnv *env, jobject obj, jobject value);
 
+    /**
+     * queue the settlement on the event loop of the engine; returns without waiting for the isolate locker
+     * throws an IllegalStateException if the event loop of the engine has already ended
+     */
+    static void jniResolveAsync(JNIEnv *env, jobject obj, jobject value);
+    static void jniRejectAsync(JNIEnv *env, jobject obj, jobject value);
+
     /**
      * cache JNI class references
      */
@@ -0,0 +1,123 @@
+#include "JNIV8PropertyNameCache.h"
+#include "JNIV8Marshalling.h"
+#include "../jni/JNIWrapper.h"
+#include "../jni/JNIUTF.h"
+
+using namespace v8;
+
+/**
+ * FNV-1a over the utf-16 code units
+ */
+static inline size_t hashName(const char16_t *name, size_t length) {
+    size_t hash = 2166136261u;
+    for(size_t i = 0; i < length; i++) {
+        hash = (hash ^ (size_t)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+JNIV8PropertyNameCache::JNIV8PropertyNameCache(size_t capacity) :
+        _capacity(capacity), _size(0), _entries(new Entry[capacity]), _head(nullptr), _tail(nullptr) {
+    _index.reserve(capacity);
+}
+
+JNIV8PropertyNameCache::~JNIV8PropertyNameCache() {
+    clear();
+}
+
+void JNIV8PropertyNameCache::clear() {
+    for(size_t i = 0; i < _size; i++) {
+        _entries[i].string.Reset();
+        _entries[i].name.clear();
+    }
+    _index.clear();
+    _size = 0;
+    _head = _tail = nullptr;
+}
+
+Local<String> JNIV8PropertyNameCache::get(Isolate *isolate, jstring name) {
+    JNIEnv *env = JNIWrapper::getEnvironment();
+
+    jsize length = name ? env->GetStringLength(name) : 0;
+    if(!length || (size_t)length > kMaxNameLength) {
+        return JNIV8Marshalling::jstring2v8string(name);
+    }
+
+    char16_t chars[kMaxNameLength];
+    env->GetStringRegion(name, 0, length, (jchar*)chars);
+
+    return lookup(isolate, chars, (size_t)length);
+}
+
+Local<String> JNIV8PropertyNameCache::get(Isolate *isolate, const std::string &name) {
+    if(name.empty() || name.length() > kMaxNameLength) {
+        return String::NewFromUtf8(isolate, name.c_str(), NewStringType::kNormal, (int)name.length()).ToLocalChecked();
+    }
+
+    // utf-8 never needs more utf-16 code units than it has bytes
+    char16_t chars[kMaxNameLength];
+    size_t length = JNIUTF::utf8ToUtf16(name.c_str(), name.length(), (uint16_t*)chars);
+
+    return lookup(isolate, chars, length);
+}
+
+Local<String> JNIV8PropertyNameCache::lookup(Isolate *isolate, const char16_t *name, size_t length) {
+    EscapableHandleScope scope(isolate);
+
+    size_t hash = hashName(name, length);
+    auto range = _index.equal_range(hash);
+    for(auto it = range.first; it != range.second; ++it) {
+        Entry *entry = it->second;
+        if(entry->name.length() == length && entry->name.compare(0, length, name, length) == 0) {
+            if(entry != _head) {
+                unlink(entry);
+                pushFront(entry);
+            }
+            return scope.Escape(Local<String>::New(isolate, entry->string));
+        }
+    }
+
+    // internalized strings are compared by pointer when looking up properties
+    Local<String> stringRef;
+    if(!String::NewFromTwoByte(isolate, (const uint16_t*)name, NewStringType::kInternalized, (int)length).ToLocal(&stringRef)) {
+        return scope.Escape(String::Empty(isolate));
+    }
+
+    Entry *entry;
+    if(_size < _capacity) {
+        entry = &_entries[_size++];
+    } else {
+        // evict least recently used name
+        entry = _tail;
+        unlink(entry);
+        auto evicted = _index.equal_range(entry->hash);
+        for(auto it = evicted.first; it != evicted.second; ++it) {
+            if(it->second == entry) {
+                _index.erase(it);
+                break;
+            }
+        }
+    }
+
+    entry->name.assign(name, length);
+    entry->hash = hash;
+    entry->string.Reset(isolate, stringRef);
+    _index.insert(std::make_pair(hash, entry));
+    pushFront(entry);
+
+    return scope.Escape(stringRef);
+}
+
+void JNIV8PropertyNameCache::unlink(Entry *entry) {
+    if(entry->prev) entry->prev->next = entry->next; else _head = entry->next;
+    if(entry->next) entry->next->prev = entry->prev; else _tail = entry->prev;
+    entry->prev = entry->next = nullptr;
+}
+
+void JNIV8PropertyNameCache::pushFront(Entry *entry) {
+    entry->prev = nullptr;
+    entry->next = _head;
+    if(_head) _head->prev = entry;
+    _head = entry;
+    if(!_tail) _tail = entry;
+}
@@ -0,0 +1,55 @@
+#ifndef ANDROID_TRADINGLIB_SAMPLE_JNIV8PROPERTYNAMECACHE_H
+#define ANDROID_TRADINGLIB_SAMPLE_JNIV8PROPERTYNAMECACHE_H
+
+#include <v8.h>
+#include <jni.h>
+#include <string>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * maps property names to internalized v8 strings, so that frequently used names are not converted again on every access
+ * lookups do not allocate; the least recently used name is evicted once the cache is full
+ *
+ * there is one cache per engine; it must only be used while holding the isolate locker
+ */
+class JNIV8PropertyNameCache {
+public:
+    explicit JNIV8PropertyNameCache(size_t capacity = 256);
+    ~JNIV8PropertyNameCache();
+
+    /**
+     * returns the v8 string for the specified java string
+     * empty, null and very long names are converted without being cached
+     */
+    v8::Local<v8::String> get(v8::Isolate *isolate, jstring name);
+    v8::Local<v8::String> get(v8::Isolate *isolate, const std::string &name);
+
+    /**
+     * releases all cached strings; has to be called before the isolate is disposed
+     */
+    void clear();
+
+private:
+    // names longer than this are unlikely to be accessed repeatedly
+    static const size_t kMaxNameLength = 64;
+
+    struct Entry {
+        std::u16string name;
+        size_t hash;
+        v8::Persistent<v8::String> string;
+        Entry *prev, *next;
+    };
+
+    v8::Local<v8::String> lookup(v8::Isolate *isolate, const char16_t *name, size_t length);
+    void unlink(Entry *entry);
+    void pushFront(Entry *entry);
+
+    size_t _capacity, _size;
+    std::unique_ptr<Entry[]> _entries;
+    std::unordered_multimap<size_t, Entry*> _index;
+    // most recently used entry is at the head
+    Entry *_head, *_tail;
+};
+
+#endif //ANDROID_TRADINGLIB_SAMPLE_JNIV8PROPERTYNAMECACHE_H
@@ -0,0 +1,332 @@
+#include "JNIV8TypedArray.h"
+#include "JNIV8ArrayBuffer.h"
+#include "../bgjs/BGJSV8Engine.h"
+
+#include <string.h>
+
+BGJS_JNI_LINK(JNIV8TypedArray, "ag/boersego/bgjs/JNIV8TypedArray");
+
+decltype(JNIV8TypedArray::_jniArray) JNIV8TypedArray::_jniArray = {0};
+
+/**
+ * cache JNI class references
+ */
+void JNIV8TypedArray::initJNICache() {
+    JNIEnv *env = JNIWrapper::getEnvironment();
+
+    _jniArray.byteArrayClazz = (jclass)env->NewGlobalRef(env->FindClass("[B"));
+    _jniArray.shortArrayClazz = (jclass)env->NewGlobalRef(env->FindClass("[S"));
+    _jniArray.intArrayClazz = (jclass)env->NewGlobalRef(env->FindClass("[I"));
+    _jniArray.longArrayClazz = (jclass)env->NewGlobalRef(env->FindClass("[J"));
+    _jniArray.floatArrayClazz = (jclass)env->NewGlobalRef(env->FindClass("[F"));
+    _jniArray.doubleArrayClazz = (jclass)env->NewGlobalRef(env->FindClass("[D"));
+}
+
+bool JNIV8TypedArray::isWrappableV8Object(v8::Local<v8::Object> object) {
+    return object->IsTypedArray() || (object->IsProxy() && object.As<v8::Proxy>()->GetTarget()->IsTypedArray());
+}
+
+void JNIV8TypedArray::initializeJNIBindings(JNIClassInfo *info, bool isReload) {
+    info->registerNativeMethod("_create", "(Lag/boersego/bgjs/V8Engine;II)Lag/boersego/bgjs/JNIV8TypedArray;", (void*)JNIV8TypedArray::jniCreate);
+    info->registerNativeMethod("_createWithBuffer", "(Lag/boersego/bgjs/V8Engine;ILag/boersego/bgjs/JNIV8ArrayBuffer;II)Lag/boersego/bgjs/JNIV8TypedArray;", (void*)JNIV8TypedArray::jniCreateWithBuffer);
+    info->registerNativeMethod("_createWithArray", "(Lag/boersego/bgjs/V8Engine;ILjava/lang/Object;)Lag/boersego/bgjs/JNIV8TypedArray;", (void*)JNIV8TypedArray::jniCreateWithArray);
+    info->registerNativeMethod("_getType", "()I", (void*)JNIV8TypedArray::jniGetType);
+    info->registerNativeMethod("getV8Length", "()I", (void*)JNIV8TypedArray::jniGetV8Length);
+    info->registerNativeMethod("getV8ByteOffset", "()I", (void*)JNIV8TypedArray::jniGetV8ByteOffset);
+    info->registerNativeMethod("getV8ByteLength", "()I", (void*)JNIV8TypedArray::jniGetV8ByteLength);
+    info->registerNativeMethod("getV8Buffer", "()Lag/boersego/bgjs/JNIV8ArrayBuffer;", (void*)JNIV8TypedArray::jniGetV8Buffer);
+    info->registerNativeMethod("_getV8ByteBuffer", "()Ljava/nio/ByteBuffer;", (void*)JNIV8TypedArray::jniGetV8ByteBuffer);
+    info->registerNativeMethod("_toArray", "()Ljava/lang/Object;", (void*)JNIV8TypedArray::jniToArray);
+}
+
+v8::Local<v8::TypedArray> JNIV8TypedArray::getTypedArray(v8::Local<v8::Object> object) {
+    if (object->IsProxy()) {
+        return object.As<v8::Proxy>()->GetTarget().As<v8::TypedArray>();
+    }
+    return object.As<v8::TypedArray>();
+}
+
+JNIV8TypedArrayType JNIV8TypedArray::getType(v8::Local<v8::TypedArray> array) {
+    if (array->IsInt8Array()) return JNIV8TypedArrayType::kInt8;
+    if (array->IsUint8Array()) return JNIV8TypedArrayType::kUint8;
+    if (array->IsUint8ClampedArray()) return JNIV8TypedArrayType::kUint8Clamped;
+    if (array->IsInt16Array()) return JNIV8TypedArrayType::kInt16;
+    if (array->IsUint16Array()) return JNIV8TypedArrayType::kUint16;
+    if (array->IsInt32Array()) return JNIV8TypedArrayType::kInt32;
+    if (array->IsUint32Array()) return JNIV8TypedArrayType::kUint32;
+    if (array->IsFloat32Array()) return JNIV8TypedArrayType::kFloat32;
+    if (array->IsFloat64Array()) return JNIV8TypedArrayType::kFloat64;
+    if (array->IsBigInt64Array()) return JNIV8TypedArrayType::kBigInt64;
+    return JNIV8TypedArrayType::kBigUint64;
+}
+
+size_t JNIV8TypedArray::getElementSize(JNIV8TypedArrayType type) {
+    switch (type) {
+        case JNIV8TypedArrayType::kInt8:
+        case JNIV8TypedArrayType::kUint8:
+        case JNIV8TypedArrayType::kUint8Clamped:
+            return 1;
+        case JNIV8TypedArrayType::kInt16:
+        case JNIV8TypedArrayType::kUint16:
+            return 2;
+        case JNIV8TypedArrayType::kInt32:
+        case JNIV8TypedArrayType::kUint32:
+        case JNIV8TypedArrayType::kFloat32:
+            return 4;
+        case JNIV8TypedArrayType::kFloat64:
+        case JNIV8TypedArrayType::kBigInt64:
+        case JNIV8TypedArrayType::kBigUint64:
+            return 8;
+    }
+    return 1;
+}
+
+/**
+ * returns the class of the java primitive array that has the same memory layout as the elements
+ * unsigned types use the signed java type of the same size
+ */
+jclass JNIV8TypedArray::getArrayClass(JNIV8TypedArrayType type) {
+    switch (type) {
+        case JNIV8TypedArrayType::kInt8:
+        case JNIV8TypedArrayType::kUint8:
+        case JNIV8TypedArrayType::kUint8Clamped:
+            return _jniArray.byteArrayClazz;
+        case JNIV8TypedArrayType::kInt16:
+        case JNIV8TypedArrayType::kUint16:
+            return _jniArray.shortArrayClazz;
+        case JNIV8TypedArrayType::kInt32:
+        case JNIV8TypedArrayType::kUint32:
+            return _jniArray.intArrayClazz;
+        case JNIV8TypedArrayType::kFloat32:
+            return _jniArray.floatArrayClazz;
+        case JNIV8TypedArrayType::kFloat64:
+            return _jniArray.doubleArrayClazz;
+        case JNIV8TypedArrayType::kBigInt64:
+        case JNIV8TypedArrayType::kBigUint64:
+            return _jniArray.longArrayClazz;
+    }
+    return nullptr;
+}
+
+v8::Local<v8::TypedArray> JNIV8TypedArray::newTypedArray(JNIV8TypedArrayType type, v8::Local<v8::ArrayBuffer> buffer, size_t byteOffset, size_t length) {
+    switch (type) {
+        case JNIV8TypedArrayType::kInt8: return v8::Int8Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kUint8: return v8::Uint8Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kUint8Clamped: return v8::Uint8ClampedArray::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kInt16: return v8::Int16Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kUint16: return v8::Uint16Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kInt32: return v8::Int32Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kUint32: return v8::Uint32Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kFloat32: return v8::Float32Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kFloat64: return v8::Float64Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kBigInt64: return v8::BigInt64Array::New(buffer, byteOffset, length);
+        case JNIV8TypedArrayType::kBigUint64: return v8::BigUint64Array::New(buffer, byteOffset, length);
+    }
+    return v8::Local<v8::TypedArray>();
+}
+
+bool JNIV8TypedArray::getTypeForArrayClass(JNIEnv *env, jclass clazz, JNIV8TypedArrayType *type) {
+    if (env->IsSameObject(clazz, _jniArray.byteArrayClazz)) {
+        *type = JNIV8TypedArrayType::kInt8;
+    } else if (env->IsSameObject(clazz, _jniArray.shortArrayClazz)) {
+        *type = JNIV8TypedArrayType::kInt16;
+    } else if (env->IsSameObject(clazz, _jniArray.intArrayClazz)) {
+        *type = JNIV8TypedArrayType::kInt32;
+    } else if (env->IsSameObject(clazz, _jniArray.longArrayClazz)) {
+        *type = JNIV8TypedArrayType::kBigInt64;
+    } else if (env->IsSameObject(clazz, _jniArray.floatArrayClazz)) {
+        *type = JNIV8TypedArrayType::kFloat32;
+    } else if (env->IsSameObject(clazz, _jniArray.doubleArrayClazz)) {
+        *type = JNIV8TypedArrayType::kFloat64;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * throws a java exception and returns false if a typed array with the specified number of elements can not be created
+ * v8 aborts the process if an ArrayBuffer can not be allocated, so this has to be checked up front
+ * this v8 version has no ArrayBuffer::kMaxByteLength, so TypedArray::kMaxLength is used as the limit for the byte length as well
+ */
+bool JNIV8TypedArray::checkLength(JNIEnv *env, JNIV8TypedArrayType type, size_t length) {
+    if (length > v8::TypedArray::kMaxLength) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "length exceeds the maximum length of typed arrays");
+        return false;
+    }
+    if (length * getElementSize(type) > v8::TypedArray::kMaxLength) {
+        env->ThrowNew(env->FindClass("java/lang/OutOfMemoryError"), "byte length exceeds the maximum size of ArrayBuffers");
+        return false;
+    }
+    return true;
+}
+
+jint JNIV8TypedArray::toJavaSize(JNIEnv *env, size_t value) {
+    if (value > (size_t)INT32_MAX) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalStateException"), "size exceeds Integer.MAX_VALUE");
+        return 0;
+    }
+    return (jint)value;
+}
+
+v8::Local<v8::TypedArray> JNIV8TypedArray::newTypedArrayWithArray(JNIEnv *env, v8::Isolate *isolate, JNIV8TypedArrayType type, jarray elements) {
+    if (!elements || !env->IsInstanceOf(elements, getArrayClass(type))) {
+        return v8::Local<v8::TypedArray>();
+    }
+
+    size_t length = (size_t)env->GetArrayLength(elements);
+    if (!checkLength(env, type, length)) {
+        return v8::Local<v8::TypedArray>();
+    }
+    size_t byteLength = length * getElementSize(type);
+    v8::Local<v8::ArrayBuffer> bufferRef = v8::ArrayBuffer::New(isolate, byteLength);
+
+    // copy directly into the backing store; no v8 or java calls are made while the array is pinned
+    if (byteLength) {
+        void *data = env->GetPrimitiveArrayCritical(elements, nullptr);
+        memcpy(bufferRef->GetContents().Data(), data, byteLength);
+        env->ReleasePrimitiveArrayCritical(elements, data, JNI_ABORT);
+    }
+
+    return newTypedArray(type, bufferRef, 0, length);
+}
+
+jobject JNIV8TypedArray::jniCreate(JNIEnv *env, jobject obj, jobject engineObj, jint type, jint length) {
+    if (length < 0) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "length must not be negative");
+        return nullptr;
+    }
+    JNIV8TypedArrayType arrayType = (JNIV8TypedArrayType)type;
+    if (!checkLength(env, arrayType, (size_t)length)) {
+        return nullptr;
+    }
+
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Context::Scope ctxScope(engine->getContext());
+
+    v8::Local<v8::ArrayBuffer> bufferRef = v8::ArrayBuffer::New(isolate, (size_t)length * getElementSize(arrayType));
+
+    return JNIV8Wrapper::wrapObject<JNIV8TypedArray>(newTypedArray(arrayType, bufferRef, 0, (size_t)length))->getJObject();
+}
+
+jobject JNIV8TypedArray::jniCreateWithBuffer(JNIEnv *env, jobject obj, jobject engineObj, jint type, jobject bufferObj, jint byteOffset, jint length) {
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Context::Scope ctxScope(engine->getContext());
+
+    auto buffer = JNIWrapper::wrapObject<JNIV8ArrayBuffer>(bufferObj);
+    if (!buffer) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "ArrayBuffer must not be null or disposed");
+        return nullptr;
+    }
+
+    JNIV8TypedArrayType arrayType = (JNIV8TypedArrayType)type;
+    v8::Local<v8::ArrayBuffer> bufferRef = JNIV8ArrayBuffer::getArrayBuffer(buffer->getJSObject());
+
+    size_t elementSize = getElementSize(arrayType);
+    if (byteOffset < 0 || length < 0 || byteOffset % elementSize ||
+        (size_t)byteOffset + (size_t)length * elementSize > bufferRef->ByteLength()) {
+        env->ThrowNew(env->FindClass("java/lang/IndexOutOfBoundsException"), "Invalid byte offset or length for ArrayBuffer");
+        return nullptr;
+    }
+
+    return JNIV8Wrapper::wrapObject<JNIV8TypedArray>(newTypedArray(arrayType, bufferRef, (size_t)byteOffset, (size_t)length))->getJObject();
+}
+
+jobject JNIV8TypedArray::jniCreateWithArray(JNIEnv *env, jobject obj, jobject engineObj, jint type, jarray elements) {
+    auto engine = JNIWrapper::wrapObject<BGJSV8Engine>(engineObj);
+
+    v8::Isolate* isolate = engine->getIsolate();
+    v8::Locker l(isolate);
+    v8::MicrotasksScope taskScope(isolate, v8::MicrotasksScope::kRunMicrotasks);
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Context::Scope ctxScope(engine->getContext());
+
+    v8::Local<v8::TypedArray> arrayRef = newTypedArrayWithArray(env, isolate, (JNIV8TypedArrayType)type, elements);
+    if (arrayRef.IsEmpty()) {
+        // the array was too large
+        if (env->ExceptionCheck()) {
+            return nullptr;
+        }
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Array type does not match the element type");
+        return nullptr;
+    }
+
+    return JNIV8Wrapper::wrapObject<JNIV8TypedArray>(arrayRef)->getJObject();
+}
+
+jint JNIV8TypedArray::jniGetType(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8TypedArray, v8::Object, 0);
+    return (jint)getType(getTypedArray(localRef));
+}
+
+jint JNIV8TypedArray::jniGetV8Length(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8TypedArray, v8::Object, 0);
+    return toJavaSize(env, getTypedArray(localRef)->Length());
+}
+
+jint JNIV8TypedArray::jniGetV8ByteOffset(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8TypedArray, v8::Object, 0);
+    return toJavaSize(env, getTypedArray(localRef)->ByteOffset());
+}
+
+jint JNIV8TypedArray::jniGetV8ByteLength(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8TypedArray, v8::Object, 0);
+    return toJavaSize(env, getTypedArray(localRef)->ByteLength());
+}
+
+jobject JNIV8TypedArray::jniGetV8Buffer(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8TypedArray, v8::Object, nullptr);
+    return JNIV8Wrapper::wrapObject<JNIV8ArrayBuffer>(getTypedArray(localRef)->Buffer())->getJObject();
+}
+
+jobject JNIV8TypedArray::jniGetV8ByteBuffer(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8TypedArray, v8::Object, nullptr);
+
+    // small arrays are allocated on the v8 heap; Buffer() moves them to a backing store that does not move anymore
+    v8::Local<v8::TypedArray> arrayRef = getTypedArray(localRef);
+    return JNIV8ArrayBuffer::newDirectByteBuffer(env, arrayRef->Buffer(), arrayRef->ByteOffset(), arrayRef->ByteLength());
+}
+
+jarray JNIV8TypedArray::jniToArray(JNIEnv *env, jobject obj) {
+    JNIV8Object_PrepareJNICall(JNIV8TypedArray, v8::Object, nullptr);
+
+    v8::Local<v8::TypedArray> arrayRef = getTypedArray(localRef);
+    JNIV8TypedArrayType type = getType(arrayRef);
+    jsize length = toJavaSize(env, arrayRef->Length());
+    if (env->ExceptionCheck()) {
+        return nullptr;
+    }
+
+    jarray result;
+    switch (getElementSize(type)) {
+        case 1: result = env->NewByteArray(length); break;
+        case 2: result = env->NewShortArray(length); break;
+        case 4: result = type == JNIV8TypedArrayType::kFloat32 ? (jarray)env->NewFloatArray(length) : (jarray)env->NewIntArray(length); break;
+        default: result = type == JNIV8TypedArrayType::kFloat64 ? (jarray)env->NewDoubleArray(length) : (jarray)env->NewLongArray(length); break;
+    }
+    if (!result) {
+        return nullptr;
+    }
+
+    // CopyContents does not require the buffer to be materialized for arrays living on the v8 heap
+    if (length) {
+        void *data = env->GetPrimitiveArrayCritical(result, nullptr);
+        arrayRef->CopyContents(data, arrayRef->ByteLength());
+        env->ReleasePrimitiveArrayCritical(result, data, 0);
+    }
+
+    return result;
+}
@@ -0,0 +1,88 @@
+#ifndef ANDROID_TRADINGLIB_SAMPLE_JNIV8TYPEDARRAY_H
+#define ANDROID_TRADINGLIB_SAMPLE_JNIV8TYPEDARRAY_H
+
+#include "JNIV8Wrapper.h"
+
+/**
+ * element types of typed arrays
+ * the order has to match the enum JNIV8TypedArray.Type on java
+ */
+enum class JNIV8TypedArrayType {
+    kInt8,
+    kUint8,
+    kUint8Clamped,
+    kInt16,
+    kUint16,
+    kInt32,
+    kUint32,
+    kFloat32,
+    kFloat64,
+    kBigInt64,
+    kBigUint64
+};
+
+class JNIV8TypedArray : public JNIScope<JNIV8TypedArray, JNIV8Object> {
+public:
+    JNIV8TypedArray(jobject obj, JNIClassInfo *info) : JNIScope(obj, info) {};
+
+    static bool isWrappableV8Object(v8::Local<v8::Object> object);
+    static void initializeJNIBindings(JNIClassInfo *info, bool isReload);
+
+    static jobject jniCreate(JNIEnv *env, jobject obj, jobject engineObj, jint type, jint length);
+    /**
+     * creates a typed array that is a view on an existing ArrayBuffer without copying it
+     */
+    static jobject jniCreateWithBuffer(JNIEnv *env, jobject obj, jobject engineObj, jint type, jobject bufferObj, jint byteOffset, jint length);
+    /**
+     * creates a typed array with a copy of a java primitive array of the matching element size
+     */
+    static jobject jniCreateWithArray(JNIEnv *env, jobject obj, jobject engineObj, jint type, jarray elements);
+
+    static jint jniGetType(JNIEnv *env, jobject obj);
+    static jint jniGetV8Length(JNIEnv *env, jobject obj);
+    static jint jniGetV8ByteOffset(JNIEnv *env, jobject obj);
+    static jint jniGetV8ByteLength(JNIEnv *env, jobject obj);
+    static jobject jniGetV8Buffer(JNIEnv *env, jobject obj);
+    static jobject jniGetV8ByteBuffer(JNIEnv *env, jobject obj);
+
+    /**
+     * returns a copy of the elements as a java primitive array of the matching element size
+     */
+    static jarray jniToArray(JNIEnv *env, jobject obj);
+
+    /**
+     * creates a typed array with a copy of a java primitive array; returns an empty handle if the array type does not match the element type
+     */
+    static v8::Local<v8::TypedArray> newTypedArrayWithArray(JNIEnv *env, v8::Isolate *isolate, JNIV8TypedArrayType type, jarray elements);
+
+    /**
+     * determines the element type used for converting java primitive arrays of the specified class; returns false for all other classes
+     */
+    static bool getTypeForArrayClass(JNIEnv *env, jclass clazz, JNIV8TypedArrayType *type);
+
+    /**
+     * converts a length or offset reported by v8 to a java int
+     * throws IllegalStateException and returns 0 if it does not fit, e.g. for typed arrays created in js with more than 2GB
+     */
+    static jint toJavaSize(JNIEnv *env, size_t value);
+
+    /**
+     * cache JNI class references
+     */
+    static void initJNICache();
+private:
+    static struct {
+        jclass byteArrayClazz, shortArrayClazz, intArrayClazz, longArrayClazz, floatArrayClazz, doubleArrayClazz;
+    } _jniArray;
+
+    static v8::Local<v8::TypedArray> getTypedArray(v8::Local<v8::Object> object);
+    static JNIV8TypedArrayType getType(v8::Local<v8::TypedArray> array);
+    static v8::Local<v8::TypedArray> newTypedArray(JNIV8TypedArrayType type, v8::Local<v8::ArrayBuffer> buffer, size_t byteOffset, size_t length);
+    static size_t getElementSize(JNIV8TypedArrayType type);
+    static jclass getArrayClass(JNIV8TypedArrayType type);
+    static bool checkLength(JNIEnv *env, JNIV8TypedArrayType type, size_t length);
+};
+
+BGJS_JNI_LINK_DEF(JNIV8TypedArray)
+
+#endif //ANDROID_TRADINGLIB_SAMPLE_JNIV8TYPEDARRAY_H
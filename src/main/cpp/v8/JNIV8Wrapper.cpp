@@ -12,12 +12,15 @@ using namespace v8;
 #include "JNIV8Promise.h"
 #include "JNIV8Symbol.h"
 #include "JNIV8ArrayBuffer.h"
+#include "JNIV8TypedArray.h"
+#include "JNIV8DataView.h"
 #include "v8.h"
 
 #include <string>
 #include <algorithm>
 
-std::map<std::string, JNIV8ClassInfoContainer*> JNIV8Wrapper::_objmap;
+std::atomic<JNIV8ClassInfoContainer*> JNIV8Wrapper::_containerIndex[JNIV8Wrapper::kContainerIndexSize];
+size_t JNIV8Wrapper::_containerCount = 0;
 
 //const char* JNIV8Wrapper::_v8PrivateKey = "JNIV8WrapperPrivate";
 
@@ -45,6 +48,8 @@ void JNIV8Wrapper::init() {
     JNIV8Wrapper::registerObject<JNIV8Symbol>(JNIV8ObjectType::kWrapper);
     JNIV8Wrapper::registerObject<JNIV8PromiseResolver>(JNIV8ObjectType::kWrapper);
     JNIV8Wrapper::registerObject<JNIV8ArrayBuffer>(JNIV8ObjectType::kWrapper);
+    JNIV8Wrapper::registerObject<JNIV8TypedArray>(JNIV8ObjectType::kWrapper);
+    JNIV8Wrapper::registerObject<JNIV8DataView>(JNIV8ObjectType::kWrapper);
 
     JNIEnv *env = JNIWrapper::getEnvironment();
 
@@ -72,10 +77,12 @@ void JNIV8Wrapper::init() {
     _jniV8AccessorInfo.undefinedIsNullId = env->GetFieldID(_jniV8AccessorInfo.clazz, "undefinedIsNull", "Z");
 
     JNIV8Object::initJNICache();
-    JNIV8Function::initJNICache();
     JNIV8Array::initJNICache();
+    JNIV8TypedArray::initJNICache();
     JNIV8ClassInfo::initJNICache();
     JNIV8Marshalling::initJNICache();
+    // uses the marshalling cache for resolving handler argument types
+    JNIV8Function::initJNICache();
     BGJSV8Engine::initJNICache();
 }
 
@@ -117,6 +124,7 @@ void JNIV8Wrapper::v8ConstructorCallback(const v8::FunctionCallbackInfo<v8::Valu
 
     // create temporary persistent for the js object and then call the constructor
     v8::Persistent<Object>* jsObj = new v8::Persistent<v8::Object>(isolate, args.This());
+    BGJS_NEW_PERSISTENT_PTR(jsObj);
     auto ptr = info->container->creator(info, jsObj, arguments);
 
     env->DeleteLocalRef(arguments);
@@ -132,23 +140,40 @@ void JNIV8Wrapper::v8ConstructorCallback(const v8::FunctionCallbackInfo<v8::Valu
     }
 }
 
+JNIV8ClassInfoContainer* JNIV8Wrapper::_findContainer(const std::string& canonicalName) {
+    size_t hashCode = std::hash<std::string>()(canonicalName);
+    for (size_t i = hashCode & (kContainerIndexSize - 1);; i = (i + 1) & (kContainerIndexSize - 1)) {
+        JNIV8ClassInfoContainer *container = _containerIndex[i].load(std::memory_order_acquire);
+        if (!container) {
+            return nullptr;
+        }
+        if (container->hashCode == hashCode && container->canonicalName == canonicalName) {
+            return container;
+        }
+    }
+}
+
 JNIV8ClassInfo* JNIV8Wrapper::_getV8ClassInfo(const std::string& canonicalName, BGJSV8Engine *engine) {
-    pthread_mutex_lock(&_mutexEnv);
+    JNIV8ClassInfoContainer *container = _findContainer(canonicalName);
+    JNI_ASSERTF(container, "Attempt to retrieve class info for unregistered class: %s", canonicalName.c_str());
+    return _getV8ClassInfo(container, engine);
+}
 
-    // find class info container
-    auto it = _objmap.find(canonicalName);
-    JNI_ASSERTF(it != _objmap.end(), "Attempt to retrieve class info for unregistered class: %s", canonicalName.c_str());
+JNIV8ClassInfo* JNIV8Wrapper::_createV8ClassInfo(JNIV8ClassInfoContainer *container, BGJSV8Engine *engine) {
+    pthread_mutex_lock(&_mutexEnv);
 
-    // check if class info object already exists for this engine!
-    for(auto &it2 : it->second->classInfos) {
-        if(it2->engine == engine) {
-            pthread_mutex_unlock(&_mutexEnv);
-            return it2;
-        }
+    // check again: another thread might have created the class info while we were waiting for the lock
+    JNIV8ClassInfo *existingInfo = engine->getClassInfoTable().get(container->typeId);
+    if(existingInfo) {
+        pthread_mutex_unlock(&_mutexEnv);
+        return existingInfo;
     }
-    // if it was not found we have to create it now & link it with the container
-    auto v8ClassInfo = new JNIV8ClassInfo(it->second, engine);
-    it->second->classInfos.push_back(v8ClassInfo);
+
+    container->initialize();
+
+    // if it was not found we have to create it now
+    // it is only published once it is fully initialized, so that other threads never see a partially initialized class info
+    auto v8ClassInfo = new JNIV8ClassInfo(container, engine);
 
     // initialize class info: template with constructor and general setup created here
     // individual methods and accessors handled by static method on subclass
@@ -157,7 +182,7 @@ JNIV8ClassInfo* JNIV8Wrapper::_getV8ClassInfo(const std::string& canonicalName,
 
     // v8 class name: canonical name with underscores instead of slashes
     // e.g. ag/boersego/bgjs/Test becomes ag_boersego_bgjs_Test
-    std::string strV8ClassName = canonicalName;
+    std::string strV8ClassName = container->canonicalName;
     std::replace(strV8ClassName.begin(), strV8ClassName.end(), '/', '_');
 
     Local<External> data = External::New(isolate, (void*)v8ClassInfo);
@@ -166,15 +191,8 @@ JNIV8ClassInfo* JNIV8Wrapper::_getV8ClassInfo(const std::string& canonicalName,
 
     // inherit from baseclass
     if(v8ClassInfo->container->baseClassInfo) {
-        JNIV8ClassInfo *baseInfo = nullptr;
         // base classinfo might not have been initialized yet => do so now!
-        _getV8ClassInfo(v8ClassInfo->container->baseClassInfo->canonicalName, engine);
-        for(auto &it2 : v8ClassInfo->container->baseClassInfo->classInfos) {
-            if(it2->engine == engine) {
-                baseInfo = it2;
-                break;
-            }
-        }
+        JNIV8ClassInfo *baseInfo = _getV8ClassInfo(v8ClassInfo->container->baseClassInfo, engine);
         JNI_ASSERT(baseInfo, "Failed to retrieve baseclass info");
         Local<FunctionTemplate> baseFT = Local<FunctionTemplate>::New(isolate, baseInfo->functionTemplate);
         ft->Inherit(baseFT);
@@ -187,15 +205,15 @@ JNIV8ClassInfo* JNIV8Wrapper::_getV8ClassInfo(const std::string& canonicalName,
     v8ClassInfo->functionTemplate.Reset(isolate, ft);
 
     // if this is a pure java class it might not have an initializer
-    if(it->second->initializer) {
-        it->second->initializer(v8ClassInfo);
+    if(container->initializer) {
+        container->initializer(v8ClassInfo);
     }
 
     // but it might have bindings on java that need to be processed
     // binding classes + methods do not need to be cached here, because they are only used once per Engine upon initialization!
     JNIEnv *env = JNIWrapper::getEnvironment();
-    jclass clsObject = it->second->clsObject;
-    jclass clsBinding = it->second->clsBinding;
+    jclass clsObject = container->clsObject;
+    jclass clsBinding = container->clsBinding;
     if(clsBinding && clsObject) {
         jfieldID createFromJavaOnlyId = env->GetStaticFieldID(clsBinding, "createFromJavaOnly", "Z");
         v8ClassInfo->createFromJavaOnly = env->GetStaticBooleanField(clsBinding, createFromJavaOnlyId);
@@ -287,6 +305,8 @@ JNIV8ClassInfo* JNIV8Wrapper::_getV8ClassInfo(const std::string& canonicalName,
         }
     }
 
+    engine->getClassInfoTable().set(container->typeId, v8ClassInfo);
+
     pthread_mutex_unlock(&_mutexEnv);
 
     return v8ClassInfo;
@@ -315,7 +335,7 @@ void JNIV8Wrapper::initializeNativeJNIV8Object(jobject obj, jobject engineObj, j
         persistentPtr = reinterpret_cast<v8::Persistent<Object>*>(jsObjPtr);
         jsObj = v8::Local<Object>::New(isolate, *persistentPtr);
         // clear and delete persistent
-        persistentPtr->Reset();
+        BGJS_CLEAR_PERSISTENT_PTR(persistentPtr);
         delete persistentPtr;
     }
 
@@ -327,22 +347,25 @@ void JNIV8Wrapper::initializeNativeJNIV8Object(jobject obj, jobject engineObj, j
 }
 
 void JNIV8Wrapper::_registerObject(JNIV8ObjectType type, const std::string& canonicalName, const std::string& baseCanonicalName, JNIV8ObjectInitializer i, JNIV8ObjectCreator c, size_t size) {
+    pthread_mutex_lock(&_mutexEnv);
+
     // canonicalName may be already registered
     // (e.g. when called from JNI_OnLoad; when using multiple linked libraries it is called once for each library)
-    auto it = _objmap.find(canonicalName);
-    if (it != _objmap.end()) {
-        JNI_ASSERTF(!i && !it->second->initializer, "Class %s registered both from native and java", canonicalName.c_str());
+    JNIV8ClassInfoContainer *existingInfo = _findContainer(canonicalName);
+    if (existingInfo) {
+        JNI_ASSERTF(!i && !existingInfo->initializer, "Class %s registered both from native and java", canonicalName.c_str());
+        pthread_mutex_unlock(&_mutexEnv);
         return;
     }
 
     // base class has to be registered if it is not JNIV8Object (which is only registered with JNIWrapper, because it provides no JS functionality on its own)
     JNIV8ClassInfoContainer *baseInfo = nullptr;
     if (!baseCanonicalName.empty()) {
-        it = _objmap.find(baseCanonicalName);
-        if (it == _objmap.end()) {
+        baseInfo = _findContainer(baseCanonicalName);
+        if (!baseInfo) {
+            pthread_mutex_unlock(&_mutexEnv);
             return;
         }
-        baseInfo = it->second;
     } else if(canonicalName != JNIBase::getCanonicalName<JNIV8Object>()) {
         // an empty base class is only allowed here for internally registering JNIObject itself
         JNI_ASSERT(0, "Attempt to register an object without super class");
@@ -354,6 +377,7 @@ void JNIV8Wrapper::_registerObject(JNIV8ObjectType type, const std::string& cano
             JNIV8ClassInfoContainer *baseInfo2 = baseInfo;
             do {
                 if (baseInfo2->type != JNIV8ObjectType::kWrapper && baseInfo2->baseClassInfo) {
+                    pthread_mutex_unlock(&_mutexEnv);
                     return;
                 }
                 baseInfo2 = baseInfo->baseClassInfo;
@@ -361,12 +385,23 @@ void JNIV8Wrapper::_registerObject(JNIV8ObjectType type, const std::string& cano
         } else if (baseInfo->type == JNIV8ObjectType::kWrapper &&
                    baseInfo->type != type) {
             // wrapper classes can only be extended by other wrapper classes!
+            pthread_mutex_unlock(&_mutexEnv);
             return;
         }
     }
 
-    auto *info = new JNIV8ClassInfoContainer(type, canonicalName, i, c, size, baseInfo);
-    _objmap[canonicalName] = info;
+    // type ids are used as index into the class info table of each engine
+    JNI_ASSERTF(_containerCount < JNIV8ClassInfoTable::kCapacity, "Too many classes registered; could not register %s", canonicalName.c_str());
+    auto *info = new JNIV8ClassInfoContainer(_containerCount++, type, canonicalName, i, c, size, baseInfo);
+
+    // the index is at most half full, so there always is a free slot
+    size_t slot = info->hashCode & (kContainerIndexSize - 1);
+    while (_containerIndex[slot].load(std::memory_order_relaxed)) {
+        slot = (slot + 1) & (kContainerIndexSize - 1);
+    }
+    _containerIndex[slot].store(info, std::memory_order_release);
+
+    pthread_mutex_unlock(&_mutexEnv);
 }
 
 // persistent classes can also be accessed as JNIV8Object directly!
@@ -392,14 +427,8 @@ template<> JNILocalRef<JNIV8Object> JNIV8Wrapper::wrapObject<JNIV8Object>(
  */
 void JNIV8Wrapper::cleanupV8Engine(BGJSV8Engine *engine) {
     pthread_mutex_lock(&_mutexEnv);
-    for(auto &it : _objmap) {
-        for (auto it2 = it.second->classInfos.begin(); it2 != it.second->classInfos.end(); ++it2) {
-            if((*it2)->engine == engine) {
-                delete *it2;
-                it.second->classInfos.erase(it2);
-                break;
-            }
-        }
+    for(auto info : engine->getClassInfoTable().clear()) {
+        delete info;
     }
     pthread_mutex_unlock(&_mutexEnv);
-}
\ No newline at end of file
+}
@@ -12,6 +12,8 @@
 
 #include "JNIV8Object.h"
 
+#include <atomic>
+
 class JNIV8Wrapper {
 public:
     static void init();
@@ -113,8 +115,8 @@ public:
      */
     template <typename ObjectType> static
     JNILocalRef<ObjectType> wrapObject(v8::Local<v8::Object> object) {
-        auto it = _objmap.find(JNIBase::getCanonicalName<ObjectType>());
-        if (it == _objmap.end()) {
+        JNIV8ClassInfoContainer *info = _getContainer<ObjectType>();
+        if (!info) {
             return nullptr;
         }
 
@@ -126,37 +128,43 @@ public:
         // we still need a handle scope however...
         v8::HandleScope scope(isolate);
 
-        JNIV8ClassInfoContainer *info = it->second;
-
         if(info->type == JNIV8ObjectType::kWrapper) {
             // make sure the object is actually supported by the specified type
             if(!ObjectType::isWrappableV8Object(object)) {
                 return nullptr;
             }
-            /*
-            // does the object have a native object stored in a private key?
-            auto privateKey = v8::Private::ForApi(isolate, v8::String::NewFromUtf8(isolate, _v8PrivateKey));
-            auto privateValue = object->GetPrivate(isolate->GetCurrentContext(), privateKey);
-            if (!privateValue.IsEmpty()) {
-                ext = privateValue.ToLocalChecked().As<v8::External>();
-            } else {
-                // the private key was empty so we have to create a new object
-                v8::Persistent<v8::Object>* persistent = new v8::Persistent<v8::Object>(isolate, object);
-                auto sharedPtr = info->creator(_getV8ClassInfo(JNIBase::getCanonicalName<ObjectType>(), BGJSV8Engine::GetInstance(isolate)), persistent);
-
-                // store in private
-                object->SetPrivate(isolate->GetCurrentContext(), privateKey, v8::External::New(isolate, sharedPtr.get()));
+            BGJSV8Engine *engine = BGJSV8Engine::GetInstance(isolate);
+            v8::Local<v8::Context> context = isolate->GetCurrentContext();
+            v8::Local<v8::Private> peerKey = engine->getWrapperPeerKey();
+            JNIEnv *env = JNIWrapper::getEnvironment();
 
-                return std::static_pointer_cast<ObjectType>(sharedPtr);
+            // the same js object should always be represented by the same java object
+            // => the native object of the last wrapper is stored in a private; it removes itself again when it is destroyed
+            // the java object is not referenced from js, so it can still be collected while the js object is alive
+            v8::Local<v8::Value> peerValue;
+            if (object->GetPrivate(context, peerKey).ToLocal(&peerValue) && peerValue->IsExternal()) {
+                ptr = reinterpret_cast<JNIV8Object*>(peerValue.As<v8::External>()->Value());
+                if (JNIWrapper::isObjectInstanceOf<ObjectType>(ptr)) {
+                    // the java object might already have been collected while the native object is waiting to be disposed
+                    // the local reference keeps it alive until it has been retained
+                    jobject peerRef = env->NewLocalRef(ptr->getBorrowedJObject());
+                    if (peerRef) {
+                        JNIRetainedRef<ObjectType> retainedRef(reinterpret_cast<ObjectType*>(ptr));
+                        env->DeleteLocalRef(peerRef);
+                        return JNILocalRef<ObjectType>::New(retainedRef);
+                    }
+                }
             }
-             */
-            // a new wrapper object is created every time!
+
             v8::Persistent<v8::Object>* persistent = new v8::Persistent<v8::Object>(isolate, object);
-            JNIEnv *env = JNIWrapper::getEnvironment();
+            BGJS_NEW_PERSISTENT_PTR(persistent);
             jobjectArray arguments = env->NewObjectArray(0, _jniObject.clazz, nullptr);
             // __android_log_print(ANDROID_LOG_WARN, "JNIV8Wrapper", "Creating %s", JNIBase::getCanonicalName<ObjectType>().c_str());
-            auto retainedRef = JNIRetainedRef<ObjectType>::Cast(info->creator(_getV8ClassInfo(JNIBase::getCanonicalName<ObjectType>(), BGJSV8Engine::GetInstance(isolate)), persistent, arguments));
+            auto retainedRef = JNIRetainedRef<ObjectType>::Cast(info->creator(_getV8ClassInfo(info, engine), persistent, arguments));
             env->DeleteLocalRef(arguments);
+            if (retainedRef) {
+                object->SetPrivate(context, peerKey, v8::External::New(isolate, retainedRef.get()));
+            }
             return JNILocalRef<ObjectType>::New(retainedRef);
         } else {
             if (object->InternalFieldCount() >= 1) {
@@ -179,7 +187,9 @@ public:
      */
     template <typename ObjectType> static
     v8::Local<v8::Function> getJSConstructor(BGJSV8Engine *engine) {
-        return _getV8ClassInfo(JNIBase::getCanonicalName<ObjectType>(), engine)->getConstructor();
+        JNIV8ClassInfoContainer *container = _getContainer<ObjectType>();
+        JNI_ASSERTF(container, "Attempt to retrieve class info for unregistered class: %s", JNIBase::getCanonicalName<ObjectType>().c_str());
+        return _getV8ClassInfo(container, engine)->getConstructor();
     }
     static v8::Local<v8::Function> getJSConstructor(BGJSV8Engine *engine, const std::string &canonicalName) {
         return _getV8ClassInfo(canonicalName, engine)->getConstructor();
@@ -206,8 +216,37 @@ private:
 
     static void _registerObject(JNIV8ObjectType type, const std::string& canonicalName, const std::string& baseCanonicalName, JNIV8ObjectInitializer i, JNIV8ObjectCreator c, size_t size);
     static JNIV8ClassInfo* _getV8ClassInfo(const std::string& canonicalName, BGJSV8Engine *engine);
+    static JNIV8ClassInfo* _createV8ClassInfo(JNIV8ClassInfoContainer *container, BGJSV8Engine *engine);
+    static JNIV8ClassInfoContainer* _findContainer(const std::string& canonicalName);
+
+    /**
+     * returns the class info of the specified class for an engine; does not take a lock if it was already created
+     */
+    static inline JNIV8ClassInfo* _getV8ClassInfo(JNIV8ClassInfoContainer *container, BGJSV8Engine *engine) {
+        JNIV8ClassInfo *info = engine->getClassInfoTable().get(container->typeId);
+        return info ? info : _createV8ClassInfo(container, engine);
+    }
+
+    /**
+     * returns the container of a native class, or nullptr if it was not registered
+     * the container never changes once registered, so it is only looked up once per class
+     */
+    template<class ObjectType>
+    static JNIV8ClassInfoContainer* _getContainer() {
+        static std::atomic<JNIV8ClassInfoContainer*> container(nullptr);
+        JNIV8ClassInfoContainer *result = container.load(std::memory_order_acquire);
+        if (!result) {
+            result = _findContainer(JNIBase::getCanonicalName<ObjectType>());
+            container.store(result, std::memory_order_release);
+        }
+        return result;
+    }
 
-    static std::map<std::string, JNIV8ClassInfoContainer*> _objmap;
+    // open addressing hash table of all registered classes; entries are inserted with _mutexEnv held and never removed,
+    // so it can be read without taking a lock
+    static const size_t kContainerIndexSize = 2 * JNIV8ClassInfoTable::kCapacity;
+    static std::atomic<JNIV8ClassInfoContainer*> _containerIndex[kContainerIndexSize];
+    static size_t _containerCount;
 
     static pthread_mutex_t _mutexEnv;
 
@@ -218,10 +257,7 @@ private:
 
     template<class ObjectType>
     static JNIRetainedRef<JNIV8Object> createJavaClass(JNIV8ClassInfo *info, v8::Persistent<v8::Object> *jsObj, jobjectArray arguments) {
-        jobject engineObj = info->engine->getJObject();
-        JNIRetainedRef<JNIV8Object> ref = JNIRetainedRef<JNIV8Object>::Cast(JNIV8Wrapper::createDerivedObject<ObjectType>(info->container->canonicalName, "<JNIV8ObjectInit>", engineObj, (jlong)(void*)jsObj, arguments));
-        JNIWrapper::getEnvironment()->DeleteLocalRef(engineObj);
-        return ref;
+        return JNIRetainedRef<JNIV8Object>::Cast(JNIV8Wrapper::createDerivedObject<ObjectType>(info->container->canonicalName, "<JNIV8ObjectInit>", info->engine->getBorrowedJObject(), (jlong)(void*)jsObj, arguments));
     }
     
     // cache of classes + ids
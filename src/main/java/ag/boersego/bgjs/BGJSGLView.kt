@@ -151,6 +151,10 @@ open class BGJSGLView(engine: V8Engine, private var textureView: V8TextureView?)
         val DEBUG = false && BuildConfig.DEBUG
         val TAG = BGJSGLView::class.java.simpleName
 
+        init {
+            JNIObject.InitializeClass(BGJSGLView::class.java)
+        }
+
         @JvmStatic
         external fun Create(engine: V8Engine): BGJSGLView
     }
@@ -39,6 +39,28 @@ abstract public class JNIObject {
     }
     static private native void RegisterClass(String derivedClass, String baseClass);
 
+    /**
+     * native classes registered with deferred initialization (JNIWrapper::setDeferClassInitialization) are initialized when they are first used from jni
+     * such classes have to call this from their static initializer if they declare native methods,
+     * so that their natives are registered before they can be called; for all other classes this is a no-op
+     */
+    static public void InitializeClass(Class<? extends JNIObject> cls) {
+        InitializeClass(cls.getName());
+    }
+    static private native void InitializeClass(String canonicalName);
+
+    /**
+     * initializes the specified classes on a background thread, e.g. classes that are known to be used during app startup
+     */
+    static public void PreloadClasses(Class<? extends JNIObject>... classes) {
+        final String[] names = new String[classes.length];
+        for (int i = 0; i < classes.length; i++) {
+            names[i] = classes[i].getName();
+        }
+        PreloadClasses(names);
+    }
+    static private native void PreloadClasses(String[] canonicalNames);
+
     /**
      * default constructor; will always initialize the jni side of the object automatically
      */
@@ -13,12 +13,21 @@ import java.util.NoSuchElementException;
  */
 
 final public class JNIV8Array extends JNIV8Object implements Iterable<Object> {
+    static {
+        JNIObject.InitializeClass(JNIV8Array.class);
+    }
+
     public static native JNIV8Array Create(V8Engine engine);
     public static native JNIV8Array CreateWithLength(V8Engine engine, int length);
     public static native JNIV8Array CreateWithArray(V8Engine engine, Object[] elements);
     public static JNIV8Array CreateWithElements(V8Engine engine, Object... elements) {
         return CreateWithArray(engine, elements);
     }
+    /**
+     * creates a js array of numbers without boxing the elements
+     */
+    public static native JNIV8Array CreateWithDoubleArray(V8Engine engine, double[] elements);
+    public static native JNIV8Array CreateWithIntArray(V8Engine engine, int[] elements);
 
     public boolean isEmpty() {
         return getV8Length() == 0;
@@ -61,6 +70,27 @@ final public class JNIV8Array extends JNIV8Object implements Iterable<Object> {
         return (T[]) _getV8Elements(V8Flags.Default, returnType.hashCode(), returnType, from, to);
     }
 
+    /**
+     * Returns all elements inside of the array as a primitive array without boxing them
+     * elements that are not numbers (e.g. holes or mixed arrays) are converted like arguments of type double/int;
+     * for int arrays that means that elements that can not be converted to a number cause a ClassCastException
+     */
+    public @NonNull double[] getV8ElementsAsDoubleArray() {
+        return _getV8ElementsAsDoubleArray(0, Integer.MAX_VALUE);
+    }
+
+    public @NonNull double[] getV8ElementsAsDoubleArray(int from, int to) {
+        return _getV8ElementsAsDoubleArray(from, to);
+    }
+
+    public @NonNull int[] getV8ElementsAsIntArray() {
+        return _getV8ElementsAsIntArray(0, Integer.MAX_VALUE);
+    }
+
+    public @NonNull int[] getV8ElementsAsIntArray(int from, int to) {
+        return _getV8ElementsAsIntArray(from, to);
+    }
+
     /**
      * Returns the object at the specified index
      * if index is out of bounds, returns JNIV8Undefined
@@ -93,6 +123,8 @@ final public class JNIV8Array extends JNIV8Object implements Iterable<Object> {
     // internal fields & methods
     private native Object _getV8Element(int flags, int type, Class returnType, int index);
     private native Object[] _getV8Elements(int flags, int type, Class returnType, int from, int to);
+    private native double[] _getV8ElementsAsDoubleArray(int from, int to);
+    private native int[] _getV8ElementsAsIntArray(int from, int to);
 
     @Keep
     protected JNIV8Array(V8Engine engine, long jsObjPtr, Object[] arguments) {
@@ -1,10 +1,55 @@
 package ag.boersego.bgjs;
 
 import androidx.annotation.Keep;
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Wraps a js ArrayBuffer
+ *
+ * Memory is shared between java and js without copying it:
+ * - CreateWithByteBuffer creates an ArrayBuffer that uses the memory of a direct ByteBuffer.
+ *   The ByteBuffer stays owned by java and is kept alive until the ArrayBuffer has been garbage collected in js;
+ *   its whole capacity is used, position and limit are ignored.
+ * - getV8ByteBuffer returns a direct ByteBuffer that uses the memory of the ArrayBuffer.
+ *   The memory is owned by js; the returned ByteBuffer keeps this wrapper, and with it the ArrayBuffer, alive.
+ *   Views created from it with slice() or duplicate() do not, so keep the returned buffer while using them.
+ *
+ * Buffers are never neutered by the bridge. If native code neuters an ArrayBuffer, its length becomes 0
+ * and ByteBuffers retrieved before must not be used anymore.
+ * Access to the memory is not synchronized; it should only be modified while js is not accessing it.
+ */
 public class JNIV8ArrayBuffer extends JNIV8Object {
+    static {
+        JNIObject.InitializeClass(JNIV8ArrayBuffer.class);
+    }
+
+    public static native JNIV8ArrayBuffer CreateWithLength(V8Engine engine, int length);
+    public static native JNIV8ArrayBuffer CreateWithByteBuffer(V8Engine engine, @NonNull ByteBuffer buffer);
+
+    /**
+     * returns the length of the buffer in bytes
+     */
+    public native int getV8ByteLength();
+
+    /**
+     * returns a direct ByteBuffer using the memory of the ArrayBuffer; uses the native byte order like typed arrays in js
+     */
+    public @NonNull ByteBuffer getV8ByteBuffer() {
+        ByteBuffer buffer = _getV8ByteBuffer();
+        if (buffer == null) {
+            return ByteBuffer.allocateDirect(0).order(ByteOrder.nativeOrder());
+        }
+        return JNIV8ByteBufferReference.keepAlive(buffer.order(ByteOrder.nativeOrder()), this);
+    }
+
     //------------------------------------------------------------------------
     // internal fields & methods
+    private native @Nullable ByteBuffer _getV8ByteBuffer();
+
     @Keep
     protected JNIV8ArrayBuffer(V8Engine engine, long jsObjPtr, Object[] arguments) {
         super(engine, jsObjPtr, arguments);
@@ -0,0 +1,58 @@
+package ag.boersego.bgjs;
+
+import android.util.Log;
+
+import java.lang.ref.PhantomReference;
+import java.lang.ref.ReferenceQueue;
+import java.nio.ByteBuffer;
+import java.util.Collections;
+import java.util.HashSet;
+import java.util.Set;
+
+/**
+ * Keeps the wrapper of a js object alive for as long as a direct ByteBuffer using its memory is reachable
+ *
+ * ByteBuffers created with JNI's NewDirectByteBuffer do not reference anything, so without this the wrapper could be
+ * collected while the ByteBuffer is still in use, and the ArrayBuffer memory would be freed underneath it.
+ * The reference holds the wrapper strongly; once the ByteBuffer has been collected the reference is enqueued and dropped
+ * by a daemon thread, which makes the wrapper collectable again.
+ */
+final class JNIV8ByteBufferReference extends PhantomReference<ByteBuffer> {
+    private static final ReferenceQueue<ByteBuffer> referenceQueue = new ReferenceQueue<>();
+    private static final Set<JNIV8ByteBufferReference> references = Collections.synchronizedSet(new HashSet<>());
+    private static final Thread releasingThread;
+
+    static {
+        releasingThread = new Thread(() -> {
+            while (true) {
+                try {
+                    references.remove(referenceQueue.remove());
+                } catch (InterruptedException e) {
+                    Thread.currentThread().interrupt();
+                    Log.e("JNIV8ByteBufferReference", "The releasing thread has been interrupted." +
+                            " Wrappers of shared memory cannot be released anymore");
+                    break;
+                }
+            }
+        });
+        releasingThread.setName("EjectaV8ByteBufferDaemon");
+        releasingThread.setDaemon(true);
+        releasingThread.start();
+    }
+
+    @SuppressWarnings({"unused", "FieldCanBeLocal"})
+    private final JNIV8Object owner;
+
+    private JNIV8ByteBufferReference(ByteBuffer buffer, JNIV8Object owner) {
+        super(buffer, referenceQueue);
+        this.owner = owner;
+    }
+
+    /**
+     * ties the lifetime of owner to buffer and returns buffer
+     */
+    static ByteBuffer keepAlive(ByteBuffer buffer, JNIV8Object owner) {
+        references.add(new JNIV8ByteBufferReference(buffer, owner));
+        return buffer;
+    }
+}
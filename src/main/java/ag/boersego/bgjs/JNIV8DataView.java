@@ -0,0 +1,48 @@
+package ag.boersego.bgjs;
+
+import androidx.annotation.Keep;
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Wraps a js DataView
+ *
+ * DataViews never copy memory; see JNIV8ArrayBuffer for the ownership rules of the underlying buffer.
+ */
+public class JNIV8DataView extends JNIV8Object {
+    static {
+        JNIObject.InitializeClass(JNIV8DataView.class);
+    }
+
+    public static JNIV8DataView CreateWithBuffer(V8Engine engine, @NonNull JNIV8ArrayBuffer buffer, int byteOffset, int byteLength) {
+        return _createWithBuffer(engine, buffer, byteOffset, byteLength);
+    }
+
+    public native int getV8ByteOffset();
+    public native int getV8ByteLength();
+    public native @NonNull JNIV8ArrayBuffer getV8Buffer();
+
+    /**
+     * returns a direct ByteBuffer using the memory of the view; see JNIV8ArrayBuffer.getV8ByteBuffer
+     */
+    public @NonNull ByteBuffer getV8ByteBuffer() {
+        ByteBuffer buffer = _getV8ByteBuffer();
+        if (buffer == null) {
+            return ByteBuffer.allocateDirect(0).order(ByteOrder.nativeOrder());
+        }
+        return JNIV8ByteBufferReference.keepAlive(buffer.order(ByteOrder.nativeOrder()), this);
+    }
+
+    //------------------------------------------------------------------------
+    // internal fields & methods
+    private static native JNIV8DataView _createWithBuffer(V8Engine engine, JNIV8ArrayBuffer buffer, int byteOffset, int byteLength);
+    private native @Nullable ByteBuffer _getV8ByteBuffer();
+
+    @Keep
+    protected JNIV8DataView(V8Engine engine, long jsObjPtr, Object[] arguments) {
+        super(engine, jsObjPtr, arguments);
+    }
+}
@@ -12,11 +12,62 @@ import ag.boersego.v8annotations.V8Flags;
 
 @SuppressWarnings("unused")
 final public class JNIV8Function extends JNIV8Object {
+    static {
+        JNIObject.InitializeClass(JNIV8Function.class);
+    }
+
     public interface Handler {
         Object Callback(@NonNull Object receiver, @NonNull Object[] arguments);
     }
 
+    // Typed handlers: arguments are converted to the declared types like arguments of @V8Function methods,
+    // and passed without allocating an argument array or boxing primitives.
+    // The receiver is not passed; missing arguments are treated as undefined.
+    // They use separate factory methods, because lambdas would be ambiguous for overloads of Create.
+
+    public interface DoubleHandler {
+        Object Callback(double value);
+    }
+
+    public interface Double2Handler {
+        Object Callback(double value1, double value2);
+    }
+
+    public interface StringHandler {
+        Object Callback(@Nullable String value);
+    }
+
+    public interface ObjectHandler {
+        Object Callback(@Nullable Object value);
+    }
+
+    public interface V8ObjectHandler {
+        Object Callback(@Nullable JNIV8Object value);
+    }
+
+    // Typed handlers returning primitives: the result is passed to js without boxing it either
+
+    public interface DoubleToDoubleHandler {
+        double Callback(double value);
+    }
+
+    public interface Double2ToDoubleHandler {
+        double Callback(double value1, double value2);
+    }
+
+    public interface DoubleToBooleanHandler {
+        boolean Callback(double value);
+    }
+
     public static native JNIV8Function Create(V8Engine engine, JNIV8Function.Handler handler);
+    public static native JNIV8Function CreateDouble(V8Engine engine, JNIV8Function.DoubleHandler handler);
+    public static native JNIV8Function CreateDouble2(V8Engine engine, JNIV8Function.Double2Handler handler);
+    public static native JNIV8Function CreateString(V8Engine engine, JNIV8Function.StringHandler handler);
+    public static native JNIV8Function CreateObject(V8Engine engine, JNIV8Function.ObjectHandler handler);
+    public static native JNIV8Function CreateV8Object(V8Engine engine, JNIV8Function.V8ObjectHandler handler);
+    public static native JNIV8Function CreateDoubleToDouble(V8Engine engine, JNIV8Function.DoubleToDoubleHandler handler);
+    public static native JNIV8Function CreateDouble2ToDouble(V8Engine engine, JNIV8Function.Double2ToDoubleHandler handler);
+    public static native JNIV8Function CreateDoubleToBoolean(V8Engine engine, JNIV8Function.DoubleToBooleanHandler handler);
 
     public @Nullable
     Object callAsV8Function(@Nullable Object... arguments) {
@@ -97,6 +148,33 @@ final public class JNIV8Function extends JNIV8Object {
         return (T) _callAsV8Function(false, V8Flags.Default, returnType.hashCode(), returnType, receiver, arguments);
     }
 
+    /**
+     * Calls every function with its own receiver and arguments while acquiring the engine lock only once.
+     * All functions have to belong to the same engine; receivers may be null to call all functions with a null receiver.
+     * If errors is specified, the exception of each failed call is stored at its index and execution continues;
+     * otherwise the first exception is thrown once all calls have been executed.
+     * @return the results of the calls; failed calls have a null result
+     */
+    public static @NonNull
+    Object[] callAsV8Functions(@NonNull JNIV8Function[] functions, @Nullable Object[] receivers, @NonNull Object[][] arguments, @Nullable Throwable[] errors) {
+        return _callAsV8Functions(functions, receivers, arguments, errors);
+    }
+
+    /**
+     * Calls this function once for every argument list while acquiring the engine lock only once.
+     * See {@link #callAsV8Functions} for how exceptions are handled.
+     * @return the results of the calls; failed calls have a null result
+     */
+    public @NonNull
+    Object[] callAsV8FunctionBatch(@Nullable Object receiver, @NonNull Object[][] arguments, @Nullable Throwable[] errors) {
+        return _callAsV8FunctionBatch(receiver, arguments, errors);
+    }
+
+    public @NonNull
+    Object[] callAsV8FunctionBatch(@NonNull Object[][] arguments) {
+        return _callAsV8FunctionBatch(null, arguments, null);
+    }
+
     @Override
     public void dispose() throws RuntimeException {
         super.dispose();
@@ -105,6 +183,8 @@ final public class JNIV8Function extends JNIV8Object {
     //------------------------------------------------------------------------
     // internal fields & methods
     private native Object _callAsV8Function(boolean asConstructor, int flags, int type, Class returnType, Object receiver, Object... arguments);
+    private static native Object[] _callAsV8Functions(JNIV8Function[] functions, Object[] receivers, Object[][] arguments, Throwable[] errors);
+    private native Object[] _callAsV8FunctionBatch(Object receiver, Object[][] arguments, Throwable[] errors);
 
     @Keep
     protected JNIV8Function(V8Engine engine, long jsObjPtr, Object[] arguments) {
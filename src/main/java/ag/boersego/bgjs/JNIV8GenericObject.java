@@ -11,6 +11,9 @@ import java.util.Set;
  */
 
 final public class JNIV8GenericObject extends JNIV8Object {
+    static {
+        JNIObject.InitializeClass(JNIV8GenericObject.class);
+    }
 
     public static final String TAG = JNIV8GenericObject.class.getSimpleName();
 
@@ -4,6 +4,7 @@ import androidx.annotation.NonNull;
 import androidx.annotation.Nullable;
 
 import java.lang.reflect.Modifier;
+import java.nio.ByteBuffer;
 import java.util.Map;
 
 /**
@@ -12,6 +13,10 @@ import java.util.Map;
 
 @SuppressWarnings("unused")
 abstract public class JNIV8Object extends JNIObject {
+    static {
+        JNIObject.InitializeClass(JNIV8Object.class);
+    }
+
     static public void RegisterAliasForPrimitive(Class alias, Class primitive) {
         RegisterAliasForPrimitive(alias.hashCode(), primitive.hashCode());
     }
@@ -39,6 +44,20 @@ abstract public class JNIV8Object extends JNIObject {
     public native double toNumber();
     public native String toString();
     public native String toJSON();
+
+    /**
+     * Serialize the object to UTF-8 encoded JSON without creating an intermediate String
+     * @return the serialized JSON or null if the object has no JSON representation
+     */
+    public native byte[] toJSONBytes();
+
+    /**
+     * Serialize the object to UTF-8 encoded JSON and write it to the start of the specified direct buffer
+     * The buffer is only written to if it is large enough to hold the complete result; its position and limit are not modified
+     * @return the number of bytes written; 0 if the object has no JSON representation;
+     *         or the negated required size if the buffer is too small, in which case nothing was written
+     */
+    public native int toJSONBytes(@NonNull ByteBuffer target);
     public native boolean isInstanceOf(JNIV8Function constructor);
     public native boolean isInstanceOf(String name);
 
@@ -107,6 +126,24 @@ abstract public class JNIV8Object extends JNIObject {
         return (Map<String, T>)getV8Fields(false, V8Flags.Default, returnType.hashCode(), returnType);
     }
 
+    /**
+     * get the values of multiple fields at once; the values are returned in the same order as the keys
+     */
+    public @NonNull Object[] getV8Fields(@NonNull String[] keys) {
+        return _getV8Fields(keys, 0, 0, null);
+    }
+    public @NonNull Object[] getV8FieldsTyped(@NonNull String[] keys, int flags, @NonNull Class<?> returnType) {
+        return _getV8Fields(keys, flags, returnType.hashCode(), returnType);
+    }
+    public @NonNull Object[] getV8FieldsTyped(@NonNull String[] keys, @NonNull Class<?> returnType) {
+        return _getV8Fields(keys, V8Flags.Default, returnType.hashCode(), returnType);
+    }
+
+    /**
+     * get the values of multiple fields as numbers (using the javascript coercion rules) and store them in target
+     */
+    public native void getV8Fields(@NonNull String[] keys, @NonNull double[] target);
+
     public @NonNull String[] getV8OwnKeys() {
         return getV8Keys(true);
     }
@@ -125,6 +162,13 @@ abstract public class JNIV8Object extends JNIObject {
 
     public native void setV8Field(@NonNull String name, @Nullable Object value);
     public native void setV8Fields(@NonNull Map< String, Object> fields);
+
+    /**
+     * set multiple fields at once; keys and values are matched by index
+     * considerably faster than passing a map, because no java methods have to be called for reading the entries
+     */
+    public native void setV8Fields(@NonNull String[] keys, @NonNull Object[] values);
+    public native void setV8Fields(@NonNull String[] keys, @NonNull double[] values);
     public native void setV8Accessor(@NonNull String name, @NonNull JNIV8Function getter, @Nullable JNIV8Function setter);
 
     /**
@@ -237,5 +281,6 @@ abstract public class JNIV8Object extends JNIObject {
     private native boolean hasV8Field(String name, boolean ownOnly);
     private native String[] getV8Keys(boolean ownOnly);
     private native Map<String,Object> getV8Fields(boolean ownOnly, int flags, int type, Class returnType);
+    private native Object[] _getV8Fields(String[] keys, int flags, int type, Class returnType);
     private native void initNativeJNIV8Object(String canonicalName, V8Engine engine, long jsObjPtr);
 }
@@ -6,7 +6,15 @@ import androidx.annotation.NonNull;
 import androidx.annotation.Nullable;
 
 public class JNIV8Promise extends JNIV8Object {
+    static {
+        JNIObject.InitializeClass(JNIV8Promise.class);
+    }
+
     public static class Resolver extends JNIV8Object {
+        static {
+            JNIObject.InitializeClass(Resolver.class);
+        }
+
         //------------------------------------------------------------------------
         // internal fields & methods
         @Keep
@@ -17,6 +25,16 @@ public class JNIV8Promise extends JNIV8Object {
         public native @NonNull JNIV8Promise getPromise();
         public native boolean resolve(@Nullable Object value);
         public native boolean reject(@Nullable Object value);
+
+        /**
+         * settle the promise on the event loop of the engine instead of the calling thread
+         * never waits for js that is currently running; use this on threads that do not own the engine, e.g. network callbacks
+         * settlements posted before the event loop wakes up are applied together, followed by a single microtask checkpoint
+         * numbers, booleans and strings are read on the calling thread; other values are converted on the event loop
+         * @throws IllegalStateException if the event loop of the engine has already ended
+         */
+        public native void resolveAsync(@Nullable Object value);
+        public native void rejectAsync(@Nullable Object value);
     }
 
     public static native Resolver CreateResolver(@NonNull V8Engine engine);
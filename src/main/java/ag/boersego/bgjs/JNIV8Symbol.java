@@ -4,6 +4,10 @@ import ag.boersego.v8annotations.V8Symbols;
 import androidx.annotation.Keep;
 
 public class JNIV8Symbol extends JNIV8Object {
+    static {
+        JNIObject.InitializeClass(JNIV8Symbol.class);
+    }
+
     /**
      * searches for existing symbols in a runtime-wide symbol registry
      * if a symbol for the given key already exists it is returned;
@@ -0,0 +1,133 @@
+package ag.boersego.bgjs;
+
+import androidx.annotation.Keep;
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Wraps a js TypedArray (Int8Array, Uint8Array, ..., BigUint64Array)
+ *
+ * CreateWithBuffer and getV8ByteBuffer share memory with the underlying ArrayBuffer without copying it,
+ * see JNIV8ArrayBuffer for the ownership rules.
+ * CreateWith*Array and the to*Array methods copy the elements; unsigned types use the signed java type of the same size.
+ *
+ * java primitive arrays passed to js are converted to a copy in an Int8Array, Int16Array, Int32Array, BigInt64Array,
+ * Float32Array or Float64Array.
+ */
+public class JNIV8TypedArray extends JNIV8Object {
+    static {
+        JNIObject.InitializeClass(JNIV8TypedArray.class);
+    }
+
+    /**
+     * element types; the order has to match JNIV8TypedArrayType in native code
+     */
+    public enum Type {
+        Int8, Uint8, Uint8Clamped, Int16, Uint16, Int32, Uint32, Float32, Float64, BigInt64, BigUint64
+    }
+
+    /**
+     * creates a typed array with length zero-initialized elements
+     * throws IllegalArgumentException if length is negative or larger than v8 supports, and OutOfMemoryError if the byte length is too large
+     */
+    public static JNIV8TypedArray Create(V8Engine engine, @NonNull Type type, int length) {
+        return _create(engine, type.ordinal(), length);
+    }
+
+    /**
+     * creates a view on an existing ArrayBuffer; byteOffset has to be a multiple of the element size
+     */
+    public static JNIV8TypedArray CreateWithBuffer(V8Engine engine, @NonNull Type type, @NonNull JNIV8ArrayBuffer buffer, int byteOffset, int length) {
+        return _createWithBuffer(engine, type.ordinal(), buffer, byteOffset, length);
+    }
+
+    public static JNIV8TypedArray CreateWithByteArray(V8Engine engine, @NonNull Type type, @NonNull byte[] elements) {
+        return _createWithArray(engine, type.ordinal(), elements);
+    }
+    public static JNIV8TypedArray CreateWithShortArray(V8Engine engine, @NonNull Type type, @NonNull short[] elements) {
+        return _createWithArray(engine, type.ordinal(), elements);
+    }
+    public static JNIV8TypedArray CreateWithIntArray(V8Engine engine, @NonNull Type type, @NonNull int[] elements) {
+        return _createWithArray(engine, type.ordinal(), elements);
+    }
+    public static JNIV8TypedArray CreateWithLongArray(V8Engine engine, @NonNull Type type, @NonNull long[] elements) {
+        return _createWithArray(engine, type.ordinal(), elements);
+    }
+    public static JNIV8TypedArray CreateWithFloatArray(V8Engine engine, @NonNull float[] elements) {
+        return _createWithArray(engine, Type.Float32.ordinal(), elements);
+    }
+    public static JNIV8TypedArray CreateWithDoubleArray(V8Engine engine, @NonNull double[] elements) {
+        return _createWithArray(engine, Type.Float64.ordinal(), elements);
+    }
+
+    public @NonNull Type getType() {
+        return Type.values()[_getType()];
+    }
+
+    /**
+     * returns the number of elements
+     * sizes that do not fit into an int (arrays larger than 2GB created in js) throw an IllegalStateException
+     */
+    public native int getV8Length();
+    public native int getV8ByteOffset();
+    public native int getV8ByteLength();
+    public native @NonNull JNIV8ArrayBuffer getV8Buffer();
+
+    /**
+     * returns a direct ByteBuffer using the memory of the elements; see JNIV8ArrayBuffer.getV8ByteBuffer
+     */
+    public @NonNull ByteBuffer getV8ByteBuffer() {
+        ByteBuffer buffer = _getV8ByteBuffer();
+        if (buffer == null) {
+            return ByteBuffer.allocateDirect(0).order(ByteOrder.nativeOrder());
+        }
+        return JNIV8ByteBufferReference.keepAlive(buffer.order(ByteOrder.nativeOrder()), this);
+    }
+
+    /**
+     * returns a copy of the elements; the type of the array has to match the element size
+     */
+    public @NonNull byte[] toByteArray() {
+        return (byte[]) toArray(byte[].class);
+    }
+    public @NonNull short[] toShortArray() {
+        return (short[]) toArray(short[].class);
+    }
+    public @NonNull int[] toIntArray() {
+        return (int[]) toArray(int[].class);
+    }
+    public @NonNull long[] toLongArray() {
+        return (long[]) toArray(long[].class);
+    }
+    public @NonNull float[] toFloatArray() {
+        return (float[]) toArray(float[].class);
+    }
+    public @NonNull double[] toDoubleArray() {
+        return (double[]) toArray(double[].class);
+    }
+
+    //------------------------------------------------------------------------
+    // internal fields & methods
+    private static native JNIV8TypedArray _create(V8Engine engine, int type, int length);
+    private static native JNIV8TypedArray _createWithBuffer(V8Engine engine, int type, JNIV8ArrayBuffer buffer, int byteOffset, int length);
+    private static native JNIV8TypedArray _createWithArray(V8Engine engine, int type, Object elements);
+    private native int _getType();
+    private native @Nullable ByteBuffer _getV8ByteBuffer();
+    private native Object _toArray();
+
+    private Object toArray(Class<?> arrayClass) {
+        Object result = _toArray();
+        if (!arrayClass.isInstance(result)) {
+            throw new IllegalStateException("Cannot convert " + getType() + "Array to " + arrayClass.getSimpleName());
+        }
+        return result;
+    }
+
+    @Keep
+    protected JNIV8TypedArray(V8Engine engine, long jsObjPtr, Object[] arguments) {
+        super(engine, jsObjPtr, arguments);
+    }
+}
@@ -24,6 +24,7 @@ import java.util.*;
 public class V8Engine extends JNIObject {
     static {
         System.loadLibrary("bgjs");
+        JNIObject.InitializeClass(V8Engine.class);
         JNIV8Object.RegisterAliasForPrimitive(Number.class, Double.class);
         // Register kotlin primitives (which from the viewpoint of JNI are classes that don't have a classloader!)
         JNIV8ObjectKt.registerKotlinAliases();
@@ -44,6 +45,14 @@ public class V8Engine extends JNIObject {
 
     public native void unpause();
 
+    /**
+     * Allow timers to fire up to the specified amount of milliseconds late, so that timers which are due
+     * at roughly the same time are run in a single wakeup of the event loop.
+     *
+     * @param slackMs the timer slack in milliseconds; 0 (default) disables coalescing
+     */
+    public native void setTimerSlack(int slackMs);
+
     /**
      * Execute a Runnable within a v8 level lock on this v8 engine and hence this v8 Isolate.
      *
@@ -73,6 +82,48 @@ public class V8Engine extends JNIObject {
         }));
     }
 
+    /**
+     * Priority for input handling and rendering; these tasks always run before any other task
+     */
+    public static final int TASK_PRIORITY_USER_BLOCKING = 0;
+    /**
+     * Default priority
+     */
+    public static final int TASK_PRIORITY_USER_VISIBLE = 1;
+    /**
+     * Priority for work that is not time critical, e.g. parsing or prefetching
+     */
+    public static final int TASK_PRIORITY_BACKGROUND = 2;
+
+    /**
+     * Enqueue a wrapped v8 function to be executed on the event loop with the specified priority
+     * Lower priority tasks are deferred while the loop is busy, but are promoted if they had to wait for too long
+     *
+     * @param function the function to execute
+     * @param priority one of the TASK_PRIORITY_* constants
+     */
+    public native void enqueueTask(JNIV8Function function, int priority);
+
+    public void enqueueTask(Runnable runnable, int priority) {
+        this.enqueueTask(JNIV8Function.Create(this, (Object receiver, Object[] arguments) -> {
+            runnable.run();
+            return JNIV8Undefined.GetInstance();
+        }), priority);
+    }
+
+    /**
+     * Run a runnable on the event loop while holding the locker
+     * Unlike enqueueTask this never waits for js that is currently running, so it can be used from any thread,
+     * e.g. network callbacks that have to create js objects. Runnables are run in the order they were posted,
+     * together with settlements from JNIV8Promise.Resolver.resolveAsync/rejectAsync.
+     * Exceptions thrown by the runnable are raised on the main thread like exceptions of async js code.
+     * Runnables posted before the engine has started run once the event loop is running.
+     *
+     * @param runnable the runnable to execute
+     * @throws IllegalStateException if the event loop has already ended
+     */
+    public native void post(@NonNull Runnable runnable);
+
     public interface V8EngineHandler {
         void onReady();
     }
@@ -135,6 +186,23 @@ public class V8Engine extends JNIObject {
         }
     }
 
+    /**
+     * Enables or disables tracking of v8 persistent handles and JNI global references created by the native code.
+     * Handles are counted per allocation site; if captureJSStack is set, the current JavaScript stack is recorded as well.
+     * Disabling tracking discards all recorded handles.
+     *
+     * @param enabled        whether handles should be tracked
+     * @param captureJSStack whether the JavaScript stack should be recorded for each allocation
+     */
+    public static native void setHandleTracking(boolean enabled, boolean captureJSStack);
+
+    /**
+     * Lists all allocation sites that currently hold tracked handles, sorted by number of live handles
+     *
+     * @return human readable dump; only contains handles created while tracking was enabled
+     */
+    public static native String dumpHandles();
+
     public native JNIV8GenericObject getGlobalObject();
 
     /**
@@ -92,8 +92,28 @@ class BGJSModuleFetch(val okHttpClient: OkHttpClient) : JNIV8Module("fetch") {
 
         call.enqueue(object : Callback {
 
+            // OkHttp calls back on its own threads; everything that creates or settles js objects is posted to the
+            // event loop, so that these threads never wait for js that is currently running
+
             override fun onFailure(call: Call, e: IOException) {
                 Log.d(TAG, "onFailure", e)
+                try {
+                    v8Engine.post { settleFailure(e) }
+                } catch (stopped: IllegalStateException) {
+                    // the engine was stopped while the request was running; there is nothing left to settle
+                }
+            }
+
+            override fun onResponse(call: Call, httpResponse: Response) {
+                timeout.clearTimeout()
+                try {
+                    v8Engine.post { settleResponse(call, httpResponse) }
+                } catch (stopped: IllegalStateException) {
+                    httpResponse.close()
+                }
+            }
+
+            private fun settleFailure(e: IOException) {
                 // network error or timeout
                 signal?.removeEventListener("abort", abortAndFinalize)
                 when {
@@ -135,8 +155,7 @@ class BGJSModuleFetch(val okHttpClient: OkHttpClient) : JNIV8Module("fetch") {
                 }
             }
 
-            override fun onResponse(call: Call, httpResponse: Response) {
-                timeout.clearTimeout()
+            private fun settleResponse(call: Call, httpResponse: Response) {
                 if (call.isCanceled()) {
                     signal?.removeEventListener("abort", abortAndFinalize)
                     return
@@ -7,12 +7,15 @@ import java.io.BufferedReader
 import java.io.InputStream
 import java.io.InputStreamReader
 import java.net.URL
+import java.nio.ByteBuffer
 
 
 abstract class BGJSModuleFetchBody @JvmOverloads constructor(v8Engine: V8Engine, jsPtr: Long = 0, args: Array<Any>? = null) : JNIV8Object(v8Engine, jsPtr, args) {
 
     var error: String? = null
     internal var body: InputStream? = null
+    /** length of the body if known in advance (e.g. from Content-Length), -1 otherwise */
+    internal var bodyLength = -1L
     private var bodyReader: BufferedReader? = null
     lateinit var parsedUrl: URL
     open var url = ""
@@ -26,10 +29,11 @@ abstract class BGJSModuleFetchBody @JvmOverloads constructor(v8Engine: V8Engine,
         val resolver = JNIV8Promise.CreateResolver(v8Engine)
 
         if (consumeBody(resolver)) {
-            if (bodyReader != null) {
-                //TODO: Use correct JNIV8BufferArray here when it is implemented
-                resolver.resolve(Create(v8Engine, "ArrayBuffer", 0))
-                bodyReader!!.close()
+            val input = body
+            if (input != null) {
+                // the body is read straight into direct memory, which the array buffer then uses as its backing store
+                val buffer = input.use { readDirect(it, bodyLength) }
+                resolver.resolve(JNIV8ArrayBuffer.CreateWithByteBuffer(v8Engine, buffer))
             } else {
                 resolver.reject(Create(v8Engine, "TypeError", "no body"))
             }
@@ -107,14 +111,39 @@ abstract class BGJSModuleFetchBody @JvmOverloads constructor(v8Engine: V8Engine,
     }
 
     companion object {
+        private const val DEFAULT_BODY_BUFFER_SIZE = 16 * 1024
+        private const val READ_CHUNK_SIZE = 8 * 1024
+
+        /**
+         * Reads a stream into a direct buffer
+         * If the length is known the buffer is allocated once with the exact size; otherwise it grows as needed.
+         * The returned buffer is a view that ends with the data, because the array buffer uses the whole capacity.
+         */
+        private fun readDirect(input: InputStream, length: Long): ByteBuffer {
+            var buffer = ByteBuffer.allocateDirect(if (length in 0L..Int.MAX_VALUE.toLong()) length.toInt() else maxOf(input.available(), DEFAULT_BODY_BUFFER_SIZE))
+            val chunk = ByteArray(READ_CHUNK_SIZE)
+            while (true) {
+                val read = input.read(chunk)
+                if (read < 0) break
+                if (buffer.remaining() < read) {
+                    val grown = ByteBuffer.allocateDirect(maxOf(buffer.capacity() * 2, buffer.position() + read))
+                    buffer.flip()
+                    grown.put(buffer)
+                    buffer = grown
+                }
+                buffer.put(chunk, 0, read)
+            }
+            buffer.flip()
+            return if (buffer.limit() == buffer.capacity()) buffer else buffer.slice()
+        }
+
         fun createBodyFromRaw(bodyRaw: Any?): InputStream? {
             return when (bodyRaw) {
                 is InputStream -> bodyRaw
                 //TODO: URLSearchParams are parsed from javascript as JNIV8GenericObject, how do we check isURLSearchParam? see https://github.com/bitinn/node-fetch/issues/296#issuecomment-307598143
                 is JNIV8GenericObject -> (bodyRaw as? JNIV8Object)?.toString()?.byteInputStream()
                 is BGJSModuleFormData -> bodyRaw.toInputStream()
-                //TODO: Check how JNIv8Arraybuffer will be handled
-                is JNIV8ArrayBuffer -> bodyRaw.toString().byteInputStream()
+                is JNIV8ArrayBuffer -> ArrayBufferInputStream(bodyRaw)
                 else -> (bodyRaw as? String)?.byteInputStream()
             }
         }
@@ -130,4 +159,24 @@ abstract class BGJSModuleFetchBody @JvmOverloads constructor(v8Engine: V8Engine,
             }
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Reads the memory of a js ArrayBuffer without copying it first
+ * The wrapper is referenced by the stream, so that the memory stays valid while the stream is in use
+ */
+private class ArrayBufferInputStream(private val arrayBuffer: JNIV8ArrayBuffer) : InputStream() {
+    private val buffer = arrayBuffer.v8ByteBuffer
+
+    override fun read(): Int = if (buffer.hasRemaining()) buffer.get().toInt() and 0xff else -1
+
+    override fun read(b: ByteArray, off: Int, len: Int): Int {
+        if (len == 0) return 0
+        if (!buffer.hasRemaining()) return -1
+        val count = minOf(len, buffer.remaining())
+        buffer.get(b, off, count)
+        return count
+    }
+
+    override fun available(): Int = buffer.remaining()
+}
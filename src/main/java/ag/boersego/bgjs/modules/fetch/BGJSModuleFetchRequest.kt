@@ -360,6 +360,7 @@ class BGJSModuleFetchRequest @JvmOverloads constructor(v8Engine: V8Engine, jsPtr
         response.status = httpResponse.code
         response.statusText = httpResponse.message
         response.body = httpResponse.body?.byteStream()
+        response.bodyLength = httpResponse.body?.contentLength() ?: -1L
         response.redirect = httpResponse.isRedirect
 
         return response
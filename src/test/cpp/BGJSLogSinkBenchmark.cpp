@@ -0,0 +1,108 @@
+#include "BGJSLogSink.h"
+#include "os-android.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Measures the time a console.log call spends handing its message to the log sink, as seen by the producing thread
+ *
+ * Each message is as long as a typical console line; the stack variants carry the 15 frames that console.trace collects,
+ * either as frames that the writer thread formats, or formatted into the message by the producer for comparison.
+ * The slow writer spins for a few microseconds per message like a logcat write does.
+ * Messages are logged in bursts that fit into the buffer together, followed by an untimed flush, so that nothing is dropped
+ * even if the writer thread only gets to run after a burst (e.g. on a single core).
+ */
+static std::atomic<uint64_t> written(0);
+
+static void noopWriter(int level, int64_t timestamp, const char *message, void *data) {
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void slowWriter(int level, int64_t timestamp, const char *message, void *data) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(5);
+    while (std::chrono::steady_clock::now() < end) {}
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+static std::vector<BGJSLogSink::Frame> makeStack() {
+    std::vector<BGJSLogSink::Frame> stack(15);
+    for (size_t i = 0; i < stack.size(); i++) {
+        stack[i].script = "assets/js/application.js";
+        stack[i].function = "handler" + std::to_string(i);
+        stack[i].line = (int)(i * 17);
+    }
+    return stack;
+}
+
+enum class Stack { None, Deferred, Formatted };
+
+static std::string formatStack(std::string message, const std::vector<BGJSLogSink::Frame> &stack) {
+    for (auto &frame : stack) {
+        message += "\n    " + frame.script + " (" + frame.function + ":" + std::to_string(frame.line) + ")";
+    }
+    return message;
+}
+
+static void measure(const char *name, BGJSLogSink::Writer writer, int threads, Stack mode) {
+    BGJSLogSink *sink = BGJSLogSink::getInstance();
+    sink->setWriter(writer, nullptr);
+
+    const int perThread = 200000 / threads;
+    const int burst = 200;
+    const std::string message = " 'request finished' 200 'https://example.com/api/v1/quotes' 42";
+    const std::vector<BGJSLogSink::Frame> stack = makeStack();
+    uint64_t droppedBefore = sink->getDroppedCount();
+    written.store(0);
+
+    std::vector<double> nsPerLog(threads);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.emplace_back([&, t] {
+            double total = 0;
+            for (int i = 1; i <= perThread; i++) {
+                // collecting the frames is part of what a caller pays for in both stack variants
+                auto start = std::chrono::steady_clock::now();
+                std::string copy = message;
+                std::vector<BGJSLogSink::Frame> frames;
+                if (mode != Stack::None) frames = stack;
+                if (mode == Stack::Formatted) {
+                    sink->log(LOG_INFO, formatStack(std::move(copy), frames));
+                } else {
+                    sink->log(LOG_INFO, std::move(copy), std::move(frames));
+                }
+                total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                if (i % burst == 0) sink->flush();
+            }
+            nsPerLog[t] = total / perThread;
+        });
+    }
+    for (auto &thread : producers) thread.join();
+    sink->flush();
+
+    double average = 0;
+    for (double ns : nsPerLog) average += ns / threads;
+    printf("%-40s %8.1f ns/log  (%llu written, %llu dropped)\n", name, average,
+           (unsigned long long)written.load(), (unsigned long long)(sink->getDroppedCount() - droppedBefore));
+}
+
+int main() {
+    // warm up the writer thread and the slot strings
+    measure("warmup", &noopWriter, 1, Stack::None);
+
+    measure("no-op writer, 1 thread", &noopWriter, 1, Stack::None);
+    measure("no-op writer, 4 threads", &noopWriter, 4, Stack::None);
+    measure("no-op writer, 15 frames deferred", &noopWriter, 1, Stack::Deferred);
+    measure("no-op writer, 15 frames formatted", &noopWriter, 1, Stack::Formatted);
+    measure("slow writer, 1 thread", &slowWriter, 1, Stack::None);
+    measure("slow writer, 4 threads", &slowWriter, 4, Stack::None);
+    measure("slow writer, 15 frames deferred", &slowWriter, 1, Stack::Deferred);
+    measure("slow writer, 15 frames formatted", &slowWriter, 1, Stack::Formatted);
+
+    BGJSLogSink::getInstance()->setWriter(nullptr, nullptr);
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include "BGJSLogSink.h"
+#include "os-android.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define EXPECT(cond, name) do { if (!(cond)) { fprintf(stderr, "FAILED: %s (%s:%d)\n", name, __FILE__, __LINE__); failures++; } } while(0)
+
+/**
+ * records all messages; can be blocked to simulate a slow logcat
+ */
+struct RecordingWriter {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<std::string> messages;
+    std::vector<int> levels;
+    bool blocked = false, writing = false;
+
+    static void write(int level, int64_t timestamp, const char *message, void *data) {
+        auto self = reinterpret_cast<RecordingWriter*>(data);
+        std::unique_lock<std::mutex> lock(self->mutex);
+        self->writing = true;
+        self->cond.notify_all();
+        self->cond.wait(lock, [self] { return !self->blocked; });
+        self->writing = false;
+        self->messages.push_back(message);
+        self->levels.push_back(level);
+    }
+
+    void block() {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocked = true;
+    }
+
+    void unblock() {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocked = false;
+        cond.notify_all();
+    }
+
+    bool waitUntilWriting() {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cond.wait_for(lock, std::chrono::seconds(5), [this] { return writing; });
+    }
+};
+
+static void testOrderAndFlush() {
+    BGJSLogSink *sink = BGJSLogSink::getInstance();
+    RecordingWriter writer;
+    sink->setWriter(&RecordingWriter::write, &writer);
+
+    for (int i = 0; i < 500; i++) {
+        sink->log(i % 2 ? LOG_INFO : LOG_DEBUG, std::to_string(i));
+    }
+    sink->flush();
+
+    EXPECT(writer.messages.size() == 500, "all messages are written before flush returns");
+    bool ordered = true;
+    for (size_t i = 0; i < writer.messages.size(); i++) {
+        ordered = ordered && writer.messages[i] == std::to_string(i) && writer.levels[i] == (i % 2 ? LOG_INFO : LOG_DEBUG);
+    }
+    EXPECT(ordered, "messages are written in order with their level");
+
+    sink->setWriter(nullptr, nullptr);
+}
+
+static void testStackFormatting() {
+    BGJSLogSink *sink = BGJSLogSink::getInstance();
+    RecordingWriter writer;
+    sink->setWriter(&RecordingWriter::write, &writer);
+
+    std::vector<BGJSLogSink::Frame> stack(2);
+    stack[0].script = "main.js";
+    stack[0].function = "run";
+    stack[0].line = 12;
+    stack[1].script = "lib.js";
+    stack[1].function = "";
+    stack[1].line = 3;
+    sink->log(LOG_ERROR, "Assertion failed", std::move(stack));
+    // a plain message stored in the same kind of slot afterwards must not pick up the frames
+    sink->log(LOG_INFO, "plain");
+    sink->flush();
+
+    EXPECT(writer.messages.size() == 2, "messages with stack are written");
+    if (writer.messages.size() == 2) {
+        EXPECT(writer.messages[0] == "Assertion failed\n    main.js (run:12)\n    lib.js (:3)", "frames are appended by the writer");
+        EXPECT(writer.messages[1] == "plain", "plain message has no frames");
+    }
+
+    sink->setWriter(nullptr, nullptr);
+}
+
+static void testProducersDoNotWaitForWrites() {
+    BGJSLogSink *sink = BGJSLogSink::getInstance();
+    RecordingWriter writer;
+    sink->setWriter(&RecordingWriter::write, &writer);
+
+    uint64_t droppedBefore = sink->getDroppedCount();
+    writer.block();
+    sink->log(LOG_INFO, "first");
+    EXPECT(writer.waitUntilWriting(), "writer picks up the first message");
+
+    // the writer thread is stuck in a write; none of these may wait for it
+    auto start = std::chrono::steady_clock::now();
+    const int total = 2000;
+    int accepted = 0;
+    for (int i = 0; i < total; i++) {
+        if (sink->log(LOG_INFO, "message")) accepted++;
+    }
+    sink->setWriter(&RecordingWriter::write, &writer);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT(elapsed < 1.0, "log and setWriter return while the writer is busy");
+
+    uint64_t dropped = sink->getDroppedCount() - droppedBefore;
+    EXPECT(accepted < total, "messages are dropped once the buffer is full");
+    EXPECT(dropped == (uint64_t)(total - accepted), "dropped messages are counted");
+
+    writer.unblock();
+    sink->flush();
+
+    // the blocked message, everything that was accepted, and the overflow report
+    EXPECT(writer.messages.size() == (size_t)accepted + 2, "accepted messages and the overflow report are written");
+    if (!writer.messages.empty()) {
+        EXPECT(writer.messages.back() == "console buffer overflow: " + std::to_string(dropped) + " message(s) dropped",
+               "overflow is reported with the number of dropped messages");
+        EXPECT(writer.levels.back() == LOG_ERROR, "overflow is reported as error");
+    }
+
+    sink->setWriter(nullptr, nullptr);
+}
+
+static void testConcurrentProducers() {
+    BGJSLogSink *sink = BGJSLogSink::getInstance();
+    RecordingWriter writer;
+    sink->setWriter(&RecordingWriter::write, &writer);
+
+    const int threads = 4, perThread = 200;
+    uint64_t droppedBefore = sink->getDroppedCount();
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.emplace_back([sink, t] {
+            for (int i = 0; i < perThread; i++) {
+                sink->log(LOG_INFO, std::to_string(t) + ":" + std::to_string(i));
+                if (i % 50 == 0) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &thread : producers) thread.join();
+    sink->flush();
+
+    size_t expected = threads * perThread - (sink->getDroppedCount() - droppedBefore);
+    size_t written = 0;
+    std::vector<int> next(threads, -1);
+    bool ordered = true;
+    for (auto &message : writer.messages) {
+        size_t colon = message.find(':');
+        if (colon == std::string::npos) continue;
+        int t = std::stoi(message.substr(0, colon)), i = std::stoi(message.substr(colon + 1));
+        ordered = ordered && i > next[t];
+        next[t] = i;
+        written++;
+    }
+    EXPECT(written == expected, "every accepted message is written once");
+    EXPECT(ordered, "messages of one thread keep their order");
+
+    sink->setWriter(nullptr, nullptr);
+}
+
+int main() {
+    testOrderAndFlush();
+    testStackFormatting();
+    testProducersDoNotWaitForWrites();
+    testConcurrentProducers();
+
+    if (failures) {
+        fprintf(stderr, "%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "JNIUTF.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/**
+ * reference implementation without the vectorized ascii runs
+ */
+static size_t scalarUtf16ToUtf8(const uint16_t *src, size_t length, char *dst) {
+    size_t o = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint32_t c = src[i];
+        if (c < 0x80) {
+            dst[o++] = (char)c;
+        } else if (c < 0x800) {
+            dst[o++] = (char)(0xC0 | (c >> 6));
+            dst[o++] = (char)(0x80 | (c & 0x3F));
+        } else {
+            dst[o++] = (char)(0xE0 | (c >> 12));
+            dst[o++] = (char)(0x80 | ((c >> 6) & 0x3F));
+            dst[o++] = (char)(0x80 | (c & 0x3F));
+        }
+    }
+    return o;
+}
+
+template <typename F>
+static double measure(const char *name, size_t bytes, F fn) {
+    const int iterations = 2000;
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink += fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double mbs = (double)bytes * iterations / seconds / (1024 * 1024);
+    printf("%-32s %10.1f MB/s (%zu)\n", name, mbs, sink / iterations);
+    return mbs;
+}
+
+int main() {
+    // mostly ascii has an umlaut every 16 characters, latin-1 every other character (0xC0-0xFF, two bytes each),
+    // cjk is made of unified ideographs only (three bytes each), so it never hits the ascii runs
+    std::u16string ascii, mixed, latin1, cjk;
+    for (int i = 0; i < 64 * 1024; i++) {
+        ascii.push_back((char16_t)('a' + i % 26));
+        mixed.push_back(i % 16 == 0 ? u'ä' : (char16_t)('a' + i % 26));
+        latin1.push_back(i % 2 ? (char16_t)(0xC0 + i % 64) : (char16_t)('a' + i % 26));
+        cjk.push_back((char16_t)(0x4E00 + i % 2048));
+    }
+    std::string out(ascii.length() * 3, '\0');
+    std::u16string back(out.length(), u'\0');
+
+    struct { const char *name; const std::u16string *text; } inputs[] = {{"ascii", &ascii}, {"mostly ascii", &mixed},
+                                                                     {"latin-1", &latin1}, {"cjk", &cjk}};
+    for (auto &input : inputs) {
+        const uint16_t *src = (const uint16_t*)input.text->data();
+        size_t length = input.text->length();
+        printf("%s, %zu code units\n", input.name, length);
+        measure("  utf16ToUtf8 (scalar reference)", length * 2, [&] { return scalarUtf16ToUtf8(src, length, &out[0]); });
+        measure("  utf16ToUtf8", length * 2, [&] { return JNIUTF::utf16ToUtf8(src, length, &out[0]); });
+        measure("  utf16ToUtf8Length", length * 2, [&] { return JNIUTF::utf16ToUtf8Length(src, length); });
+        size_t encoded = JNIUTF::utf16ToUtf8(src, length, &out[0]);
+        measure("  utf8ToUtf16", encoded, [&] { return JNIUTF::utf8ToUtf16(out.data(), encoded, (uint16_t*)&back[0]); });
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "JNIUTF.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define EXPECT(cond, name) do { if (!(cond)) { fprintf(stderr, "FAILED: %s (%s:%d)\n", name, __FILE__, __LINE__); failures++; } } while(0)
+
+static std::string toUtf8(const std::u16string &src) {
+    std::string dst(src.length() * 3, '\0');
+    size_t written = JNIUTF::utf16ToUtf8((const uint16_t*)src.data(), src.length(), &dst[0]);
+    EXPECT(written == JNIUTF::utf16ToUtf8Length((const uint16_t*)src.data(), src.length()), "utf16ToUtf8Length matches written bytes");
+    dst.resize(written);
+    return dst;
+}
+
+static std::u16string toUtf16(const std::string &src) {
+    std::u16string dst(src.length(), u'\0');
+    size_t written = JNIUTF::utf8ToUtf16(src.data(), src.length(), (uint16_t*)&dst[0]);
+    dst.resize(written);
+    return dst;
+}
+
+static void testRoundTrip(const std::u16string &text, const char *name) {
+    EXPECT(toUtf16(toUtf8(text)) == text, name);
+}
+
+int main() {
+    // valid input survives a round trip; lengths around 8/16 exercise the vectorized ascii runs and their tails
+    testRoundTrip(u"", "empty");
+    testRoundTrip(u"a", "single ascii");
+    testRoundTrip(u"0123456", "ascii shorter than a vector");
+    testRoundTrip(u"0123456789abcdef0", "ascii longer than a vector");
+    testRoundTrip(u"ascii run followed by umlauts äöü and more ascii", "mixed two byte");
+    testRoundTrip(u"€中文￿", "three byte");
+    testRoundTrip(u"emoji \U0001F600 in the middle of an ascii run", "surrogate pair");
+    testRoundTrip(u"\U00010000\U0010FFFF", "first and last supplementary code point");
+    // non-ascii text stays scalar until two ascii characters in a row hand back to the vectorized runs
+    testRoundTrip(u"äaöbüc中d文e€f", "alternating ascii and non-ascii");
+    testRoundTrip(u"中文ab0123456789abcdef中文a", "ascii run after non-ascii text");
+
+    std::u16string all;
+    for (uint32_t c = 1; c < 0x10000; c++) {
+        if (c >= 0xD800 && c <= 0xDFFF) continue;
+        all.push_back((char16_t)c);
+    }
+    testRoundTrip(all, "all bmp code points");
+
+    // encoding
+    EXPECT(toUtf8(u"ä") == "\xC3\xA4", "two byte encoding");
+    EXPECT(toUtf8(u"€") == "\xE2\x82\xAC", "three byte encoding");
+    EXPECT(toUtf8(u"\U0001F600") == "\xF0\x9F\x98\x80", "four byte encoding");
+
+    // unpaired surrogates are encoded as '?' like the java UTF-8 charset does it
+    EXPECT(toUtf8(std::u16string(1, (char16_t)0xD800)) == "?", "lone high surrogate");
+    EXPECT(toUtf8(std::u16string(1, (char16_t)0xDC00)) == "?", "lone low surrogate");
+    std::u16string reversed;
+    reversed.push_back((char16_t)0xDC00);
+    reversed.push_back((char16_t)0xD800);
+    reversed += u"x";
+    EXPECT(toUtf8(reversed) == "??x", "reversed surrogate pair");
+    std::u16string truncated = u"abc";
+    truncated.push_back((char16_t)0xD83D);
+    EXPECT(toUtf8(truncated) == "abc?", "high surrogate at the end");
+
+    // malformed UTF-8 decodes to U+FFFD per maximal invalid subsequence
+    EXPECT(toUtf16("\x80") == u"�", "continuation byte without lead byte");
+    EXPECT(toUtf16("\xC0\xAF") == u"��", "overlong two byte sequence");
+    EXPECT(toUtf16("\xE0\x80\xAF") == u"���", "overlong three byte sequence");
+    EXPECT(toUtf16("\xED\xA0\x80") == u"���", "encoded surrogate");
+    EXPECT(toUtf16("\xE2\x82") == u"�", "truncated three byte sequence");
+    EXPECT(toUtf16("\xF0\x9F\x98") == u"�", "truncated four byte sequence");
+    EXPECT(toUtf16("\xF4\x90\x80\x80") == u"����", "code point above U+10FFFF");
+    EXPECT(toUtf16("a\xFF" "b") == u"a�b", "invalid lead byte");
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+#include "JNIV8ClassInfoTable.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Measures class info lookups of several engines running on their own threads at the same time
+ *
+ * The first variant reproduces the lookup JNIV8Wrapper did before the table existed: take the global mutex,
+ * find the container by canonical name in a std::map and scan its class infos for the engine.
+ * The second one is the lookup that wrapObject and getJSConstructor do now: two acquire loads in the table of the engine.
+ * Each thread looks up the classes of a typical app in turn; the total throughput of all threads is reported.
+ */
+class JNIV8ClassInfo {
+public:
+    const void *engine;
+};
+
+static const int kClassCount = 40;
+
+struct Container {
+    std::vector<JNIV8ClassInfo*> classInfos;
+};
+
+template <typename F>
+static void measure(const char *name, int threads, F fn) {
+    const int iterations = 2000000;
+    std::atomic<uintptr_t> sink(0);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            uintptr_t local = 0;
+            for (int i = 0; i < iterations; i++) {
+                local += fn(t, i % kClassCount);
+            }
+            sink += local;
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("  %-28s %8.2f ns/lookup per thread %10.1f M lookups/s total (%zu)\n", name,
+           seconds * 1e9 / iterations, (double)threads * iterations / seconds / 1e6, (size_t)(sink.load() & 0xff));
+}
+
+int main() {
+    const int maxThreads = 8;
+
+    // one engine per thread; every engine has a class info for every class
+    std::vector<JNIV8ClassInfo> infos((size_t)maxThreads * kClassCount);
+    std::vector<JNIV8ClassInfoTable> tables(maxThreads);
+    std::map<std::string, Container> containers;
+    std::vector<std::string> names;
+    for (int c = 0; c < kClassCount; c++) {
+        names.push_back("ag/boersego/bgjs/generated/V8Class" + std::to_string(c));
+    }
+    for (int t = 0; t < maxThreads; t++) {
+        for (int c = 0; c < kClassCount; c++) {
+            JNIV8ClassInfo *info = &infos[t * kClassCount + c];
+            info->engine = &tables[t];
+            containers[names[c]].classInfos.push_back(info);
+            tables[t].set((size_t)c, info);
+        }
+    }
+    std::mutex mutex;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        printf("%d engine(s) on their own thread\n", threads);
+        measure("mutex + map + scan", threads, [&](int t, int c) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = containers.find(names[c]);
+            for (auto info : it->second.classInfos) {
+                if (info->engine == &tables[t]) {
+                    return (uintptr_t)info;
+                }
+            }
+            return (uintptr_t)0;
+        });
+        measure("table", threads, [&](int t, int c) {
+            return (uintptr_t)tables[t].get((size_t)c);
+        });
+    }
+
+    for (auto &table : tables) {
+        table.clear();
+    }
+    return 0;
+}
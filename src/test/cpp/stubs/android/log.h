@@ -0,0 +1,17 @@
+#ifndef __TEST_STUBS_ANDROID_LOG_H
+#define __TEST_STUBS_ANDROID_LOG_H 1
+
+#include <cstdio>
+
+/**
+ * minimal replacement of the ndk logging header for host side tests; messages go to stderr
+ */
+enum {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_ERROR = 6
+};
+
+#define __android_log_print(prio, tag, ...) (fprintf(stderr, "%d %s: ", (int)(prio), (tag)), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef __TEST_STUBS_JNI_H
+#define __TEST_STUBS_JNI_H 1
+
+/**
+ * opaque jni types for host side tests and benchmarks
+ * only code that stores these types is built against this header; nothing may call into a jvm
+ */
+class _jobject {};
+class _jclass : public _jobject {};
+typedef _jobject *jobject;
+typedef _jclass *jclass;
+
+struct _jmethodID;
+struct _jfieldID;
+typedef struct _jmethodID *jmethodID;
+typedef struct _jfieldID *jfieldID;
+
+typedef struct {
+    const char *name;
+    const char *signature;
+    void *fnPtr;
+} JNINativeMethod;
+
+#endif